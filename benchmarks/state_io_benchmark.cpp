@@ -0,0 +1,323 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "state_io.h"
+#include "state_binary.h"
+#include "state_operations.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+/******************************************************************************
+ *    Save file benchmark: builds a big random dialogue and times the
+ *    DOM-based save and load the editor used to have (version 1 files)
+ *    against state_io (version 2 files, reading version 1 too). Also
+ *    checks that deleting nodes and links keeps the connections right.
+ *
+ *    usage: state_io_benchmark [node_count]   (defaults to 100000)
+ ******************************************************************************/
+
+namespace
+{
+	using json = nlohmann::json;
+	using Clock = std::chrono::steady_clock;
+
+	double MillisecondsSince(Clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// chains speech nodes, every third one branching into two responses that both lead to the next speech
+	State MakeState(int node_count) {
+		std::mt19937 rng(1234);
+		std::uniform_real_distribution<float> coord(-20000.0f, 20000.0f);
+
+		State state;
+		state.callbacks = { "npc_smile", "trigger_fight", "give_item" };
+		state.nodes.reserve(node_count);
+
+		for (int id = 0; id < node_count; id++) {
+			NodeType type = (id % 3 == 1 || id % 3 == 2) && id > 2 ? NodeType::Response : NodeType::Speech;
+			std::string text = "Line " + std::to_string(id) + ": \"Well, well...\"\n\tsaid the guard.";
+			state.nodes[id] = std::make_shared<Node>(id, type, text, ImVec2(coord(rng), coord(rng)));
+		}
+
+		std::vector<ede::Connection> connections;
+		auto connect = [&](int from, int to) {
+			if (to < node_count) {
+				connections.push_back({ static_cast<int>(connections.size()), from, to });
+			}
+		};
+		for (int id = 0; id + 1 < node_count; id++) {
+			std::shared_ptr<Node> node = state.nodes[id];
+			if (node->nodeType == NodeType::Response) {
+				connect(id, id + (id % 3 == 1 ? 2 : 1));
+			}
+			else if (id % 3 == 0 && id > 2 && id + 2 < node_count) {
+				node->expectesResponse = true;
+				node->selected_callbacks.insert("npc_smile");
+				connect(id, id + 1);
+				connect(id, id + 2);
+			}
+			else {
+				connect(id, id + 1);
+			}
+		}
+		// fills nextNodeId, responses, prevNodeIds and the links' pins the way loading does
+		ede::RebuildConnections(state, connections);
+		state.next_node_id = node_count;
+		state.next_link_id = static_cast<int>(connections.size());
+		return state;
+	}
+
+	// the serializer FileDialogs::SaveStateJson had before state_io, which wrote version 1 files
+	std::string DumpWithDom(const State& state) {
+		json nodes;
+		for (const auto& pair : state.nodes) {
+			std::shared_ptr<Node> node = pair.second;
+			if (node) {
+				nodes.push_back({
+					{"nodeId", node->id},
+					{"nodeType", static_cast<int>(node->nodeType)},
+					{"text", node->text},
+					{"position", {{"x", node->position.x}, {"y", node->position.y}}},
+					{"nextNodeId", node->nextNodeId},
+					{"prevNodeIds", node->prevNodeIds},
+					{"responses", node->responses},
+					{"expectsResponse", node->expectesResponse},
+					{"selected_callbacks", node->selected_callbacks}
+					});
+			}
+		}
+
+		json links;
+		for (const auto& pair : state.links) {
+			std::shared_ptr<Link> link = pair.second;
+			if (link) {
+				links.push_back(*link);
+			}
+		}
+
+		json j = json{
+			{"nodes", nodes},
+			{"links", links},
+			{"next_node_id", state.next_node_id},
+			{"next_link_id", state.next_link_id},
+			{"callbacks", state.callbacks},
+		};
+		return j.dump(4);
+	}
+
+	// the loader FileDialogs::LoadStateJson had before state_io
+	State LoadWithDom(const std::string& path) {
+		json j;
+		std::ifstream in(path);
+		in >> j;
+
+		State new_state;
+		std::vector<json> nodes_json = j.at("nodes").get<std::vector<json>>();
+		for (const json& jn : nodes_json) {
+			int nodeId = jn.at("nodeId").get<int>();
+			NodeType nodeType = static_cast<NodeType>(jn.at("nodeType").get<int>());
+			std::string text = jn.at("text").get<std::string>();
+			ImVec2 position(jn.at("position").at("x").get<float>(), jn.at("position").at("y").get<float>());
+			int nextNodeId = jn.at("nextNodeId").get<int>();
+			std::vector<int> prevNodeIds = jn.at("prevNodeIds").get<std::vector<int>>();
+			std::vector<int> responses = jn.at("responses").get<std::vector<int>>();
+			bool expectsResponse = jn.at("expectsResponse").get<bool>();
+			std::set<std::string> selected_callbacks;
+			for (auto& callback : jn.at("selected_callbacks").get<std::vector<std::string>>()) {
+				selected_callbacks.insert(callback);
+			}
+			new_state.nodes[nodeId] = std::make_shared<Node>(nodeId, nodeType, text, position, nextNodeId, prevNodeIds,
+				responses, expectsResponse, selected_callbacks);
+		}
+		std::vector<json> links_json = j.at("links").get<std::vector<json>>();
+		for (const json& jl : links_json) {
+			int id = jl.at("id").get<int>();
+			new_state.links[id] = std::make_shared<Link>(id, jl.at("start_attr").get<int>(), jl.at("end_attr").get<int>());
+		}
+		new_state.next_node_id = j.at("next_node_id").get<int>();
+		new_state.next_link_id = j.at("next_link_id").get<int>();
+		new_state.callbacks = j.at("callbacks").get<std::set<std::string>>();
+
+		// SetState(const State&) copied it once more
+		State editor_state = new_state;
+		return editor_state;
+	}
+
+	bool SameState(const State& a, const State& b) {
+		if (a.nodes.size() != b.nodes.size() || a.links.size() != b.links.size() || a.callbacks != b.callbacks ||
+			a.next_node_id != b.next_node_id || a.next_link_id != b.next_link_id) {
+			return false;
+		}
+		for (const auto& [id, node] : a.nodes) {
+			std::shared_ptr<Node> other = b.FindNode(id);
+			if (!other || node->nodeType != other->nodeType || node->TextView() != other->TextView() ||
+				node->position.x != other->position.x || node->position.y != other->position.y ||
+				node->nextNodeId != other->nextNodeId || node->prevNodeIds != other->prevNodeIds ||
+				node->responses != other->responses || node->expectesResponse != other->expectesResponse ||
+				node->selected_callbacks != other->selected_callbacks) {
+				return false;
+			}
+		}
+		for (const auto& [id, link] : a.links) {
+			std::shared_ptr<Link> other = b.FindLink(id);
+			if (!other || link->start_attr != other->start_attr || link->end_attr != other->end_attr) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Deletes a node and a link past id 127, whose output pins overflow, from a copy of the state.
+	// What's left has to be what loading it would rebuild out of its links: no link to the deleted
+	// node, and no next, response or previous id the deleted link leaves behind
+	bool RemovalKeepsConnections(const State& state) {
+		const int node_id = 200;
+		const int link_start = 300;
+		if (!state.nodes.contains(node_id) || !state.nodes.contains(link_start + 1)) {
+			return true;
+		}
+		State removed = state;
+		for (auto& [id, node] : removed.nodes) {
+			node = std::make_shared<Node>(*node);
+		}
+		for (auto& [id, link] : removed.links) {
+			link = std::make_shared<Link>(*link);
+		}
+
+		std::vector<int> link_ids;
+		for (const ede::Connection& connection : ede::ResolveConnections(state)) {
+			if (connection.from == link_start) {
+				link_ids.push_back(connection.link_id);
+			}
+		}
+		ede::RemoveNodesAndLinks(removed, { node_id }, link_ids);
+
+		State rebuilt = removed;
+		for (auto& [id, node] : rebuilt.nodes) {
+			node = std::make_shared<Node>(*node);
+		}
+		ede::RebuildConnections(rebuilt, ede::ResolveConnections(rebuilt));
+		return !link_ids.empty() && !removed.nodes.contains(node_id) && SameState(removed, rebuilt);
+	}
+
+	std::string ReadWholeFile(const std::string& path) {
+		std::ifstream file(path, std::ios::binary);
+		std::stringstream ss;
+		ss << file.rdbuf();
+		return ss.str();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int node_count = argc > 1 ? std::atoi(argv[1]) : 100000;
+	State state = MakeState(node_count);
+	std::cout << "nodes: " << state.nodes.size() << ", links: " << state.links.size() << "\n";
+
+	const std::string dom_path = "state_io_benchmark_dom.json";
+	const std::string stream_path = "state_io_benchmark_stream.json";
+
+	// save
+	Clock::time_point start = Clock::now();
+	{
+		std::ofstream out(dom_path);
+		out << DumpWithDom(state);
+	}
+	double dom_save_ms = MillisecondsSince(start);
+
+	start = Clock::now();
+	if (!ede::WriteStateJson(state, stream_path)) {
+		std::cerr << "WriteStateJson failed\n";
+		return 1;
+	}
+	double stream_save_ms = MillisecondsSince(start);
+
+	std::cout << "save, DOM + dump(4):  " << dom_save_ms << " ms, " << ReadWholeFile(dom_path).size() << " bytes (version 1)\n";
+	std::cout << "save, WriteStateJson: " << stream_save_ms << " ms, " << ReadWholeFile(stream_path).size() << " bytes\n";
+
+	// load
+	start = Clock::now();
+	State dom_loaded = LoadWithDom(dom_path);
+	double dom_load_ms = MillisecondsSince(start);
+
+	start = Clock::now();
+	State stream_loaded;
+	std::string error;
+	if (!ede::ReadStateJson(stream_path, stream_loaded, &error)) {
+		std::cerr << "ReadStateJson failed: " << error << "\n";
+		return 1;
+	}
+	double stream_load_ms = MillisecondsSince(start);
+
+	start = Clock::now();
+	State version1_loaded;
+	if (!ede::ReadStateJson(dom_path, version1_loaded, &error)) {
+		std::cerr << "ReadStateJson (version 1) failed: " << error << "\n";
+		return 1;
+	}
+	double version1_load_ms = MillisecondsSince(start);
+
+	bool round_trips = SameState(state, stream_loaded) && SameState(state, dom_loaded) && SameState(state, version1_loaded);
+
+	std::cout << "load, DOM:            " << dom_load_ms << " ms\n";
+	std::cout << "load, ReadStateJson:  " << stream_load_ms << " ms\n";
+	std::cout << "load, version 1 file: " << version1_load_ms << " ms\n";
+
+	// binary format
+	const std::string binary_path = "state_io_benchmark.edeb";
+	start = Clock::now();
+	if (!ede::WriteStateBinary(state, binary_path)) {
+		std::cerr << "WriteStateBinary failed\n";
+		return 1;
+	}
+	double binary_save_ms = MillisecondsSince(start);
+
+	start = Clock::now();
+	ede::BinaryStateView view;
+	if (!view.Open(binary_path, &error)) {
+		std::cerr << "BinaryStateView::Open failed: " << error << "\n";
+		return 1;
+	}
+	double binary_open_ms = MillisecondsSince(start);
+
+	start = Clock::now();
+	State binary_loaded = view.ToState();
+	double binary_load_ms = MillisecondsSince(start);
+	view.Close();
+	round_trips = round_trips && SameState(state, binary_loaded);
+
+	start = Clock::now();
+	State lazy_loaded;
+	if (!ede::ReadStateBinary(binary_path, lazy_loaded, &error, ede::TextLoading::Lazy)) {
+		std::cerr << "ReadStateBinary (lazy) failed: " << error << "\n";
+		return 1;
+	}
+	double lazy_load_ms = MillisecondsSince(start);
+	round_trips = round_trips && SameState(state, lazy_loaded);
+	lazy_loaded = {}; // the mapping goes with the last state using it
+
+	std::cout << "save, binary:         " << binary_save_ms << " ms\n";
+	std::cout << "open, binary view:    " << binary_open_ms << " ms\n";
+	std::cout << "load, binary:         " << binary_load_ms << " ms\n";
+	std::cout << "load, lazy text:      " << lazy_load_ms << " ms (open included)\n";
+	std::cout << "round trips:          " << (round_trips ? "yes" : "NO") << "\n";
+
+	const bool removal_ok = RemovalKeepsConnections(state);
+	std::cout << "removal past id 127:  " << (removal_ok ? "ok" : "BROKEN") << "\n";
+
+	std::remove(dom_path.c_str());
+	std::remove(stream_path.c_str());
+	std::remove(binary_path.c_str());
+	return round_trips && removal_ok ? 0 : 1;
+}
@@ -0,0 +1,510 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "Node.h"
+#include "state_io.h"
+#include "state_binary.h"
+#include "state_validation.h"
+#include "path_analysis.h"
+#include "graph_layout.h"
+#include "graph_stats.h"
+#include "dialogue_export.h"
+#include "background_save.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/******************************************************************************
+ *     ede-cli - loads, validates, converts and exports states without a window
+ *
+ *   Every input file is independent, so they're spread over worker threads.
+ *   Each file's report is buffered and printed in input order once all are
+ *   done, the output is the same whatever the number of threads.
+ ******************************************************************************/
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	enum class ConvertFormat { None, Json, Binary };
+
+	struct Options
+	{
+		bool                             validate = false;
+		bool                             stats = false;
+		bool                             stats_json = false;
+		bool                             warnings_as_errors = false;
+		bool                             quiet = false;
+		bool                             layout = false;
+		std::vector<ede::ExportEncoding> exports;
+		ConvertFormat                    convert = ConvertFormat::None;
+		std::string                      out_dir; // empty: next to each input
+		unsigned                         jobs = 0; // 0: one per core
+		std::vector<std::string>         inputs;
+		std::set<std::string>            input_files; // weakly canonical, no output may replace one
+	};
+
+	struct EncodingArg
+	{
+		const char*       name;
+		ede::ExportEncoding encoding;
+		const char*       extension;
+	};
+
+	// The JSON exports get their own extensions, so exporting both flavors doesn't write one file twice,
+	// and neither lands on the state it was exported from
+	const EncodingArg EncodingArgs[] = {
+		{ "json",     ede::ExportEncoding::PrettyJson,   ".export.json" },
+		{ "json-min", ede::ExportEncoding::MinifiedJson, ".min.json" },
+		{ "cbor",     ede::ExportEncoding::Cbor,         ".cbor" },
+		{ "msgpack",  ede::ExportEncoding::MessagePack,  ".msgpack" },
+		{ "ubjson",   ede::ExportEncoding::Ubjson,       ".ubj" },
+		{ "compiled", ede::ExportEncoding::Compiled,     ".edec" },
+	};
+	static_assert(std::size(EncodingArgs) == static_cast<size_t>(ede::ExportEncoding::Count), "keep the CLI encodings in sync with ExportEncoding");
+
+	constexpr const char* StatsExtension = ".stats.json";
+
+	const EncodingArg* FindEncodingArg(ede::ExportEncoding encoding) {
+		for (const EncodingArg& arg : EncodingArgs) {
+			if (arg.encoding == encoding) {
+				return &arg;
+			}
+		}
+		return nullptr;
+	}
+
+	void PrintUsage() {
+		std::cout <<
+			"usage: ede-cli [options] <state files or directories...>\n"
+			"\n"
+			"Directories are searched recursively for .json and .edeb state files,\n"
+			"skipping the exports and statistics this tool writes.\n"
+			"\n"
+			"options:\n"
+			"  --validate             check every state for broken ids and connections\n"
+			"  --werror               count validation warnings as errors\n"
+			"  --stats                print node, link and callback counts, loops and playthroughs\n"
+			"  --stats-json           write the statistics to <name>.stats.json\n"
+			"  --layout               arrange the nodes in layers from node 0, saved by --convert\n"
+			"  --export <encoding>    export the dialogue to <name>.<extension>, may be repeated:\n"
+			"                         json (.export.json), json-min (.min.json), cbor, msgpack,\n"
+			"                         ubjson (.ubj), compiled (.edec)\n"
+			"  --convert <format>     re-save the state as json or binary (.edeb)\n"
+			"  --out <dir>            where outputs go, next to each input by default\n"
+			"  --jobs <n>             worker threads, one per core by default\n"
+			"  --quiet                only print problems\n"
+			"\n"
+			"Outputs never replace an input, a file whose output would is counted as failed.\n"
+			"Inputs that would write the same output (x.json and x.edeb, or two x.json under\n"
+			"one --out) are refused before anything is written.\n"
+			"Exits with 1 if any file failed to load, validate or write, 2 on bad arguments.\n";
+	}
+
+	bool ParseArgs(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			auto value = [&](const char* flag) -> const char* {
+				if (i + 1 >= argc) {
+					std::cerr << "ede-cli: " << flag << " needs a value\n";
+					return nullptr;
+				}
+				return argv[++i];
+			};
+
+			if (arg == "--validate") {
+				options.validate = true;
+			}
+			else if (arg == "--werror") {
+				options.validate = true;
+				options.warnings_as_errors = true;
+			}
+			else if (arg == "--stats") {
+				options.stats = true;
+			}
+			else if (arg == "--stats-json") {
+				options.stats_json = true;
+			}
+			else if (arg == "--quiet") {
+				options.quiet = true;
+			}
+			else if (arg == "--layout") {
+				options.layout = true;
+			}
+			else if (arg == "--export") {
+				const char* name = value("--export");
+				if (name == nullptr) return false;
+				auto it = std::find_if(std::begin(EncodingArgs), std::end(EncodingArgs),
+					[name](const EncodingArg& e) { return std::strcmp(e.name, name) == 0; });
+				if (it == std::end(EncodingArgs)) {
+					std::cerr << "ede-cli: unknown encoding '" << name << "'\n";
+					return false;
+				}
+				if (std::find(options.exports.begin(), options.exports.end(), it->encoding) == options.exports.end()) {
+					options.exports.push_back(it->encoding);
+				}
+			}
+			else if (arg == "--convert") {
+				const char* format = value("--convert");
+				if (format == nullptr) return false;
+				if (std::strcmp(format, "json") == 0) {
+					options.convert = ConvertFormat::Json;
+				}
+				else if (std::strcmp(format, "binary") == 0) {
+					options.convert = ConvertFormat::Binary;
+				}
+				else {
+					std::cerr << "ede-cli: unknown format '" << format << "'\n";
+					return false;
+				}
+			}
+			else if (arg == "--out") {
+				const char* dir = value("--out");
+				if (dir == nullptr) return false;
+				options.out_dir = dir;
+			}
+			else if (arg == "--jobs") {
+				const char* jobs = value("--jobs");
+				if (jobs == nullptr) return false;
+				char* end = nullptr;
+				const unsigned long count = std::strtoul(jobs, &end, 10);
+				if (!std::isdigit(static_cast<unsigned char>(*jobs)) || *end != '\0' || count > 1024) {
+					std::cerr << "ede-cli: --jobs needs a number of threads, got '" << jobs << "'\n";
+					return false;
+				}
+				options.jobs = static_cast<unsigned>(count);
+			}
+			else if (arg == "--help" || arg == "-h") {
+				PrintUsage();
+				std::exit(0);
+			}
+			else if (arg.starts_with("--")) {
+				std::cerr << "ede-cli: unknown option '" << arg << "'\n";
+				return false;
+			}
+			else {
+				options.inputs.push_back(arg);
+			}
+		}
+		return !options.inputs.empty();
+	}
+
+	// the JSON files this tool writes aren't states, a second run over a directory would read them back otherwise
+	bool IsStateFile(const fs::path& path) {
+		std::string name = path.filename().string();
+		std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		for (const EncodingArg& arg : EncodingArgs) {
+			if (name.ends_with(arg.extension)) {
+				return false;
+			}
+		}
+		if (name.ends_with(StatsExtension)) {
+			return false;
+		}
+		return name.ends_with(".json") || name.ends_with(ede::binary::Extension);
+	}
+
+	// expands directories, sorted so that runs are reproducible
+	bool CollectFiles(const std::vector<std::string>& inputs, std::vector<std::string>& files) {
+		for (const std::string& input : inputs) {
+			std::error_code ec;
+			if (fs::is_directory(input, ec)) {
+				std::vector<std::string> found;
+				for (const fs::directory_entry& entry : fs::recursive_directory_iterator(input, ec)) {
+					if (entry.is_regular_file() && IsStateFile(entry.path())) {
+						found.push_back(entry.path().string());
+					}
+				}
+				std::sort(found.begin(), found.end());
+				files.insert(files.end(), found.begin(), found.end());
+			}
+			else if (fs::exists(input, ec)) {
+				files.push_back(input);
+			}
+			else {
+				std::cerr << "ede-cli: '" << input << "' doesn't exist\n";
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::string OutputPath(const Options& options, const std::string& input, const char* extension) {
+		fs::path in(input);
+		fs::path dir = options.out_dir.empty() ? in.parent_path() : fs::path(options.out_dir);
+		return (dir / in.stem()).string() + extension;
+	}
+
+	// Writing over an input would replace a state with its own export, or a file another worker is still reading.
+	// equivalent() also catches links to the file being processed, the canonical names cover the other inputs
+	bool IsInputFile(const Options& options, const std::string& input, const std::string& output) {
+		std::error_code ec;
+		if (fs::equivalent(input, output, ec)) {
+			return true;
+		}
+		const fs::path canonical = fs::weakly_canonical(output, ec);
+		return !ec && options.input_files.contains(canonical.string());
+	}
+
+	// every file ProcessFile will write for the input, in the order it writes them
+	std::vector<std::string> OutputPaths(const Options& options, const std::string& input) {
+		std::vector<std::string> outputs;
+		if (options.stats_json) {
+			outputs.push_back(OutputPath(options, input, StatsExtension));
+		}
+		for (ede::ExportEncoding encoding : options.exports) {
+			outputs.push_back(OutputPath(options, input, FindEncodingArg(encoding)->extension));
+		}
+		if (options.convert != ConvertFormat::None) {
+			outputs.push_back(OutputPath(options, input, options.convert == ConvertFormat::Binary ? ede::binary::Extension : ".json"));
+		}
+		return outputs;
+	}
+
+	// Inputs with the same stem (x.json in two directories under one --out, or x.json next to x.edeb) would write
+	// the same outputs, the last one to finish winning. Checked up front, before anything is written
+	bool OutputsCollide(const Options& options, const std::vector<std::string>& files) {
+		std::map<std::string, const std::string*> writers;
+		bool collide = false;
+		for (const std::string& file : files) {
+			for (const std::string& output : OutputPaths(options, file)) {
+				std::error_code ec;
+				const fs::path canonical = fs::weakly_canonical(output, ec);
+				auto [it, inserted] = writers.emplace(ec ? output : canonical.string(), &file);
+				if (!inserted) {
+					std::cerr << "ede-cli: " << *it->second << " and " << file << " would both write " << output << "\n";
+					collide = true;
+				}
+			}
+		}
+		return collide;
+	}
+
+	struct FileResult
+	{
+		bool        failed = false;
+		std::string report;
+	};
+
+	void ProcessFile(const Options& options, const std::string& path, FileResult& result) {
+		std::ostringstream out;
+		auto fail = [&](const std::string& message) {
+			out << path << ": error: " << message << "\n";
+			result.failed = true;
+		};
+
+		State state;
+		std::string error;
+		auto start = std::chrono::steady_clock::now();
+		bool loaded = ede::IsBinaryStatePath(path) ? ede::ReadStateBinary(path, state, &error) : ede::ReadStateJson(path, state, &error);
+		if (!loaded) {
+			fail("could not load: " + error);
+			result.report = out.str();
+			return;
+		}
+		double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (options.validate) {
+			for (const ede::ValidationIssue& issue : ede::ValidateState(state)) {
+				out << path << ": " << ede::IssueSeverityName(issue.severity) << ": ";
+				if (issue.node_id != -1) out << "node " << issue.node_id << ": ";
+				if (issue.link_id != -1) out << "link " << issue.link_id << ": ";
+				out << issue.message << "\n";
+				if (issue.severity == ede::IssueSeverity::Error || options.warnings_as_errors) {
+					result.failed = true;
+				}
+			}
+		}
+
+		std::optional<ede::PathAnalysis> paths;
+		if (options.stats || options.stats_json) {
+			paths = ede::AnalyzePaths(state);
+		}
+
+		if (options.stats) {
+			size_t speech = 0, responses = 0, text_bytes = 0;
+			for (const auto& pair : state.nodes) {
+				if (pair.second) {
+					(pair.second->nodeType == NodeType::Speech ? speech : responses)++;
+					text_bytes += pair.second->TextView().size();
+				}
+			}
+			out << path << ": " << state.nodes.size() << " nodes (" << speech << " speech, " << responses << " responses), "
+				<< state.links.size() << " links, " << state.callbacks.size() << " callbacks, "
+				<< text_bytes << " bytes of text, loaded in " << load_ms << " ms\n";
+
+			out << path << ": " << (paths->path_count_saturated ? "at least " : "") << paths->path_count << " playthroughs, "
+				<< paths->loops.size() << " loops (" << paths->nodes_in_loops << " nodes)"
+				<< (paths->root_reaches_loop ? ", playthroughs can go on forever" : "") << ", max depth " << paths->max_depth
+				<< ", longest playthrough " << paths->longest_path << " nodes\n";
+		}
+
+		// same counts as the editor's File -> Export Statistics
+		if (options.stats_json) {
+			ede::GraphStatsTracker tracker;
+			tracker.OnStateReset(state);
+			std::map<std::string, size_t> callback_uses;
+			for (const std::string& callback : state.callbacks) {
+				callback_uses[callback] = 0;
+			}
+			for (const auto& pair : state.nodes) {
+				if (pair.second) {
+					for (const std::string& callback : pair.second->selected_callbacks) {
+						auto it = callback_uses.find(callback);
+						if (it != callback_uses.end()) {
+							it->second++;
+						}
+					}
+				}
+			}
+
+			const std::string output = OutputPath(options, path, StatsExtension);
+			if (IsInputFile(options, path, output)) {
+				fail("not writing " + output + ", it's one of the inputs");
+			}
+			else {
+				std::ofstream file(output, std::ios::binary);
+				file << ede::GraphStatsJson(tracker.Stats(), *paths, callback_uses);
+				if (!file) {
+					fail("could not write " + output);
+				}
+				else if (!options.quiet) {
+					out << path << ": wrote statistics to " << output << "\n";
+				}
+			}
+		}
+
+		// without the editor there are no rendered sizes, every node gets the default one
+		if (options.layout) {
+			const ede::LayoutResult layout = ede::LayeredLayout(state, {});
+			for (const auto& [id, position] : layout.positions) {
+				state.nodes[id]->position = position;
+			}
+			if (!options.quiet) {
+				out << path << ": laid out " << layout.positions.size() << " nodes in " << layout.layer_count << " layers, "
+					<< layout.crossings << " crossings, in " << layout.duration_ms << " ms\n";
+			}
+		}
+
+		if (!options.exports.empty()) {
+			// same node data the editor's export gets from GetNodesData()
+			std::vector<Node> nodes;
+			nodes.reserve(state.nodes.size());
+			for (const auto& pair : state.nodes) {
+				if (pair.second) {
+					nodes.push_back(*pair.second);
+				}
+			}
+			for (ede::ExportEncoding encoding : options.exports) {
+				std::string output = OutputPath(options, path, FindEncodingArg(encoding)->extension);
+				ede::ExportReport report;
+				if (IsInputFile(options, path, output)) {
+					fail("not exporting to " + output + ", it's one of the inputs");
+				}
+				else if (!ede::ExportDialogue(nodes, encoding, output, &report)) {
+					fail("could not write " + output);
+				}
+				else if (!options.quiet) {
+					out << path << ": exported " << ede::ExportEncodingName(encoding) << " to " << output
+						<< " (" << report.size_bytes << " bytes" << (report.unchanged ? ", unchanged" : "") << ")\n";
+				}
+			}
+		}
+
+		if (options.convert != ConvertFormat::None) {
+			std::string output = OutputPath(options, path, options.convert == ConvertFormat::Binary ? ede::binary::Extension : ".json");
+			if (IsInputFile(options, path, output)) {
+				fail("not converting to " + output + ", it's one of the inputs, pick another --out");
+			}
+			else if (!ede::SaveStateAtomically(state, output, &error)) {
+				fail("could not write " + output + ": " + error);
+			}
+			else if (!options.quiet) {
+				out << path << ": converted to " << output << "\n";
+			}
+		}
+
+		// nothing else to say about the file
+		if (!options.quiet && out.tellp() == 0) {
+			out << path << ": ok\n";
+		}
+		result.report = out.str();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseArgs(argc, argv, options)) {
+		PrintUsage();
+		return 2;
+	}
+
+	std::vector<std::string> files;
+	if (!CollectFiles(options.inputs, files)) {
+		return 2;
+	}
+	for (const std::string& file : files) {
+		std::error_code ec;
+		const fs::path canonical = fs::weakly_canonical(file, ec);
+		options.input_files.insert(ec ? file : canonical.string());
+	}
+	if (OutputsCollide(options, files)) {
+		return 2;
+	}
+	if (!options.out_dir.empty()) {
+		std::error_code ec;
+		fs::create_directories(options.out_dir, ec);
+	}
+
+	unsigned jobs = options.jobs != 0 ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+	jobs = std::min<unsigned>(jobs, static_cast<unsigned>(std::max<size_t>(files.size(), 1)));
+
+	// files are handed out one at a time, a few huge ones don't hold up the rest
+	std::vector<FileResult> results(files.size());
+	std::atomic<size_t> next_file = 0;
+	auto worker = [&]() {
+		for (size_t i = next_file++; i < files.size(); i = next_file++) {
+			ProcessFile(options, files[i], results[i]);
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> workers;
+	for (unsigned i = 1; i < jobs; i++) {
+		workers.emplace_back(worker);
+	}
+	worker();
+	for (std::thread& t : workers) {
+		t.join();
+	}
+	double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	size_t failed = 0;
+	for (const FileResult& result : results) {
+		std::cout << result.report;
+		failed += result.failed ? 1 : 0;
+	}
+	if (!options.quiet || failed > 0) {
+		std::cout << files.size() << " files, " << failed << " failed, " << total_ms << " ms on " << jobs << " threads\n";
+	}
+	return failed > 0 ? 1 : 0;
+}
@@ -8,10 +8,12 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
-#include "imnodes.h"
 #include <imgui.h>
 #include <set>
+#include <memory>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 
 #define NOT_CURRENTLY_IN_USE 0
@@ -42,7 +44,13 @@ struct Node
     int         id;
     NodeType    nodeType = NodeType::Speech;
     std::string text;
-    ImVec2      position;
+    // Set while the text still lives in the file the state was loaded from (see State::text_storage),
+    // text is empty until then. Read through TextView(), MaterializeText() before changing it.
+    std::string_view lazy_text{};
+    // where a text copied out by MaterializeText() lay in its file, until the text is edited. Only its address and
+    // size are compared, the file may be gone
+    std::string_view text_origin{};
+    ImVec2      position; // top left corner in grid space, panning the canvas doesn't change it
     int nextNodeId = -1;
     std::vector<int> prevNodeIds{};
     std::vector<int> responses{};
@@ -74,9 +82,49 @@ struct Node
     }
 
     ~Node() = default;
+
+    bool HasLazyText() const { return lazy_text.data() != nullptr; }
+
+    // the text, wherever it lives
+    std::string_view TextView() const { return HasLazyText() ? lazy_text : std::string_view(text); }
+
+    // the file the text came from and where it lay in it, empty for a text typed or edited in the editor
+    std::string_view TextOrigin() const { return HasLazyText() ? lazy_text : text_origin; }
+
+    // copies a lazy text into text, so it can be edited. Whoever edits it calls ForgetTextOrigin()
+    std::string& MaterializeText() {
+        if (HasLazyText()) {
+            text.assign(lazy_text);
+            text_origin = lazy_text;
+            lazy_text = {};
+        }
+        return text;
+    }
+
+    void ForgetTextOrigin() { text_origin = {}; }
 };
 
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Node, id, nodeType, text, nextNodeId, responses, selected_callbacks);
+// what NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Node, id, nodeType, text, nextNodeId, responses, selected_callbacks)
+// would generate, except that lazy texts are written too
+inline void to_json(nlohmann::json& j, const Node& node) {
+    j["id"] = node.id;
+    j["nodeType"] = node.nodeType;
+    j["text"] = node.TextView();
+    j["nextNodeId"] = node.nextNodeId;
+    j["responses"] = node.responses;
+    j["selected_callbacks"] = node.selected_callbacks;
+}
+
+inline void from_json(const nlohmann::json& j, Node& node) {
+    j.at("id").get_to(node.id);
+    j.at("nodeType").get_to(node.nodeType);
+    j.at("text").get_to(node.text);
+    node.lazy_text = {};
+    node.text_origin = {};
+    j.at("nextNodeId").get_to(node.nextNodeId);
+    j.at("responses").get_to(node.responses);
+    j.at("selected_callbacks").get_to(node.selected_callbacks);
+}
 
 struct Link
 {
@@ -113,5 +161,19 @@ struct State {
 	int                                next_node_id = -1;
 	int                                next_link_id = -1;
 	std::set<std::string> callbacks{};
+	// owner of the loaded file lazy node texts point into, shared by every copy of the state that still uses them
+	std::shared_ptr<const void> text_storage{};
+	std::string                 text_storage_path{};
 	//std::set<Conditional> conditionals{}; // pontential future feature, we'll see.
+
+	// lookups that never insert, unlike operator[]. return nullptr for unknown ids
+	std::shared_ptr<Node> FindNode(int node_id) const {
+		auto it = nodes.find(node_id);
+		return it != nodes.end() ? it->second : nullptr;
+	}
+
+	std::shared_ptr<Link> FindLink(int link_id) const {
+		auto it = links.find(link_id);
+		return it != links.end() ? it->second : nullptr;
+	}
 };
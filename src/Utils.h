@@ -9,6 +9,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <nlohmann/json_fwd.hpp>
 
 using json = nlohmann::json;
@@ -51,14 +52,37 @@ DockSpace     ID=0x5F4274ED Window=0x1F1D7494 Pos=0,0 Size=1440,900 Split=X
 
 namespace ede {
 	extern bool marked_for_UI_reset;
+
+	// an entry of the file type filter in the open/save dialogs
+	struct FileType
+	{
+		const wchar_t* name;      // e.g. L"JSON Files"
+		const wchar_t* spec;      // e.g. L"*.json"
+		const wchar_t* extension; // e.g. L"json", appended when the user types no extension
+	};
+
+	inline constexpr FileType JsonFileType = { L"JSON Files", L"*.json", L"json" };
+	inline constexpr FileType BinaryStateFileType = { L"Binary State Files", L"*.edeb", L"edeb" };
+	inline constexpr FileType AnyStateFileType = { L"Saved States", L"*.json;*.edeb", L"json" };
+	inline constexpr FileType ProjectFileType = { L"Dialogue Projects", L"*.edeproj", L"edeproj" };
+
 	class FileDialogs 
 	{
 	public:
+		// out_type_index (if given) receives the 0-based index of the file type the user had selected
+		static bool PickSaveFilePath(const wchar_t* title, std::string& out_path, const std::vector<FileType>& file_types = { JsonFileType },
+			unsigned int* out_type_index = nullptr);
+		static bool PickOpenFilePath(const wchar_t* title, std::string& out_path, const std::vector<FileType>& file_types = { JsonFileType });
 		static void SaveFile(const json& j, const wchar_t* title = L"Save File", bool* file_was_created = nullptr);
 		static json LoadFile(const wchar_t* title = L"Open File");
 		static void ExportDialogueJsonFile();
-		static void SaveStateJson(bool* file_saved = nullptr);
+		static void ExportGraphStats();
+		// save_started tells whether the background save could start, the file is only written once it finishes
+		static void SaveStateJson(bool* save_started = nullptr);
 		static void LoadStateJson();
+		static void NewProject();
+		static void OpenProject();
+		static void AddConversationToProject();
 	};
 
 }
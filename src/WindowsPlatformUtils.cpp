@@ -12,16 +12,27 @@
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <iostream>
+#include <cstdio>
 #include "Node.h"
+#include "state_io.h"
+#include "state_binary.h"
+#include "dialogue_export.h"
 #include <node_editor.h>
 
 namespace ede {
 	bool marked_for_UI_reset = false;
-	std::shared_ptr<Node> node_from_json(const json& j);
-	std::shared_ptr<Link> link_from_json(const json& j);
 
-	void FileDialogs::SaveFile(const json& j, const wchar_t* title, bool* file_was_created) {
-		bool success = false;
+	static std::vector<COMDLG_FILTERSPEC> ToFilterSpecs(const std::vector<FileType>& file_types) {
+		std::vector<COMDLG_FILTERSPEC> specs;
+		for (const FileType& type : file_types) {
+			specs.push_back({ type.name, type.spec });
+		}
+		return specs;
+	}
+
+	bool FileDialogs::PickSaveFilePath(const wchar_t* title, std::string& out_path, const std::vector<FileType>& file_types,
+		unsigned int* out_type_index) {
+		bool picked = false;
 		IFileSaveDialog* pFileSave;
 		HRESULT hr = CoCreateInstance(CLSID_FileSaveDialog, NULL, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&pFileSave));
 
@@ -29,10 +40,10 @@ namespace ede {
 
 			pFileSave->SetTitle(title);
 
-			// Set default file extension
-			COMDLG_FILTERSPEC fileTypes[] = { {L"JSON Files", L"*.json"} };
-			pFileSave->SetFileTypes(1, fileTypes);
-			pFileSave->SetDefaultExtension(L"json");
+			// Set file types, the first one gives the default extension
+			std::vector<COMDLG_FILTERSPEC> fileTypes = ToFilterSpecs(file_types);
+			pFileSave->SetFileTypes(static_cast<UINT>(fileTypes.size()), fileTypes.data());
+			pFileSave->SetDefaultExtension(file_types.front().extension);
 
 			// Show dialog
 			hr = pFileSave->Show(NULL);
@@ -46,30 +57,45 @@ namespace ede {
 					if (SUCCEEDED(hr)) {
 						// Convert PWSTR to std::wstring
 						std::wstring ws(filePath);
-						std::string fileName(ws.begin(), ws.end());
-
-						// Write JSON to file
-						std::ofstream outFile(fileName);
-						if (outFile.is_open()) {
-							outFile << j.dump(4); // Pretty-print JSON
-							outFile.close();
-							success = true;
-						}
+						out_path = std::string(ws.begin(), ws.end());
+						picked = true;
 
 						CoTaskMemFree(filePath);
 					}
 					pItem->Release();
 				}
+
+				// the dialog counts file types from 1
+				UINT typeIndex = 1;
+				if (out_type_index != nullptr && SUCCEEDED(pFileSave->GetFileTypeIndex(&typeIndex))) {
+					*out_type_index = typeIndex - 1;
+				}
 			}
 			pFileSave->Release();
 		}
+		return picked;
+	}
+
+	void FileDialogs::SaveFile(const json& j, const wchar_t* title, bool* file_was_created) {
+		bool success = false;
+		std::string fileName;
+
+		if (PickSaveFilePath(title, fileName)) {
+			// Write JSON to file
+			std::ofstream outFile(fileName);
+			if (outFile.is_open()) {
+				outFile << j.dump(4); // Pretty-print JSON
+				outFile.close();
+				success = true;
+			}
+		}
 		if (file_was_created != nullptr) 
 			*file_was_created = success;
 
 	}
 
-	json FileDialogs::LoadFile(const wchar_t* title) {
-		json j; // Default empty JSON
+	bool FileDialogs::PickOpenFilePath(const wchar_t* title, std::string& out_path, const std::vector<FileType>& file_types) {
+		bool picked = false;
 		IFileOpenDialog* pFileOpen;
 		HRESULT hr = CoCreateInstance(CLSID_FileOpenDialog, NULL, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&pFileOpen));
 
@@ -78,9 +104,9 @@ namespace ede {
 			pFileOpen->SetTitle(title);
 
 			// Set file type filters
-			COMDLG_FILTERSPEC fileTypes[] = { {L"JSON Files", L"*.json"} };
-			pFileOpen->SetFileTypes(1, fileTypes);
-			pFileOpen->SetDefaultExtension(L"json");
+			std::vector<COMDLG_FILTERSPEC> fileTypes = ToFilterSpecs(file_types);
+			pFileOpen->SetFileTypes(static_cast<UINT>(fileTypes.size()), fileTypes.data());
+			pFileOpen->SetDefaultExtension(file_types.front().extension);
 
 			// Show dialog
 			hr = pFileOpen->Show(NULL);
@@ -94,22 +120,8 @@ namespace ede {
 					if (SUCCEEDED(hr)) {
 						// Convert PWSTR to std::wstring
 						std::wstring ws(filePath);
-						std::string fileName(ws.begin(), ws.end());
-
-						// Read JSON from file
-						std::ifstream inFile(fileName);
-						if (inFile.is_open()) {
-							try {
-								inFile >> j; // Parse JSON directly from the file stream
-								inFile.close();
-							}
-							catch (const json::exception& e) {
-								std::cerr << "Error parsing JSON: " << e.what() << std::endl;
-							}
-						}
-						else {
-							std::cerr << "Could not open file: " << fileName << std::endl;
-						}
+						out_path = std::string(ws.begin(), ws.end());
+						picked = true;
 
 						CoTaskMemFree(filePath);
 					}
@@ -118,140 +130,153 @@ namespace ede {
 			}
 			pFileOpen->Release();
 		}
+		return picked;
+	}
+
+	json FileDialogs::LoadFile(const wchar_t* title) {
+		json j; // Default empty JSON
+		std::string fileName;
+
+		if (PickOpenFilePath(title, fileName)) {
+			// Read JSON from file
+			std::ifstream inFile(fileName);
+			if (inFile.is_open()) {
+				try {
+					inFile >> j; // Parse JSON directly from the file stream
+					inFile.close();
+				}
+				catch (const json::exception& e) {
+					std::cerr << "Error parsing JSON: " << e.what() << std::endl;
+				}
+			}
+			else {
+				std::cerr << "Could not open file: " << fileName << std::endl;
+			}
+		}
 
 		return j;
 	}
 
+	// Exports in whichever encoding's file type was picked in the dialog
 	void FileDialogs::ExportDialogueJsonFile()
 	{
-		std::vector<Node> nodes = ede::GetNodesData();
-		json j;
-		for (const Node& node : nodes) {
-			j.push_back(node);
+		static const std::vector<FileType> exportFileTypes = {
+			{ L"JSON", L"*.json", L"json" },
+			{ L"Minified JSON", L"*.json", L"json" },
+			{ L"CBOR", L"*.cbor", L"cbor" },
+			{ L"MessagePack", L"*.msgpack", L"msgpack" },
+			{ L"UBJSON", L"*.ubj", L"ubj" },
+			{ L"Compiled Dialogue", L"*.edec", L"edec" },
+		};
+		static_assert(static_cast<int>(ExportEncoding::Count) == 6, "keep the export file types in sync with ExportEncoding");
+
+		if (ede::IsLoading()) {
+			ede::RequestNotification("Load in progress", "The conversation is still being loaded.\nTry again once it's done.");
+			return;
 		}
-		std::cout << j << std::endl;
-		bool exported;
-		SaveFile(j, L"Export Dialogue", &exported);
-		if (exported) {
-			ede::RequestNotification("Success", "Your dialogue was successfully exported!");
+
+		std::string fileName;
+		unsigned int typeIndex = 0;
+		if (!PickSaveFilePath(L"Export Dialogue", fileName, exportFileTypes, &typeIndex)) {
+			return;
+		}
+		ExportEncoding encoding = typeIndex < exportFileTypes.size() ? static_cast<ExportEncoding>(typeIndex) : ExportEncoding::PrettyJson;
+
+		ExportReport report;
+		if (!ExportDialogue(ede::GetNodesData(), encoding, fileName, &report)) {
+			ede::RequestNotification("Export failed", "Could not write the exported dialogue to the file.");
+			return;
 		}
+
+		char description[256];
+		snprintf(description, sizeof(description), "%s\n\n%s, %.1f KB, encoded in %.2f ms",
+			report.unchanged ? "The file already holds this export, nothing was written." : "Your dialogue was successfully exported!",
+			ExportEncodingName(encoding), report.size_bytes / 1024.0, report.encode_ms);
+		ede::RequestNotification("Success", description);
 	}
 
-	// Converts state to json
-	void FileDialogs::SaveStateJson(bool* file_saved) {
-
-		State state = ede::GetCurrentState();
-
-		json nodes;
-		for (const auto& pair : state.nodes) {
-			std::shared_ptr<Node> node = pair.second;
-			if (node) {
-				nodes.push_back({
-					{"nodeId", node->id},
-					{"nodeType", static_cast<int>(node->nodeType)},
-					{"text", node->text},
-					{"position", {{"x", ImNodes::GetNodeScreenSpacePos(node->id).x}, {"y", ImNodes::GetNodeScreenSpacePos(node->id).y}}},
-					{"nextNodeId", node->nextNodeId},
-					{"prevNodeIds", node->prevNodeIds},
-					{"responses", node->responses},
-					{"expectsResponse", node->expectesResponse},
-					{"selected_callbacks", node->selected_callbacks}
-					});
-			}
+	// The counts shown in the graph info window, as JSON for dashboards tracking a conversation's size
+	void FileDialogs::ExportGraphStats()
+	{
+		if (ede::IsLoading()) {
+			ede::RequestNotification("Load in progress", "The conversation is still being loaded.\nTry again once it's done.");
+			return;
 		}
 
-		json links;
-		for (const auto& pair : state.links) {
-			std::shared_ptr<Link> link = pair.second;
-			if (link) {
-				links.push_back(*link);
-			}
+		std::string fileName;
+		if (!PickSaveFilePath(L"Export Statistics", fileName, { JsonFileType })) {
+			return;
 		}
 
-		json j = json{
-			{"nodes", nodes},
-			{"links", links},
-			{"next_node_id", state.next_node_id},
-			{"next_link_id", state.next_link_id},
-			{"callbacks", state.callbacks},
-			/* TODO: place 'conditionals' here, once its implemented */
-		};
-		if (file_saved != nullptr) {
-			SaveFile(j, L"Save Current State", file_saved);
+		const std::string stats = ede::GetGraphStatsJson();
+		FILE* file = fopen(fileName.c_str(), "w");
+		if (!file) {
+			ede::RequestNotification("Export failed", "Could not write the statistics to the file.");
+			return;
 		}
-		else {
-			SaveFile(j, L"Save Current State");
+		const bool written = fwrite(stats.data(), 1, stats.size(), file) == stats.size();
+		fclose(file);
+		if (!written) {
+			ede::RequestNotification("Export failed", "Could not write the statistics to the file.");
+			return;
 		}
+		ede::RequestNotification("Success", "The statistics were exported.");
 	}
 
-	void FileDialogs::LoadStateJson()
-	{
-		json j = LoadFile(L"Load a previous state");
-		if (!j.empty()) {
-
-			if (!j.contains("nodes") || !j.contains("links") ||
-				!j.contains("next_node_id") || !j.contains("next_link_id") ||
-				!j.contains("callbacks"))
-			{
-				std::cout << "Invalid JSON\n";
-				ede::RequestNotification("Invalid JSON", "Could not parse the data from the file. \nMaybe you chose the wrong file or it's corrupted.");
-				return;
-			}
-			State new_state;
+	// Hands a snapshot of the state to the background saver, the editor stays usable while it's written.
+	// The format follows the extension that was picked, json or binary.
+	void FileDialogs::SaveStateJson(bool* save_started) {
+		bool started = false;
+		std::string fileName;
 
-			// Load nodes
-			std::vector<json> nodes_json = j.at("nodes").get<std::vector<json>>();
-			for (const json& jn : nodes_json) {
-				std::shared_ptr<Node> node = node_from_json(jn);
-				new_state.nodes[node->id] = node;
-			}
-
-			// Load links
-			std::vector<json> links_json = j.at("links").get<std::vector<json>>();
-			for (const json& jl : links_json) {
-				std::shared_ptr<Link> link = link_from_json(jl);
-				new_state.links[link->id] = link;
+		if (ede::IsLoading()) {
+			ede::RequestNotification("Load in progress", "The conversation is still being loaded.\nTry again once it's done.");
+		}
+		else if (PickSaveFilePath(L"Save Current State", fileName, { JsonFileType, BinaryStateFileType })) {
+			started = ede::SaveStateInBackground(fileName);
+			if (!started) {
+				ede::RequestNotification("Save in progress", "The previous save is still being written.\nTry again in a moment.");
 			}
-
-			new_state.next_node_id = j.at("next_node_id").get<int>();
-
-			new_state.next_link_id = j.at("next_link_id").get<int>();
-
-			new_state.callbacks = j.at("callbacks").get<std::set<std::string>>();
-
-			ede::SetState(new_state);
 		}
-
+		if (save_started != nullptr) {
+			*save_started = started;
+		}
 	}
 
-	// --- helper methods ---
-
-	std::shared_ptr<Node> node_from_json(const json& j) {
-
-		int nodeId = j.at("nodeId").get<int>();
-		NodeType nodeType = static_cast<NodeType>(j.at("nodeType").get<int>());
-		std::string text = j.at("text").get<std::string>();
-		ImVec2 position(j.at("position").at("x").get<float>(), j.at("position").at("y").get<float>());
-		int nextNodeId = j.at("nextNodeId").get<int>();
-		std::vector<int> prevNodeIds = j.at("prevNodeIds").get<std::vector<int>>();
-		std::vector<int> responses = j.at("responses").get<std::vector<int>>();
-		bool expectsResponse = j.at("expectsResponse").get<bool>();
-
-		std::set<std::string> selected_callbacks;
-		for (auto& callback : j.at("selected_callbacks").get<std::vector<std::string>>()) {
-			selected_callbacks.insert(callback);
+	// The file is read on a worker thread and shows up on the canvas as it's read, see progressive_load.h.
+	// Binary states are mapped, their texts only read once their node is shown
+	void FileDialogs::LoadStateJson()
+	{
+		std::string fileName;
+		if (!PickOpenFilePath(L"Load a previous state", fileName, { AnyStateFileType, JsonFileType, BinaryStateFileType })) {
+			return;
 		}
+		ede::LoadStateInBackground(fileName);
+	}
 
-		return std::make_shared<Node>(nodeId, nodeType, text, position, nextNodeId, prevNodeIds,
-			responses, expectsResponse, selected_callbacks);
+	void FileDialogs::NewProject()
+	{
+		std::string fileName;
+		if (PickSaveFilePath(L"New project", fileName, { ProjectFileType })) {
+			ede::CreateProject(fileName);
+		}
 	}
 
-	std::shared_ptr<Link> link_from_json(const json& j) {
-		int id = j.at("id").get<int>();
-		int start_attr = j.at("start_attr").get<int>();
-		int end_attr = j.at("end_attr").get<int>();
+	void FileDialogs::OpenProject()
+	{
+		std::string fileName;
+		if (PickOpenFilePath(L"Open a project", fileName, { ProjectFileType })) {
+			ede::OpenProject(fileName);
+		}
+	}
 
-		return std::make_shared<Link>(id, start_attr, end_attr);
+	// the file is only read to summarize it, it doesn't get opened
+	void FileDialogs::AddConversationToProject()
+	{
+		std::string fileName;
+		if (PickOpenFilePath(L"Add a conversation to the project", fileName, { AnyStateFileType, JsonFileType, BinaryStateFileType })) {
+			ede::AddConversationToProject(fileName);
+		}
 	}
 
 
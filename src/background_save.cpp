@@ -0,0 +1,208 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "background_save.h"
+#include "state_io.h"
+#include "state_binary.h"
+#include <chrono>
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace ede
+{
+	namespace
+	{
+		bool Fail(std::string* error, const std::string& message) {
+			if (error != nullptr) {
+				*error = message;
+			}
+			return false;
+		}
+	}
+
+	bool FlushFileToDisk(std::FILE* file)
+	{
+		if (std::fflush(file) != 0) {
+			return false;
+		}
+#ifdef _WIN32
+		return _commit(_fileno(file)) == 0;
+#else
+		return fsync(fileno(file)) == 0;
+#endif
+	}
+
+	bool ReplaceFileAtomically(const std::string& from, const std::string& to)
+	{
+#ifdef _WIN32
+		return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+		return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+	}
+
+	std::shared_ptr<const State> SnapshotCache::Take(const State& state)
+	{
+		if (!cache) {
+			cache = std::make_shared<State>();
+			cache->nodes.reserve(state.nodes.size());
+			for (const auto& [id, node] : state.nodes) {
+				if (node) {
+					cache->nodes.emplace(id, std::make_shared<Node>(*node));
+				}
+			}
+			cache->links.reserve(state.links.size());
+			for (const auto& [id, link] : state.links) {
+				if (link) {
+					cache->links.emplace(id, std::make_shared<Link>(*link));
+				}
+			}
+		}
+		else {
+			// the last snapshot is still being read, this one gets its own tables. Nodes and links stay shared
+			if (cache.use_count() > 1) {
+				cache = std::make_shared<State>(*cache);
+			}
+			for (int id : dirty_nodes) {
+				std::shared_ptr<Node> node = state.FindNode(id);
+				if (node) {
+					cache->nodes[id] = std::make_shared<Node>(*node);
+				}
+				else {
+					cache->nodes.erase(id);
+				}
+			}
+			for (int id : dirty_links) {
+				std::shared_ptr<Link> link = state.FindLink(id);
+				if (link) {
+					cache->links[id] = std::make_shared<Link>(*link);
+				}
+				else {
+					cache->links.erase(id);
+				}
+			}
+		}
+		dirty_nodes.clear();
+		dirty_links.clear();
+
+		cache->next_node_id = state.next_node_id;
+		cache->next_link_id = state.next_link_id;
+		cache->callbacks = state.callbacks;
+		// lazy texts keep pointing into the same file, which the snapshot keeps open
+		cache->text_storage = state.text_storage;
+		cache->text_storage_path = state.text_storage_path;
+		return cache;
+	}
+
+	// the callback is taken out of the nodes carrying it, whether or not each was reported
+	void SnapshotCache::OnCallbackRemoved(const std::string& callback)
+	{
+		if (!cache) {
+			return;
+		}
+		for (const auto& [id, node] : cache->nodes) {
+			if (node->selected_callbacks.contains(callback)) {
+				dirty_nodes.insert(id);
+			}
+		}
+	}
+
+	bool SaveStateAtomically(const State& state, const std::string& path, std::string* error,
+		const std::function<void(float)>& on_progress)
+	{
+		const bool binary = IsBinaryStatePath(path);
+		const std::string temp_path = path + ".tmp";
+
+		// json keeps being written in text mode, like the std::ofstream it started with
+		std::FILE* file = std::fopen(temp_path.c_str(), binary ? "wb" : "w");
+		if (file == nullptr) {
+			return Fail(error, "Could not create " + temp_path);
+		}
+
+		bool written = binary ? WriteStateBinary(state, file, on_progress) : WriteStateJson(state, file, on_progress);
+		written = written && FlushFileToDisk(file);
+		written = std::fclose(file) == 0 && written;
+		if (!written) {
+			std::remove(temp_path.c_str());
+			return Fail(error, "Could not write " + temp_path + ", is the disk full?");
+		}
+
+		if (!ReplaceFileAtomically(temp_path, path)) {
+			std::remove(temp_path.c_str());
+			return Fail(error, "Could not replace " + path + ", is it open somewhere else?");
+		}
+		return true;
+	}
+
+	/******************************************************************************
+	 *                              BackgroundSaver
+	 ******************************************************************************/
+
+	BackgroundSaver::~BackgroundSaver()
+	{
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+
+	bool BackgroundSaver::Start(std::shared_ptr<const State> snapshot, const std::string& path)
+	{
+		if (busy) {
+			return false;
+		}
+		// the previous save is done, only its thread is left to collect
+		if (worker.joinable()) {
+			worker.join();
+		}
+
+		busy = true;
+		progress = 0.0f;
+		worker = std::thread([this, snapshot = std::move(snapshot), path]() {
+			auto start = std::chrono::steady_clock::now();
+
+			SaveResult outcome;
+			outcome.path = path;
+			outcome.success = SaveStateAtomically(*snapshot, path, &outcome.error, [this](float fraction) { progress = fraction; });
+			outcome.duration_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			{
+				std::lock_guard<std::mutex> lock(result_mutex);
+				result = std::move(outcome);
+			}
+			progress = 1.0f;
+			finished = true;
+			busy = false;
+		});
+		return true;
+	}
+
+	void BackgroundSaver::Wait()
+	{
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+
+	bool BackgroundSaver::PollFinished(SaveResult& out_result)
+	{
+		if (!finished.exchange(false)) {
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(result_mutex);
+		out_result = std::move(result);
+		return true;
+	}
+}
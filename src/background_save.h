@@ -0,0 +1,105 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "state_listener.h"
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+/******************************************************************************
+ *                 Saving the state without blocking the UI
+ ******************************************************************************/
+
+namespace ede
+{
+	// fflush plus fsync (_commit on Windows): the file's contents are on the disk once this returns true
+	bool FlushFileToDisk(std::FILE* file);
+
+	// renames from over to in one step, so readers of to see either the old or the new file, never a mix
+	bool ReplaceFileAtomically(const std::string& from, const std::string& to);
+
+	// Copies of the state that another thread can read while the editor keeps modifying the original.
+	// A snapshot's nodes and links are never modified: an edited node gets a new copy in the next
+	// snapshot, and everything that didn't change is shared with the previous one, so taking a
+	// snapshot only copies what changed since the last. Listens to the state to know what did.
+	class SnapshotCache : public StateListener
+	{
+	public:
+		// Shares unchanged nodes and links with the previous snapshot. The first one after a reset copies them all
+		std::shared_ptr<const State> Take(const State& state);
+
+		// the state was changed without notifications (MaterializeAllText), the next snapshot copies everything
+		void Invalidate() { cache.reset(); }
+
+		void OnStateReset(const State&) override { Invalidate(); }
+		void OnNodeAdded(const Node& node) override { dirty_nodes.insert(node.id); }
+		void OnNodeRemoved(int node_id) override { dirty_nodes.insert(node_id); }
+		void OnNodeChanged(const Node& node, NodeChange) override { dirty_nodes.insert(node.id); }
+		void OnLinkAdded(const Link& link) override { dirty_links.insert(link.id); }
+		void OnLinkRemoved(int link_id) override { dirty_links.insert(link_id); }
+		void OnCallbackRemoved(const std::string& callback) override;
+
+	private:
+		std::shared_ptr<State>  cache; // the last snapshot, copied first if a reader still holds it
+		std::unordered_set<int> dirty_nodes;
+		std::unordered_set<int> dirty_links;
+	};
+
+	// Writes the state to a temporary file next to path, flushes it to the disk and only then
+	// renames it over path. A crash or a failed write never leaves a truncated save behind.
+	// The format follows the extension, see IsBinaryStatePath.
+	bool SaveStateAtomically(const State& state, const std::string& path, std::string* error = nullptr,
+		const std::function<void(float)>& on_progress = {});
+
+	struct SaveResult
+	{
+		bool        success = false;
+		std::string path;
+		std::string error;
+		double      duration_ms = 0.0;
+	};
+
+	// Runs one SaveStateAtomically at a time on a worker thread.
+	// Start(), Wait() and PollFinished() are meant to be called from the UI thread.
+	class BackgroundSaver
+	{
+	public:
+		BackgroundSaver() = default;
+		~BackgroundSaver(); // waits for the running save, if any
+
+		BackgroundSaver(const BackgroundSaver&) = delete;
+		BackgroundSaver& operator=(const BackgroundSaver&) = delete;
+
+		// keeps the snapshot until the save is done. Returns false if a save is still running
+		bool Start(std::shared_ptr<const State> snapshot, const std::string& path);
+
+		bool  IsBusy() const { return busy; }
+
+		// blocks until the running save, if any, is done. Its outcome still goes through PollFinished()
+		void Wait();
+		float Progress() const { return progress; }
+
+		// returns true once for every finished save, with its outcome in out_result
+		bool PollFinished(SaveResult& out_result);
+
+	private:
+		std::thread        worker;
+		std::atomic<bool>  busy = false;
+		std::atomic<bool>  finished = false;
+		std::atomic<float> progress = 0.0f;
+		std::mutex         result_mutex;
+		SaveResult         result;
+	};
+}
@@ -0,0 +1,418 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "background_validation.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace ede
+{
+	namespace
+	{
+		int InputPin(int node_id) { return static_cast<int>(static_cast<uint32_t>(node_id) << NodePartShift::InputPin); }
+		int OutputPin(int node_id) { return static_cast<int>(static_cast<uint32_t>(node_id) << NodePartShift::EndPin); }
+
+		// everything the checks read, the text and position aren't copied
+		std::shared_ptr<Node> StructureOf(const Node& node)
+		{
+			std::shared_ptr<Node> copy = std::make_shared<Node>(node.id, node.nodeType, std::string(), ImVec2());
+			copy->nextNodeId = node.nextNodeId;
+			copy->prevNodeIds = node.prevNodeIds;
+			copy->responses = node.responses;
+			copy->expectesResponse = node.expectesResponse;
+			copy->selected_callbacks = node.selected_callbacks;
+			return copy;
+		}
+
+		// ids the node names, duplicates included
+		template <typename Fn>
+		void ForEachMention(const Node& node, Fn fn)
+		{
+			if (node.nextNodeId != -1) {
+				fn(node.nextNodeId);
+			}
+			for (int id : node.responses) {
+				fn(id);
+			}
+			for (int id : node.prevNodeIds) {
+				fn(id);
+			}
+		}
+
+		// adds or removes one occurrence of value in the list under key, dropping lists that become empty
+		void UpdateMultimap(std::unordered_map<int, std::vector<int>>& map, int key, int value, bool add)
+		{
+			if (add) {
+				map[key].push_back(value);
+				return;
+			}
+			auto it = map.find(key);
+			if (it == map.end()) {
+				return;
+			}
+			auto value_it = std::find(it->second.begin(), it->second.end(), value);
+			if (value_it != it->second.end()) {
+				*value_it = it->second.back();
+				it->second.pop_back();
+			}
+			if (it->second.empty()) {
+				map.erase(it);
+			}
+		}
+	}
+
+	bool BackgroundValidator::Changes::Empty() const
+	{
+		return !reset && nodes.empty() && links.empty() && callbacks_added.empty() && callbacks_removed.empty();
+	}
+
+	BackgroundValidator::BackgroundValidator()
+	{
+		worker = std::thread([this]() { Run(); });
+	}
+
+	BackgroundValidator::~BackgroundValidator()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_one();
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+
+	/******************************************************************************
+	 *                              UI thread
+	 ******************************************************************************/
+
+	void BackgroundValidator::Update()
+	{
+		if (busy || pending.Empty()) {
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			handed = std::move(pending);
+			has_work = true;
+			busy = true;
+		}
+		pending = {};
+		wake.notify_one();
+	}
+
+	bool BackgroundValidator::IsPending() const
+	{
+		return busy || !pending.Empty();
+	}
+
+	std::shared_ptr<const ValidationReport> BackgroundValidator::Report() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return report;
+	}
+
+	// edits made before the reset don't matter anymore
+	void BackgroundValidator::OnStateReset(const State& state)
+	{
+		pending = {};
+		pending.reset = true;
+		State& copy = pending.reset_state;
+		copy.next_node_id = state.next_node_id;
+		copy.next_link_id = state.next_link_id;
+		copy.callbacks = state.callbacks;
+		copy.nodes.reserve(state.nodes.size());
+		for (const auto& [id, node] : state.nodes) {
+			if (node) {
+				copy.nodes.emplace(id, StructureOf(*node));
+			}
+		}
+		copy.links.reserve(state.links.size());
+		for (const auto& [id, link] : state.links) {
+			if (link) {
+				copy.links.emplace(id, std::make_shared<Link>(*link));
+			}
+		}
+	}
+
+	void BackgroundValidator::OnNodeAdded(const Node& node)
+	{
+		pending.nodes[node.id] = StructureOf(node);
+	}
+
+	void BackgroundValidator::OnNodeRemoved(int node_id)
+	{
+		pending.nodes[node_id] = nullptr;
+	}
+
+	// no check reads the text or the position, dragging and typing cost nothing
+	void BackgroundValidator::OnNodeChanged(const Node& node, NodeChange change)
+	{
+		if (change != NodeChange::Text && change != NodeChange::Position) {
+			pending.nodes[node.id] = StructureOf(node);
+		}
+	}
+
+	void BackgroundValidator::OnLinkAdded(const Link& link)
+	{
+		pending.links[link.id] = std::make_shared<Link>(link);
+	}
+
+	void BackgroundValidator::OnLinkRemoved(int link_id)
+	{
+		pending.links[link_id] = nullptr;
+	}
+
+	void BackgroundValidator::OnCallbackAdded(const std::string& callback)
+	{
+		pending.callbacks_removed.erase(callback);
+		pending.callbacks_added.insert(callback);
+	}
+
+	void BackgroundValidator::OnCallbackRemoved(const std::string& callback)
+	{
+		pending.callbacks_added.erase(callback);
+		pending.callbacks_removed.insert(callback);
+	}
+
+	/******************************************************************************
+	 *                              Worker thread
+	 ******************************************************************************/
+
+	void BackgroundValidator::Run()
+	{
+		for (;;) {
+			Changes changes;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [this]() { return has_work || stopping; });
+				if (stopping) {
+					return;
+				}
+				changes = std::move(handed);
+				handed = {};
+				has_work = false;
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			Apply(changes);
+			Revalidate();
+			Publish(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		}
+	}
+
+	void BackgroundValidator::Apply(Changes& changes)
+	{
+		full_pass = changes.reset;
+		if (changes.reset) {
+			snapshot = std::move(changes.reset_state);
+			link_index = {};
+			mentioned_by.clear();
+			links_by_start.clear();
+			links_by_end.clear();
+			node_ids.clear();
+			link_ids.clear();
+			node_issues.clear();
+			link_issues.clear();
+			for (const auto& [id, node] : snapshot.nodes) {
+				IndexNode(*node, true);
+				node_ids.insert(id);
+				touched_nodes.insert(id);
+			}
+			for (const auto& [id, link] : snapshot.links) {
+				IndexLink(*link, true);
+				link_ids.insert(id);
+				touched_links.insert(id);
+			}
+		}
+
+		// the only nodes a callback's declaration matters to are the ones that selected it
+		if (!changes.callbacks_added.empty() || !changes.callbacks_removed.empty()) {
+			for (const std::string& callback : changes.callbacks_removed) {
+				snapshot.callbacks.erase(callback);
+			}
+			snapshot.callbacks.insert(changes.callbacks_added.begin(), changes.callbacks_added.end());
+			for (const auto& [id, node] : snapshot.nodes) {
+				for (const std::string& callback : node->selected_callbacks) {
+					if (changes.callbacks_added.contains(callback) || changes.callbacks_removed.contains(callback)) {
+						touched_nodes.insert(id);
+						break;
+					}
+				}
+			}
+		}
+
+		for (auto& [id, node] : changes.nodes) {
+			ApplyNode(id, std::move(node));
+		}
+		for (auto& [id, link] : changes.links) {
+			ApplyLink(id, std::move(link));
+		}
+	}
+
+	// the node, every node it names before and after, and every node naming it are checked again
+	void BackgroundValidator::ApplyNode(int node_id, std::shared_ptr<Node> node)
+	{
+		touched_nodes.insert(node_id);
+		auto touch = [this](int id) { touched_nodes.insert(id); };
+
+		auto it = snapshot.nodes.find(node_id);
+		if (it != snapshot.nodes.end()) {
+			ForEachMention(*it->second, touch);
+			IndexNode(*it->second, false);
+		}
+		if (node) {
+			ForEachMention(*node, touch);
+			IndexNode(*node, true);
+			snapshot.nodes[node_id] = std::move(node);
+			snapshot.next_node_id = std::max(snapshot.next_node_id, node_id);
+			node_ids.insert(node_id);
+		}
+		else {
+			snapshot.nodes.erase(node_id);
+			node_ids.erase(node_id);
+		}
+
+		auto mentions = mentioned_by.find(node_id);
+		if (mentions != mentioned_by.end()) {
+			touched_nodes.insert(mentions->second.begin(), mentions->second.end());
+		}
+	}
+
+	void BackgroundValidator::ApplyLink(int link_id, std::shared_ptr<Link> link)
+	{
+		touched_links.insert(link_id);
+
+		auto it = snapshot.links.find(link_id);
+		if (it != snapshot.links.end()) {
+			TouchLinkEnds(*it->second);
+			IndexLink(*it->second, false);
+		}
+		if (link) {
+			TouchLinkEnds(*link);
+			IndexLink(*link, true);
+			snapshot.links[link_id] = std::move(link);
+			snapshot.next_link_id = std::max(snapshot.next_link_id, link_id);
+			link_ids.insert(link_id);
+		}
+		else {
+			snapshot.links.erase(link_id);
+			link_ids.erase(link_id);
+		}
+	}
+
+	void BackgroundValidator::IndexNode(const Node& node, bool add)
+	{
+		ForEachMention(node, [&](int id) { UpdateMultimap(mentioned_by, id, node.id, add); });
+	}
+
+	void BackgroundValidator::IndexLink(const Link& link, bool add)
+	{
+		if (add) {
+			link_index.Add(link);
+		}
+		else {
+			link_index.Remove(link);
+		}
+		UpdateMultimap(links_by_start, link.start_attr, link.id, add);
+		UpdateMultimap(links_by_end, link.end_attr, link.id, add);
+	}
+
+	// Whether a node's connection has a link depends on the links at its pins. The start pin is shared
+	// by ids 256 apart, the nodes naming the end node are the ones it can belong to
+	void BackgroundValidator::TouchLinkEnds(const Link& link)
+	{
+		const int start_id = static_cast<int>(static_cast<uint32_t>(link.start_attr) >> NodePartShift::EndPin);
+		const int end_id = static_cast<int>(static_cast<uint32_t>(link.end_attr) >> NodePartShift::InputPin);
+		touched_nodes.insert(start_id);
+		auto mentions = mentioned_by.find(end_id);
+		if (mentions != mentioned_by.end()) {
+			for (int id : mentions->second) {
+				if (OutputPin(id) == link.start_attr) {
+					touched_nodes.insert(id);
+				}
+			}
+		}
+	}
+
+	void BackgroundValidator::Revalidate()
+	{
+		// A link's checks read its end node, the end node's previous nodes, which name it and so are touched along
+		// with it, and the node its start pin decodes to. Only ids below 256 decode back from their output pin
+		auto touch_links = [this](const std::unordered_map<int, std::vector<int>>& links, int attribute) {
+			auto it = links.find(attribute);
+			if (it != links.end()) {
+				touched_links.insert(it->second.begin(), it->second.end());
+			}
+		};
+		if (!full_pass) {
+			for (int id : touched_nodes) {
+				touch_links(links_by_end, InputPin(id));
+				if (id >= 0 && static_cast<int>(static_cast<uint32_t>(OutputPin(id)) >> NodePartShift::EndPin) == id) {
+					touch_links(links_by_start, OutputPin(id));
+				}
+			}
+		}
+		full_pass = false;
+
+		for (int id : touched_nodes) {
+			node_issues.erase(id);
+			std::shared_ptr<Node> node = snapshot.FindNode(id);
+			if (!node) {
+				continue;
+			}
+			std::vector<ValidationIssue> issues;
+			ValidateNode(snapshot, link_index, id, node.get(), issues);
+			if (!issues.empty()) {
+				node_issues.emplace(id, std::move(issues));
+			}
+		}
+		for (int id : touched_links) {
+			link_issues.erase(id);
+			auto it = snapshot.links.find(id);
+			if (it == snapshot.links.end()) {
+				continue;
+			}
+			std::vector<ValidationIssue> issues;
+			ValidateLink(snapshot, id, it->second.get(), issues);
+			if (!issues.empty()) {
+				link_issues.emplace(id, std::move(issues));
+			}
+		}
+
+		nodes_checked = touched_nodes.size();
+		links_checked = touched_links.size();
+		touched_nodes.clear();
+		touched_links.clear();
+	}
+
+	void BackgroundValidator::Publish(double duration_ms)
+	{
+		auto next = std::make_shared<ValidationReport>();
+		for (const auto& [id, issues] : node_issues) {
+			next->issues.insert(next->issues.end(), issues.begin(), issues.end());
+		}
+		for (const auto& [id, issues] : link_issues) {
+			next->issues.insert(next->issues.end(), issues.begin(), issues.end());
+		}
+		ValidateIdCounters(snapshot, node_ids.empty() ? -1 : *node_ids.rbegin(), link_ids.empty() ? -1 : *link_ids.rbegin(), next->issues);
+		SortIssues(next->issues);
+		for (const ValidationIssue& issue : next->issues) {
+			(issue.severity == IssueSeverity::Error ? next->error_count : next->warning_count)++;
+		}
+		next->nodes_checked = nodes_checked;
+		next->links_checked = links_checked;
+		next->duration_ms = duration_ms;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		report = std::move(next);
+		busy = false;
+	}
+}
@@ -0,0 +1,129 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "state_listener.h"
+#include "state_validation.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/******************************************************************************
+ *              Validating the state without blocking the UI
+ *
+ *   The validator listens to the editor's edits and keeps copies of the
+ *   nodes and links they touched, without their texts, which is all an
+ *   edit costs the UI thread. Once per frame the copies go to a worker
+ *   thread that keeps its own snapshot of the state. The worker applies
+ *   them to the snapshot and runs the checks of state_validation.h again,
+ *   but only for what they touched and their neighbours. Only a state
+ *   reset copies and checks the whole state.
+ ******************************************************************************/
+
+namespace ede
+{
+	struct ValidationReport
+	{
+		std::vector<ValidationIssue> issues; // in ValidateState's order
+		size_t error_count = 0;
+		size_t warning_count = 0;
+		size_t nodes_checked = 0; // by the pass that made the report
+		size_t links_checked = 0;
+		double duration_ms = 0.0;
+	};
+
+	class BackgroundValidator : public StateListener
+	{
+	public:
+		BackgroundValidator();
+		~BackgroundValidator(); // stops the worker, a running pass is finished first
+
+		BackgroundValidator(const BackgroundValidator&) = delete;
+		BackgroundValidator& operator=(const BackgroundValidator&) = delete;
+
+		// Hands the edits made since the last call to the worker, unless it's still busy with the previous ones.
+		// Meant to be called once per frame from the UI thread
+		void Update();
+
+		// a pass is running or edits are waiting for one, the report may be behind the state
+		bool IsPending() const;
+
+		// The last finished pass, null before the first one. Shared so the UI can keep reading it while newer ones are made
+		std::shared_ptr<const ValidationReport> Report() const;
+
+		void OnStateReset(const State& state) override;
+		void OnNodeAdded(const Node& node) override;
+		void OnNodeRemoved(int node_id) override;
+		void OnNodeChanged(const Node& node, NodeChange change) override;
+		void OnLinkAdded(const Link& link) override;
+		void OnLinkRemoved(int link_id) override;
+		void OnCallbackAdded(const std::string& callback) override;
+		void OnCallbackRemoved(const std::string& callback) override;
+
+	private:
+		// edits not checked yet, the last copy of each node and link wins. null stands for removed
+		struct Changes
+		{
+			bool                                            reset = false;
+			State                                           reset_state;
+			std::unordered_map<int, std::shared_ptr<Node>> nodes;
+			std::unordered_map<int, std::shared_ptr<Link>> links;
+			std::set<std::string>                           callbacks_added;
+			std::set<std::string>                           callbacks_removed;
+
+			bool Empty() const;
+		};
+
+		// worker side, only touched by the worker thread
+		void Run();
+		void Apply(Changes& changes);
+		void ApplyNode(int node_id, std::shared_ptr<Node> node);
+		void ApplyLink(int link_id, std::shared_ptr<Link> link);
+		void IndexNode(const Node& node, bool add);
+		void IndexLink(const Link& link, bool add);
+		void TouchLinkEnds(const Link& link);
+		void Revalidate();
+		void Publish(double duration_ms);
+
+		// UI side
+		Changes pending;
+
+		// handed over to the worker
+		std::thread             worker;
+		mutable std::mutex      mutex;
+		std::condition_variable wake;
+		Changes                 handed;
+		bool                    has_work = false;
+		bool                    stopping = false;
+		std::atomic<bool>       busy = false;
+		std::shared_ptr<const ValidationReport> report;
+
+		// the worker's snapshot, with what lets it find what an edit affects
+		State                                      snapshot;
+		LinkIndex                                  link_index;
+		std::unordered_map<int, std::vector<int>>  mentioned_by;      // node id -> nodes whose next, responses or previous ids name it
+		std::unordered_map<int, std::vector<int>>  links_by_start;    // start attribute -> link ids
+		std::unordered_map<int, std::vector<int>>  links_by_end;      // end attribute -> link ids
+		std::set<int>                              node_ids, link_ids; // highest ids, for the counters' check
+		std::unordered_map<int, std::vector<ValidationIssue>> node_issues;
+		std::unordered_map<int, std::vector<ValidationIssue>> link_issues;
+		std::unordered_set<int>                    touched_nodes;
+		std::unordered_set<int>                    touched_links;
+		bool                                       full_pass = false; // after a reset, everything is touched already
+		size_t                                     nodes_checked = 0;
+		size_t                                     links_checked = 0;
+	};
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "callback_index.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace ede
+{
+	const std::set<int>& CallbackIndex::NodesWith(const std::string& callback) const
+	{
+		static const std::set<int> none;
+		auto it = nodes_by_callback.find(callback);
+		return it == nodes_by_callback.end() ? none : it->second;
+	}
+
+	// only the tags that came or went are touched, both sets are sorted
+	void CallbackIndex::SetNodeCallbacks(int node_id, const std::set<std::string>& callbacks)
+	{
+		std::set<std::string>& old_callbacks = callbacks_by_node[node_id];
+
+		std::vector<std::string> removed, added;
+		std::set_difference(old_callbacks.begin(), old_callbacks.end(), callbacks.begin(), callbacks.end(), std::back_inserter(removed));
+		std::set_difference(callbacks.begin(), callbacks.end(), old_callbacks.begin(), old_callbacks.end(), std::back_inserter(added));
+
+		for (const std::string& callback : removed) {
+			auto it = nodes_by_callback.find(callback);
+			if (it != nodes_by_callback.end()) {
+				it->second.erase(node_id);
+				if (it->second.empty()) {
+					nodes_by_callback.erase(it);
+				}
+			}
+		}
+		for (const std::string& callback : added) {
+			nodes_by_callback[callback].insert(node_id);
+		}
+
+		if (callbacks.empty()) {
+			callbacks_by_node.erase(node_id);
+		}
+		else {
+			old_callbacks = callbacks;
+		}
+	}
+
+	void CallbackIndex::OnStateReset(const State& state)
+	{
+		nodes_by_callback.clear();
+		callbacks_by_node.clear();
+		for (const auto& [id, node] : state.nodes) {
+			if (node && !node->selected_callbacks.empty()) {
+				SetNodeCallbacks(id, node->selected_callbacks);
+			}
+		}
+	}
+
+	void CallbackIndex::OnNodeAdded(const Node& node)
+	{
+		SetNodeCallbacks(node.id, node.selected_callbacks);
+	}
+
+	void CallbackIndex::OnNodeRemoved(int node_id)
+	{
+		SetNodeCallbacks(node_id, {});
+	}
+
+	void CallbackIndex::OnNodeChanged(const Node& node, NodeChange change)
+	{
+		if (change == NodeChange::Callbacks) {
+			SetNodeCallbacks(node.id, node.selected_callbacks);
+		}
+	}
+
+	// the nodes that used it were changed before the tag goes, this only drops what could be left
+	void CallbackIndex::OnCallbackRemoved(const std::string& callback)
+	{
+		auto it = nodes_by_callback.find(callback);
+		if (it == nodes_by_callback.end()) {
+			return;
+		}
+		for (int node_id : it->second) {
+			auto node = callbacks_by_node.find(node_id);
+			if (node != callbacks_by_node.end()) {
+				node->second.erase(callback);
+				if (node->second.empty()) {
+					callbacks_by_node.erase(node);
+				}
+			}
+		}
+		nodes_by_callback.erase(it);
+	}
+}
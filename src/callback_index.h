@@ -0,0 +1,46 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "state_listener.h"
+#include <set>
+#include <string>
+#include <unordered_map>
+
+/******************************************************************************
+ *                   Which nodes use each callback tag
+ *
+ *   The nodes' selected_callbacks, turned around: for every tag, the ids of
+ *   the nodes that carry it. Kept up to date from the editor's edits, a
+ *   node's tags are compared with what it had before so only the tags it
+ *   gained or lost are touched.
+ ******************************************************************************/
+
+namespace ede
+{
+	class CallbackIndex : public StateListener
+	{
+	public:
+		// sorted, empty for a tag no node uses or that doesn't exist
+		const std::set<int>& NodesWith(const std::string& callback) const;
+		size_t UseCount(const std::string& callback) const { return NodesWith(callback).size(); }
+
+		void OnStateReset(const State& state) override;
+		void OnNodeAdded(const Node& node) override;
+		void OnNodeRemoved(int node_id) override;
+		void OnNodeChanged(const Node& node, NodeChange change) override;
+		void OnCallbackRemoved(const std::string& callback) override;
+
+	private:
+		void SetNodeCallbacks(int node_id, const std::set<std::string>& callbacks);
+
+		std::unordered_map<std::string, std::set<int>> nodes_by_callback;
+		std::unordered_map<int, std::set<std::string>> callbacks_by_node; // what each node was last indexed with
+	};
+}
@@ -0,0 +1,224 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "dialogue_compiler.h"
+#include "dialogue_runtime.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+namespace ede
+{
+	namespace
+	{
+		// every string goes through here, so identical texts and callback names are stored once
+		class StringTable
+		{
+		public:
+			uint32_t Add(std::string_view str) {
+				auto it = indices.find(str);
+				if (it != indices.end()) {
+					return it->second;
+				}
+				uint32_t index = static_cast<uint32_t>(records.size());
+				records.push_back({ static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(str.size()) });
+				blob.insert(blob.end(), str.begin(), str.end());
+				blob.push_back('\0');
+				// keyed by the caller's string, which outlives the table (node texts may be lazy, see Node.h)
+				indices.emplace(str, index);
+				return index;
+			}
+
+			std::vector<runtime::StringRecord> records;
+			std::vector<char>                  blob;
+
+		private:
+			std::unordered_map<std::string_view, uint32_t> indices;
+		};
+
+		// the conversation starter: node 0 like everywhere in the editor. Without it, the speech node nothing
+		// leads to, the lowest id if there are several
+		const Node* FindRoot(const std::vector<const Node*>& by_id, const std::unordered_map<int, const Node*>& node_by_id) {
+			auto first = node_by_id.find(0);
+			if (first != node_by_id.end()) {
+				return first->second;
+			}
+			for (const Node* node : by_id) {
+				if (node->nodeType == NodeType::Speech && node->prevNodeIds.empty()) {
+					return node;
+				}
+			}
+			return by_id.empty() ? nullptr : by_id.front();
+		}
+
+		uint32_t Align4(uint32_t offset) {
+			return (offset + 3u) & ~3u;
+		}
+
+		template<typename T>
+		void Append(std::string& out, uint32_t offset, const T* data, size_t count) {
+			if (count > 0) {
+				std::memcpy(out.data() + offset, data, count * sizeof(T));
+			}
+		}
+	}
+
+	std::string CompileDialogue(const std::vector<Node>& nodes)
+	{
+		using namespace runtime;
+
+		std::unordered_map<int, const Node*> node_by_id;
+		std::vector<const Node*> by_id;
+		node_by_id.reserve(nodes.size());
+		by_id.reserve(nodes.size());
+		for (const Node& node : nodes) {
+			if (node_by_id.emplace(node.id, &node).second) {
+				by_id.push_back(&node);
+			}
+		}
+		std::sort(by_id.begin(), by_id.end(), [](const Node* a, const Node* b) { return a->id < b->id; });
+
+		/***************************************************
+		 *   Dense indices, in the order conversations go
+		 **************************************************/
+
+		// depth first from the root, responses before the next node, so a conversation reads forwards.
+		// nodes the root doesn't reach start their own walk, in id order
+		std::unordered_map<int, uint32_t> index_of;
+		std::vector<const Node*> order;
+		index_of.reserve(by_id.size());
+		order.reserve(by_id.size());
+
+		std::vector<const Node*> stack;
+		auto visit = [&](const Node* start) {
+			stack.push_back(start);
+			while (!stack.empty()) {
+				const Node* node = stack.back();
+				stack.pop_back();
+				if (!index_of.emplace(node->id, static_cast<uint32_t>(order.size())).second) {
+					continue;
+				}
+				order.push_back(node);
+
+				auto push = [&](int id) {
+					auto it = node_by_id.find(id);
+					if (it != node_by_id.end() && !index_of.contains(id)) {
+						stack.push_back(it->second);
+					}
+				};
+				push(node->nextNodeId);
+				for (auto it = node->responses.rbegin(); it != node->responses.rend(); ++it) {
+					push(*it);
+				}
+			}
+		};
+
+		const Node* root = FindRoot(by_id, node_by_id);
+		if (root != nullptr) {
+			visit(root);
+		}
+		for (const Node* node : by_id) {
+			if (!index_of.contains(node->id)) {
+				visit(node);
+			}
+		}
+
+		auto dense = [&](int id) {
+			auto it = index_of.find(id);
+			return it != index_of.end() ? it->second : NoNode;
+		};
+
+		/***************************************************
+		 *              Tables and CSR arrays
+		 **************************************************/
+
+		StringTable strings;
+
+		// callback ids follow the order callbacks are first met in
+		std::unordered_map<std::string_view, uint32_t> callback_ids;
+		std::vector<uint32_t> callback_names;
+
+		std::vector<NodeRecord> records;
+		std::vector<uint32_t> response_offsets, responses, callback_offsets, node_callbacks;
+		records.reserve(order.size());
+		response_offsets.reserve(order.size() + 1);
+		callback_offsets.reserve(order.size() + 1);
+
+		for (const Node* node : order) {
+			NodeRecord record{};
+			record.source_id = node->id;
+			record.flags = (node->nodeType == NodeType::Response ? NodeFlags_Response : NodeFlags_None)
+				| (node->expectesResponse ? NodeFlags_ExpectsResponse : NodeFlags_None);
+			record.text = strings.Add(node->TextView());
+			record.next = dense(node->nextNodeId);
+			records.push_back(record);
+
+			response_offsets.push_back(static_cast<uint32_t>(responses.size()));
+			for (int response : node->responses) {
+				uint32_t index = dense(response);
+				if (index != NoNode) {
+					responses.push_back(index);
+				}
+			}
+
+			callback_offsets.push_back(static_cast<uint32_t>(node_callbacks.size()));
+			for (const std::string& callback : node->selected_callbacks) {
+				auto [it, inserted] = callback_ids.emplace(callback, static_cast<uint32_t>(callback_names.size()));
+				if (inserted) {
+					callback_names.push_back(strings.Add(callback));
+				}
+				node_callbacks.push_back(it->second);
+			}
+		}
+		response_offsets.push_back(static_cast<uint32_t>(responses.size()));
+		callback_offsets.push_back(static_cast<uint32_t>(node_callbacks.size()));
+
+		/***************************************************
+		 *                      Layout
+		 **************************************************/
+
+		Header header{};
+		std::memcpy(header.magic, Magic, sizeof(Magic));
+		header.version = Version;
+		header.node_count = static_cast<uint32_t>(records.size());
+		header.response_count = static_cast<uint32_t>(responses.size());
+		header.node_callback_count = static_cast<uint32_t>(node_callbacks.size());
+		header.callback_count = static_cast<uint32_t>(callback_names.size());
+		header.string_count = static_cast<uint32_t>(strings.records.size());
+		header.string_blob_size = static_cast<uint32_t>(strings.blob.size());
+		header.root = records.empty() ? NoNode : 0;
+
+		uint32_t offset = sizeof(Header);
+		auto place = [&offset](uint32_t& field, size_t bytes) {
+			field = offset;
+			offset = Align4(offset + static_cast<uint32_t>(bytes));
+		};
+		place(header.node_table_offset, records.size() * sizeof(NodeRecord));
+		place(header.response_offsets_offset, response_offsets.size() * sizeof(uint32_t));
+		place(header.responses_offset, responses.size() * sizeof(uint32_t));
+		place(header.callback_offsets_offset, callback_offsets.size() * sizeof(uint32_t));
+		place(header.node_callbacks_offset, node_callbacks.size() * sizeof(uint32_t));
+		place(header.callback_names_offset, callback_names.size() * sizeof(uint32_t));
+		place(header.string_table_offset, strings.records.size() * sizeof(StringRecord));
+		place(header.string_blob_offset, strings.blob.size());
+		header.file_size = offset;
+
+		std::string out(offset, '\0');
+		Append(out, 0, &header, 1);
+		Append(out, header.node_table_offset, records.data(), records.size());
+		Append(out, header.response_offsets_offset, response_offsets.data(), response_offsets.size());
+		Append(out, header.responses_offset, responses.data(), responses.size());
+		Append(out, header.callback_offsets_offset, callback_offsets.data(), callback_offsets.size());
+		Append(out, header.node_callbacks_offset, node_callbacks.data(), node_callbacks.size());
+		Append(out, header.callback_names_offset, callback_names.data(), callback_names.size());
+		Append(out, header.string_table_offset, strings.records.data(), strings.records.size());
+		Append(out, header.string_blob_offset, strings.blob.data(), strings.blob.size());
+		return out;
+	}
+}
@@ -0,0 +1,23 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ *        Compiling the dialogue into the runtime format
+ ******************************************************************************/
+
+namespace ede
+{
+	// Flattens the nodes into the layout read by runtime::Dialogue (dialogue_runtime.h).
+	// Links to nodes that aren't in the list are dropped, like a dangling nextNodeId would be at runtime.
+	std::string CompileDialogue(const std::vector<Node>& nodes);
+}
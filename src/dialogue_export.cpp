@@ -0,0 +1,111 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "dialogue_export.h"
+#include "dialogue_compiler.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace ede
+{
+	const char* ExportEncodingName(ExportEncoding encoding)
+	{
+		switch (encoding) {
+		case ExportEncoding::PrettyJson:   return "JSON";
+		case ExportEncoding::MinifiedJson: return "Minified JSON";
+		case ExportEncoding::Cbor:         return "CBOR";
+		case ExportEncoding::MessagePack:  return "MessagePack";
+		case ExportEncoding::Ubjson:       return "UBJSON";
+		case ExportEncoding::Compiled:     return "Compiled dialogue";
+		default:                           return "Unknown";
+		}
+	}
+
+	namespace
+	{
+		// Whether the file at path already reads back as contents. Text mode undoes the line ending
+		// translation a text mode write did, so json exports compare equal on Windows too
+		bool FileHolds(const std::string& path, const std::string& contents, bool text_mode)
+		{
+			std::FILE* file = std::fopen(path.c_str(), text_mode ? "r" : "rb");
+			if (file == nullptr) {
+				return false;
+			}
+			std::string existing;
+			existing.resize(contents.size() + 1); // one more, to notice a longer file
+			size_t read = std::fread(existing.data(), 1, existing.size(), file);
+			std::fclose(file);
+			return read == contents.size() && std::memcmp(existing.data(), contents.data(), read) == 0;
+		}
+	}
+
+	std::string EncodeDialogue(const std::vector<Node>& nodes, ExportEncoding encoding)
+	{
+		if (encoding == ExportEncoding::Compiled) {
+			return CompileDialogue(nodes);
+		}
+
+		// the editor hands the nodes over in hash map order, sorting them keeps exports of the same dialogue identical
+		std::vector<const Node*> by_id;
+		by_id.reserve(nodes.size());
+		for (const Node& node : nodes) {
+			by_id.push_back(&node);
+		}
+		std::sort(by_id.begin(), by_id.end(), [](const Node* a, const Node* b) { return a->id < b->id; });
+
+		nlohmann::json j;
+		for (const Node* node : by_id) {
+			j.push_back(*node);
+		}
+
+		// the binary encoders write straight into the string instead of returning a temporary vector
+		std::string encoded;
+		switch (encoding) {
+		case ExportEncoding::PrettyJson:   encoded = j.dump(4); break;
+		case ExportEncoding::MinifiedJson: encoded = j.dump(); break;
+		case ExportEncoding::Cbor:         nlohmann::json::to_cbor(j, encoded); break;
+		case ExportEncoding::MessagePack:  nlohmann::json::to_msgpack(j, encoded); break;
+		case ExportEncoding::Ubjson:       nlohmann::json::to_ubjson(j, encoded); break;
+		default: break;
+		}
+		return encoded;
+	}
+
+	bool ExportDialogue(const std::vector<Node>& nodes, ExportEncoding encoding, const std::string& path, ExportReport* report)
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::string encoded = EncodeDialogue(nodes, encoding);
+		double encode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (report != nullptr) {
+			report->size_bytes = encoded.size();
+			report->encode_ms = encode_ms;
+			report->unchanged = false;
+		}
+
+		// the JSON encodings keep being written in text mode, like they always were
+		bool is_json = encoding == ExportEncoding::PrettyJson || encoding == ExportEncoding::MinifiedJson;
+		if (FileHolds(path, encoded, is_json)) {
+			if (report != nullptr) {
+				report->unchanged = true;
+			}
+			return true;
+		}
+
+		std::FILE* file = std::fopen(path.c_str(), is_json ? "w" : "wb");
+		if (file == nullptr) {
+			return false;
+		}
+		bool success = std::fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+		success = std::fclose(file) == 0 && success;
+		return success;
+	}
+}
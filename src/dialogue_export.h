@@ -0,0 +1,49 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ *          Encoding the dialogue the game loads at runtime
+ ******************************************************************************/
+
+namespace ede
+{
+	// keep in the same order as the export dialog's file types
+	enum class ExportEncoding
+	{
+		PrettyJson,
+		MinifiedJson,
+		Cbor,
+		MessagePack,
+		Ubjson,
+		Compiled, // runtime format, see dialogue_runtime.h
+		Count
+	};
+
+	const char* ExportEncodingName(ExportEncoding encoding);
+
+	struct ExportReport
+	{
+		size_t size_bytes = 0;
+		double encode_ms = 0.0; // building the document and encoding it, without the file write
+		bool   unchanged = false; // the file already held exactly this export and wasn't written
+	};
+
+	// Encodes the nodes in the export layout (id, nodeType, text, nextNodeId, responses, selected_callbacks),
+	// in id order whatever order they're given in. PrettyJson is the layout the export always had,
+	// Compiled has its own (dialogue_compiler.h).
+	std::string EncodeDialogue(const std::vector<Node>& nodes, ExportEncoding encoding);
+
+	// Encodes and writes the nodes to path, filling report (if given) with the size and encode time.
+	// A file that already holds the same bytes is left untouched, so tools watching its timestamp don't rebuild
+	bool ExportDialogue(const std::vector<Node>& nodes, ExportEncoding encoding, const std::string& path, ExportReport* report = nullptr);
+}
@@ -0,0 +1,265 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/******************************************************************************
+ *        Compiled dialogue, the format games read at runtime
+ *
+ *   Self-contained on purpose: copy this header into the game, load the
+ *   exported file into memory (or map it) and wrap it in a Dialogue.
+ *   Nothing is parsed, copied or allocated; every lookup is an index
+ *   into one of the arrays below.
+ *
+ *   [Header][NodeRecord * node_count]
+ *   [uint32 response_offsets * (node_count + 1)][uint32 responses * response_count]
+ *   [uint32 callback_offsets * (node_count + 1)][uint32 node_callbacks * node_callback_count]
+ *   [uint32 callback_names * callback_count]
+ *   [StringRecord * string_count][string blob]
+ *
+ *   Nodes are renumbered 0..node_count-1 in the order a conversation walks
+ *   them, starting at the root, so following a conversation reads memory
+ *   mostly forwards. Responses and callbacks of node i are the slices
+ *   [offsets[i], offsets[i + 1]) of their arrays (CSR). Callbacks are ids
+ *   into callback_names, identical strings are stored once.
+ *   Everything is little-endian and 4-byte aligned.
+ ******************************************************************************/
+
+namespace ede
+{
+	namespace runtime
+	{
+		constexpr char     Magic[4] = { 'E', 'D', 'E', 'C' };
+		constexpr uint32_t Version = 1;
+		constexpr const char* Extension = ".edec";
+
+		// next node of a node that ends the conversation
+		constexpr uint32_t NoNode = 0xFFFFFFFFu;
+
+		enum NodeFlags : uint32_t
+		{
+			NodeFlags_None = 0,
+			NodeFlags_Response = 1 << 0,        // a player's answer, otherwise spoken by the NPC
+			NodeFlags_ExpectsResponse = 1 << 1, // the player picks one of the responses to go on
+		};
+
+		struct Header
+		{
+			char     magic[4];
+			uint32_t version;
+			uint32_t file_size;
+			uint32_t node_count;
+			uint32_t response_count;
+			uint32_t node_callback_count;
+			uint32_t callback_count;
+			uint32_t string_count;
+			uint32_t string_blob_size;
+			uint32_t root; // index of the conversation starter, NoNode for an empty dialogue
+			uint32_t node_table_offset;
+			uint32_t response_offsets_offset;
+			uint32_t responses_offset;
+			uint32_t callback_offsets_offset;
+			uint32_t node_callbacks_offset;
+			uint32_t callback_names_offset;
+			uint32_t string_table_offset;
+			uint32_t string_blob_offset;
+		};
+
+		struct NodeRecord
+		{
+			int32_t  source_id; // id the node had in the editor, handy when debugging a conversation
+			uint32_t flags;     // NodeFlags
+			uint32_t text;      // string index
+			uint32_t next;      // node index or NoNode
+		};
+
+		struct StringRecord
+		{
+			uint32_t offset; // into the string blob
+			uint32_t length; // without the NUL terminator
+		};
+
+		static_assert(sizeof(Header) == 72);
+		static_assert(sizeof(NodeRecord) == 16);
+		static_assert(sizeof(StringRecord) == 8);
+
+		// [begin, end) over one node's responses or callback ids
+		struct IndexRange
+		{
+			const uint32_t* first = nullptr;
+			const uint32_t* last = nullptr;
+
+			const uint32_t* begin() const { return first; }
+			const uint32_t* end() const { return last; }
+			uint32_t        size() const { return static_cast<uint32_t>(last - first); }
+			bool            empty() const { return first == last; }
+			uint32_t        operator[](uint32_t i) const { return first[i]; }
+		};
+
+		// Read-only view over a compiled dialogue. The memory must stay alive and unchanged while the view is used.
+		class Dialogue
+		{
+		public:
+			// Checks the header and that every section and index stays inside the buffer, which must be 4-byte aligned.
+			// Indices are only checked once here, the accessors below trust them.
+			bool Load(const void* data, size_t size) {
+				*this = {};
+				if (data == nullptr || size < sizeof(Header) || reinterpret_cast<uintptr_t>(data) % alignof(Header) != 0) {
+					return false;
+				}
+				const char* bytes = static_cast<const char*>(data);
+				const Header* h = reinterpret_cast<const Header*>(bytes);
+				if (std::memcmp(h->magic, Magic, sizeof(Magic)) != 0 || h->version != Version || h->file_size > size) {
+					return false;
+				}
+
+				const uint64_t offsets_count = uint64_t(h->node_count) + 1;
+				if (!Section(h, h->node_table_offset, uint64_t(h->node_count) * sizeof(NodeRecord))
+					|| !Section(h, h->response_offsets_offset, offsets_count * sizeof(uint32_t))
+					|| !Section(h, h->responses_offset, uint64_t(h->response_count) * sizeof(uint32_t))
+					|| !Section(h, h->callback_offsets_offset, offsets_count * sizeof(uint32_t))
+					|| !Section(h, h->node_callbacks_offset, uint64_t(h->node_callback_count) * sizeof(uint32_t))
+					|| !Section(h, h->callback_names_offset, uint64_t(h->callback_count) * sizeof(uint32_t))
+					|| !Section(h, h->string_table_offset, uint64_t(h->string_count) * sizeof(StringRecord))
+					|| !Section(h, h->string_blob_offset, h->string_blob_size)) {
+					return false;
+				}
+
+				Dialogue view;
+				view.header = h;
+				view.nodes = reinterpret_cast<const NodeRecord*>(bytes + h->node_table_offset);
+				view.response_offsets = reinterpret_cast<const uint32_t*>(bytes + h->response_offsets_offset);
+				view.responses = reinterpret_cast<const uint32_t*>(bytes + h->responses_offset);
+				view.callback_offsets = reinterpret_cast<const uint32_t*>(bytes + h->callback_offsets_offset);
+				view.node_callbacks = reinterpret_cast<const uint32_t*>(bytes + h->node_callbacks_offset);
+				view.callback_names = reinterpret_cast<const uint32_t*>(bytes + h->callback_names_offset);
+				view.strings = reinterpret_cast<const StringRecord*>(bytes + h->string_table_offset);
+				view.blob = bytes + h->string_blob_offset;
+				if (!view.Validate()) {
+					return false;
+				}
+				*this = view;
+				return true;
+			}
+
+			bool     IsLoaded() const { return header != nullptr; }
+			uint32_t NodeCount() const { return header->node_count; }
+			uint32_t Root() const { return header->root; }
+
+			std::string_view Text(uint32_t node) const { return String(nodes[node].text); }
+			uint32_t         Next(uint32_t node) const { return nodes[node].next; }
+			int32_t          SourceId(uint32_t node) const { return nodes[node].source_id; }
+			bool             IsResponse(uint32_t node) const { return (nodes[node].flags & NodeFlags_Response) != 0; }
+			bool             ExpectsResponse(uint32_t node) const { return (nodes[node].flags & NodeFlags_ExpectsResponse) != 0; }
+
+			IndexRange Responses(uint32_t node) const {
+				return { responses + response_offsets[node], responses + response_offsets[node + 1] };
+			}
+
+			// callback ids, see CallbackName()
+			IndexRange Callbacks(uint32_t node) const {
+				return { node_callbacks + callback_offsets[node], node_callbacks + callback_offsets[node + 1] };
+			}
+
+			uint32_t         CallbackCount() const { return header->callback_count; }
+			std::string_view CallbackName(uint32_t callback) const { return String(callback_names[callback]); }
+
+			// Linear in the number of callbacks, resolve the ids a game cares about once after loading
+			uint32_t FindCallback(std::string_view name) const {
+				for (uint32_t i = 0; i < header->callback_count; i++) {
+					if (CallbackName(i) == name) {
+						return i;
+					}
+				}
+				return NoNode;
+			}
+
+			bool HasCallback(uint32_t node, uint32_t callback) const {
+				for (uint32_t id : Callbacks(node)) {
+					if (id == callback) {
+						return true;
+					}
+				}
+				return false;
+			}
+
+			// NUL-terminated, data() can go straight to C APIs
+			std::string_view String(uint32_t string) const {
+				return std::string_view(blob + strings[string].offset, strings[string].length);
+			}
+
+		private:
+			static bool Section(const Header* h, uint64_t offset, uint64_t size) {
+				return offset % 4 == 0 && offset <= h->file_size && size <= h->file_size - offset;
+			}
+
+			bool CheckOffsets(const uint32_t* offsets, uint32_t count) const {
+				if (offsets[0] != 0 || offsets[header->node_count] != count) {
+					return false;
+				}
+				for (uint32_t i = 0; i < header->node_count; i++) {
+					if (offsets[i] > offsets[i + 1]) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+			bool Validate() const {
+				const Header* h = header;
+				if (h->root != NoNode && h->root >= h->node_count) {
+					return false;
+				}
+				for (uint32_t i = 0; i < h->string_count; i++) {
+					const StringRecord& s = strings[i];
+					if (s.offset >= h->string_blob_size || s.length >= h->string_blob_size - s.offset || blob[s.offset + s.length] != '\0') {
+						return false;
+					}
+				}
+				for (uint32_t i = 0; i < h->node_count; i++) {
+					if (nodes[i].text >= h->string_count || (nodes[i].next != NoNode && nodes[i].next >= h->node_count)) {
+						return false;
+					}
+				}
+				if (!CheckOffsets(response_offsets, h->response_count) || !CheckOffsets(callback_offsets, h->node_callback_count)) {
+					return false;
+				}
+				for (uint32_t i = 0; i < h->response_count; i++) {
+					if (responses[i] >= h->node_count) {
+						return false;
+					}
+				}
+				for (uint32_t i = 0; i < h->node_callback_count; i++) {
+					if (node_callbacks[i] >= h->callback_count) {
+						return false;
+					}
+				}
+				for (uint32_t i = 0; i < h->callback_count; i++) {
+					if (callback_names[i] >= h->string_count) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+			const Header*       header = nullptr;
+			const NodeRecord*   nodes = nullptr;
+			const uint32_t*     response_offsets = nullptr;
+			const uint32_t*     responses = nullptr;
+			const uint32_t*     callback_offsets = nullptr;
+			const uint32_t*     node_callbacks = nullptr;
+			const uint32_t*     callback_names = nullptr;
+			const StringRecord* strings = nullptr;
+			const char*         blob = nullptr;
+		};
+	}
+}
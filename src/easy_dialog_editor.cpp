@@ -16,11 +16,30 @@
 #include "Node.h"
 #include "Utils.h"
 #include "show_windows.h"
+#include "state_operations.h"
+#include "background_save.h"
+#include "operation_journal.h"
+#include "state_listener.h"
+#include "project.h"
+#include "progressive_load.h"
+#include "state_hash.h"
+#include "reachability.h"
+#include "path_analysis.h"
+#include "background_validation.h"
+#include "text_search.h"
+#include "callback_index.h"
+#include "graph_layout.h"
+#include "force_layout.h"
+#include "graph_stats.h"
 #include <unordered_map>
 #include <imgui_internal.h>
 #include <format>
 #include <nlohmann/json.hpp>
 #include <set>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <optional>
 
 #define LOG(x) std::cout << x << std::endl;
 
@@ -34,6 +53,15 @@ namespace ede
 	// makes the 'StoryTellerNodeEditor editor' instance global in this cpp file only
 	namespace
 	{
+		// one conversation loaded in the editor, with its own imnodes context (positions, panning, selection)
+		struct Document
+		{
+			std::string           path;              // empty until saved
+			State                 state;             // parked here while another document is shown
+			ImNodesEditorContext* context = nullptr;
+			uint64_t              hash = 0;          // content hash of state while it's parked, see state_hash.h
+			std::optional<uint64_t> saved_hash;      // content hash of what its file holds, none until it has one
+		};
 
 		class EasyDialogEditor
 		{
@@ -43,9 +71,74 @@ namespace ede
 			State current_state;
 			static const char* NodeTypeStrings[];
 			bool bShowDemoWindow, bShowAboutSection, bShowCreateNodeTooltip, bShowHowToUseWindow,
-				bShowPopupNotif, bShowNewFilePopup, temp_file_saved;
-			const char* current_notification_title = "";
-			const char* current_notification_description = "";
+				bShowPopupNotif, bShowNewFilePopup;
+			// owned copies, callers are free to pass temporary strings
+			std::string current_notification_title;
+			std::string current_notification_description;
+
+			// saves run on a worker thread, see background_save.h. Each writes a snapshot sharing the nodes that
+			// didn't change since the previous one, like the journal's compactions
+			BackgroundSaver saver;
+			SnapshotCache snapshots;
+			SaveResult last_save;
+			double last_save_finished_time = -1.0;
+			bool last_save_skipped = false; // the file already held the state, nothing was written
+
+			// everything that wants to hear about edits, see state_listener.h
+			StateListenerList listeners;
+			OperationJournal journal;
+			std::string document_path; // file the conversation was last saved to or loaded from, empty if never
+
+			// documents[0] is the standalone conversation, the others were opened from the project.
+			// current_state is the active document's state, the others are parked in their Document
+			Project project;
+			std::vector<Document> documents;
+			int active_document = 0;
+			int select_document_tab = -1;
+			ImNodesEditorContext* saving_context = nullptr; // document the running background save belongs to
+			// edits keep the active document's hash current, comparing it with the saved one
+			// tells whether there's anything to save
+			ContentHasher content_hash;
+			uint64_t saving_hash = 0; // hash of the snapshot the running background save writes
+			// nodes the root doesn't lead to, kept up to date by every connection change, see reachability.h
+			ReachabilityTracker reachability;
+			// loops and playthroughs, worked out again only after a connection changes, see path_analysis.h
+			PathAnalyzer path_analyzer;
+			// checks the edited parts of the state on a worker thread, see background_validation.h
+			BackgroundValidator validator;
+			bool bShowIssuesWindow = false;
+
+			// searching the node texts, see text_search.h. The last result is kept until the query or a text changes
+			TextSearchIndex text_search;
+			std::string last_search_query;
+			uint64_t last_search_version = 0;
+			SearchResult last_search;
+			bool bShowSearchWindow = false;
+			bool focus_search_input = false;
+			ImVec2 canvas_size = ImVec2(0.0f, 0.0f); // of the node editor, as of the last frame
+
+			// which nodes carry each callback tag, see callback_index.h. Nodes with a tag of the filter stand out on the canvas,
+			// or every other node fades away
+			CallbackIndex callback_index;
+			std::set<std::string> callback_filter;
+			bool callback_filter_fades_others = false;
+
+			// Force directed layout, see force_layout.h. Its positions are shown every frame and reach the state once it
+			// settles or is stopped, the way a drag only commits when it ends
+			ForceLayout force_layout;
+			std::vector<std::pair<int, ImVec2>> force_layout_positions;
+			std::set<int> pinned_nodes; // the force layout leaves them where they are
+
+			// the sidebar's counts, see graph_stats.h
+			GraphStatsTracker graph_stats;
+
+			bool bShowProjectWindow = false;
+
+			// loads run on a worker thread and reach the canvas a batch at a time, see progressive_load.h.
+			// The conversation is read-only until the last batch is in
+			ProgressiveLoader loader;
+			bool loading = false;
+			State state_before_load; // brought back if the load fails or is canceled
 
 		public:
 
@@ -54,14 +147,14 @@ namespace ede
 			{
 
 				if (bShowPopupNotif) {
-					ImGui::OpenPopup(current_notification_title);
+					ImGui::OpenPopup(current_notification_title.c_str());
 
 					ImVec2 center = ImGui::GetMainViewport()->GetCenter();
 					ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
 
-					if (ImGui::BeginPopupModal(current_notification_title, &bShowPopupNotif, ImGuiWindowFlags_AlwaysAutoResize))
+					if (ImGui::BeginPopupModal(current_notification_title.c_str(), &bShowPopupNotif, ImGuiWindowFlags_AlwaysAutoResize))
 					{
-						ImGui::Text(current_notification_description);
+						ImGui::TextUnformatted(current_notification_description.c_str());
 						if (ImGui::Button("Ok", ImVec2(50.0f, 0.0f))) {
 							bShowPopupNotif = false;
 						}
@@ -79,9 +172,15 @@ namespace ede
 						ImGui::Text("Are you sure you want to start a new file?");
 						ImGui::Text("Don't forget to save your work!");
 
-						if (!temp_file_saved) {
+						// a save only starts here, the button follows what's actually on the disk
+						if (saver.IsBusy()) {
+							ImGui::BeginDisabled();
+							ImGui::Button("Saving...");
+							ImGui::EndDisabled();
+						}
+						else if (HasUnsavedChanges(active_document)) {
 							if (ImGui::Button("Save Current File")) {
-								ede::FileDialogs::SaveStateJson(&temp_file_saved);
+								ede::FileDialogs::SaveStateJson();
 							}
 						}
 						else {
@@ -91,10 +190,12 @@ namespace ede
 						}
 						ImGui::SameLine();
 						if (ImGui::Button("Proceed")) {
-							current_state = {};
+							// project conversations keep their tabs, the new file replaces the standalone one
+							ActivateDocument(0);
+							SetState(State{});
+							SetDocumentPath("");
 							// Add new root node
-							InitializeConversation();
-							temp_file_saved = false;
+							AddRootNode();
 							bShowNewFilePopup = false;
 						}
 						ImGui::EndPopup();
@@ -152,28 +253,66 @@ namespace ede
 					ede::ShowHowToUseGuide(&bShowHowToUseWindow);
 				}
 
-				HandleNodeRemoval();
+				if (bShowProjectWindow && project.IsOpen()) {
+					ede::ShowProjectWindow(&bShowProjectWindow);
+				}
+
+				if (bShowIssuesWindow) {
+					ede::ShowIssuesWindow(&bShowIssuesWindow);
+				}
+
+				if (bShowSearchWindow) {
+					ede::ShowSearchWindow(&bShowSearchWindow, focus_search_input);
+					focus_search_input = false;
+				}
+
+				if (documents.size() > 1) {
+					ShowDocumentTabs();
+				}
+
+				ReceiveLoadedNodes();
+
+				if (!loading) {
+					HandleNodeRemoval();
+				}
+
+				UpdateForceLayout();
+
+				// a loaded or switched to state may not have the filtered tags anymore
+				std::erase_if(callback_filter, [this](const std::string& callback) { return !current_state.callbacks.contains(callback); });
 
+				canvas_size = ImGui::GetContentRegionAvail();
 				ImNodes::BeginNodeEditor();
 
 				/******************************************************************************
 				 *             Draw every node and link from current state
 				 ******************************************************************************/
 				{
+					ImGui::BeginDisabled(loading);
 					for (const auto& pair : current_state.nodes)
 					{
 						std::shared_ptr<Node> node = pair.second;
 						if (node) {
-							std::string header_text = std::format("{} | id: {}", NodeTypeStrings[node->nodeType], node->id);
-							DrawNode(node->id, header_text.c_str());
+							std::string header_text = std::format("{} | id: {}{}", NodeTypeStrings[node->nodeType], node->id,
+								pinned_nodes.contains(node->id) ? " | pinned" : "");
+							DrawNode(node, header_text.c_str());
 						}
 					}
+					ImGui::EndDisabled();
 
 					for (const auto& pair : current_state.links)
 					{
 						std::shared_ptr<Link> link = pair.second;
 						if (link) {
+							// a link fades with the node it leads to
+							const bool faded = IsFadedByFilter(static_cast<int>(static_cast<uint32_t>(link->end_attr) >> 8));
+							if (faded) {
+								ImNodes::PushColorStyle(ImNodesCol_Link, IM_COL32(61, 133, 224, 40));
+							}
 							ImNodes::Link(link->id, link->start_attr, link->end_attr);
+							if (faded) {
+								ImNodes::PopColorStyle();
+							}
 						}
 					}
 				}
@@ -182,6 +321,11 @@ namespace ede
 
 				ImNodes::EndNodeEditor();
 
+				// positions only reach the state when a drag ends, a moving node would flood the listeners
+				if (ImNodes::IsSelectionDragCommitted() && !loading) {
+					SyncSelectedNodePositions();
+				}
+
 				/***************************************************
 				 *                   Handle links
 				 **************************************************/
@@ -189,10 +333,12 @@ namespace ede
 				int start_attr, end_attr;
 				if (ImNodes::IsLinkCreated(&start_attr, &end_attr))
 				{
-					HandleLinkManualCreation(start_attr, end_attr);
+					if (!loading) {
+						HandleLinkManualCreation(start_attr, end_attr);
+					}
 					bShowCreateNodeTooltip = false;
 				}
-				else {
+				else if (!loading) {
 					HandleLinkDropped();
 				}
 
@@ -203,6 +349,230 @@ namespace ede
 				ImGui::End();
 
 				ede::ShowGraphInfoWindow();
+
+				ShowSaveStatus();
+				ShowLoadStatus();
+
+				// a half loaded conversation is never journaled, the journal keeps the previous one until the load completes
+				if (!loading) {
+					journal.Flush(snapshots, current_state);
+					validator.Update();
+					text_search.Update();
+					graph_stats.Update();
+				}
+			}
+
+			// Starts reading path on the loader's thread. The current conversation is set aside,
+			// the loaded one replaces it on the canvas as its nodes come in
+			void LoadStateInBackground(const std::string& path) {
+				ResetForceLayout();
+				if (!loading) {
+					SyncNodePositions(current_state);
+					state_before_load = std::move(current_state);
+				}
+				current_state = {};
+				ImNodes::ClearNodeSelection();
+				ImNodes::ClearLinkSelection();
+				loader.Start(path);
+				loading = true;
+			}
+
+			bool IsLoading() const {
+				return loading;
+			}
+
+			bool HasUnsavedChanges() const {
+				return HasUnsavedChanges(active_document);
+			}
+
+			const std::string& GetDocumentPath() const {
+				return document_path;
+			}
+
+			// stops the running load and brings the conversation from before it back
+			void CancelLoad() {
+				if (!loading) {
+					return;
+				}
+				loader.Cancel();
+				loading = false;
+				current_state = std::move(state_before_load);
+				state_before_load = {};
+				PlaceLoadedNodes();
+			}
+
+			// Moves the published batches onto the canvas, within a few milliseconds per frame
+			// so the editor stays responsive however big the file is
+			void ReceiveLoadedNodes() {
+				if (!loading) {
+					return;
+				}
+				const auto frame_budget = std::chrono::milliseconds(4);
+				const auto start = std::chrono::steady_clock::now();
+				State batch;
+				while (std::chrono::steady_clock::now() - start < frame_budget && loader.TakeBatch(batch)) {
+					for (auto& pair : batch.nodes) {
+						if (pair.second) {
+							ImNodes::SetNodeGridSpacePos(pair.first, pair.second->position);
+						}
+					}
+					current_state.nodes.merge(batch.nodes);
+					current_state.links.merge(batch.links);
+					current_state.callbacks.merge(batch.callbacks);
+					current_state.next_node_id = std::max(current_state.next_node_id, batch.next_node_id);
+					current_state.next_link_id = std::max(current_state.next_link_id, batch.next_link_id);
+					if (batch.text_storage) {
+						current_state.text_storage = std::move(batch.text_storage);
+						current_state.text_storage_path = std::move(batch.text_storage_path);
+					}
+				}
+
+				LoadResult result;
+				if (!loader.PollFinished(result)) {
+					return;
+				}
+				if (!result.success) {
+					CancelLoad();
+					if (!result.canceled) {
+						RequestNotification("Could not load the state", "Could not read the data from the file. \nMaybe you chose the wrong file or it's corrupted.\n\n" + result.error);
+					}
+					return;
+				}
+				loading = false;
+				state_before_load = {};
+				listeners.OnStateReset(current_state);
+				documents[active_document].saved_hash = content_hash.Hash();
+				SetDocumentPath(result.path);
+			}
+
+			// progress of the running load with a way out, bottom center so it doesn't cover the save status
+			void ShowLoadStatus() {
+				if (!loading) {
+					return;
+				}
+				ImGuiViewport* viewport = ImGui::GetMainViewport();
+				ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x * 0.5f, viewport->WorkPos.y + viewport->WorkSize.y - 10.0f),
+					ImGuiCond_Always, ImVec2(0.5f, 1.0f));
+				ImGui::SetNextWindowViewport(viewport->ID);
+				ImGui::SetNextWindowBgAlpha(0.8f);
+				ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings |
+					ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoDocking;
+
+				if (ImGui::Begin("##LoadStatus", nullptr, flags)) {
+					ImGui::ProgressBar(loader.Progress(), ImVec2(200.0f, 0.0f), "Loading...");
+					ImGui::SameLine();
+					if (ImGui::Button("Cancel")) {
+						CancelLoad();
+					}
+					ImGui::Text("%zu nodes so far, read-only until the load completes", current_state.nodes.size());
+				}
+				ImGui::End();
+			}
+
+			// starts writing a snapshot of the current state to path on the saver's thread
+			bool SaveStateInBackground(const std::string& path) {
+				if (saver.IsBusy() || loading) {
+					return false;
+				}
+
+				// nothing changed since the file was written, saving again would write the same bytes
+				SyncNodePositions(current_state);
+				std::error_code ec;
+				if (!HasUnsavedChanges(active_document) && !document_path.empty() && std::filesystem::equivalent(path, document_path, ec)) {
+					last_save = {};
+					last_save.success = true;
+					last_save.path = path;
+					last_save_skipped = true;
+					last_save_finished_time = ImGui::GetTime();
+					return true;
+				}
+
+				// Windows won't replace a file that's still mapped, bring the lazy texts in before overwriting their file.
+				// The scans reading them in the background keep it mapped until they're done
+				if (current_state.text_storage && std::filesystem::equivalent(path, current_state.text_storage_path, ec)) {
+					text_search.Update(/*wait=*/true);
+					graph_stats.Update(/*wait=*/true);
+					MaterializeAllText(current_state);
+					snapshots.Invalidate();
+				}
+
+				if (!saver.Start(snapshots.Take(current_state), path)) {
+					return false;
+				}
+				saving_context = documents[active_document].context;
+				saving_hash = content_hash.Hash();
+				last_save_skipped = false;
+				return true;
+			}
+
+			// positions only live in imnodes while editing, bring the nodes of the current context's state up to date.
+			// Moved nodes are reported, a save writes their new position. They're in grid space, panning moves none
+			void SyncNodePositions(State& state) {
+				for (const auto& pair : state.nodes) {
+					std::shared_ptr<Node> node = pair.second;
+					if (node) {
+						const ImVec2 position = ImNodes::GetNodeGridSpacePos(node->id);
+						if (position.x != node->position.x || position.y != node->position.y) {
+							node->position = position;
+							listeners.OnNodeChanged(*node, NodeChange::Position);
+						}
+					}
+				}
+			}
+
+			// the document differs from its file, or was never saved
+			bool HasUnsavedChanges(int index) const {
+				const Document& document = documents[index];
+				const uint64_t hash = index == active_document ? content_hash.Hash() : document.hash;
+				return !document.saved_hash || *document.saved_hash != hash;
+			}
+
+			// takes the outcome of a background save that finished. Returns false if it failed
+			bool CollectFinishedSave() {
+				if (!saver.PollFinished(last_save)) {
+					return true;
+				}
+				last_save_finished_time = ImGui::GetTime();
+				if (!last_save.success) {
+					RequestNotification("Save failed", "Could not save your work:\n" + last_save.error);
+					return false;
+				}
+				FinishSave();
+				return true;
+			}
+
+			// Small overlay in the bottom left corner while a save runs, and for a moment after it finishes.
+			// Failures go through the notification popup, a modal on every successful Ctrl+S would get in the way of editing.
+			void ShowSaveStatus() {
+				CollectFinishedSave();
+
+				const double status_duration = 2.0;
+				bool show_finished = last_save.success && last_save_finished_time >= 0.0 &&
+					ImGui::GetTime() - last_save_finished_time < status_duration;
+				if (!saver.IsBusy() && !show_finished) {
+					return;
+				}
+
+				ImGuiViewport* viewport = ImGui::GetMainViewport();
+				ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + 10.0f, viewport->WorkPos.y + viewport->WorkSize.y - 10.0f),
+					ImGuiCond_Always, ImVec2(0.0f, 1.0f));
+				ImGui::SetNextWindowViewport(viewport->ID);
+				ImGui::SetNextWindowBgAlpha(0.8f);
+				ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_AlwaysAutoResize |
+					ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoDocking;
+
+				if (ImGui::Begin("##SaveStatus", nullptr, flags)) {
+					if (saver.IsBusy()) {
+						ImGui::ProgressBar(saver.Progress(), ImVec2(200.0f, 0.0f), "Saving...");
+					}
+					else if (last_save_skipped) {
+						ImGui::TextUnformatted("Nothing changed since the last save");
+					}
+					else {
+						ImGui::Text("Saved in %.0f ms", last_save.duration_ms);
+					}
+				}
+				ImGui::End();
 			}
 
 			// executed if user link two already existing nodes
@@ -210,28 +580,35 @@ namespace ede
 			{
 				int start_node_id = start_attr >> NodePartShift::EndPin;
 				int end_node_id = end_attr >> NodePartShift::InputPin;
-				std::shared_ptr<Node> start_node = current_state.nodes[start_node_id];
-				std::shared_ptr<Node> end_node = current_state.nodes[end_node_id];
+				std::shared_ptr<Node> start_node = current_state.FindNode(start_node_id);
+				std::shared_ptr<Node> end_node = current_state.FindNode(end_node_id);
+
+				if (!start_node || !end_node) {
+					return;
+				}
 
 				if (start_node->nextNodeId != -1 && !start_node->expectesResponse
 					|| (start_node->nodeType == NodeType::Response && end_node->nodeType == NodeType::Response)) {
 					return;
 				}
 
-				if (start_node->nodeType == NodeType::Speech) {
-					if (end_node->nodeType == NodeType::Response) {
-						if (!start_node->expectesResponse) {
-							return;
-						}
-						start_node->responses.push_back(end_node_id);
-
+				// a response is one of the speech's answers, not what comes next, same rule RebuildConnections follows
+				if (start_node->nodeType == NodeType::Speech && end_node->nodeType == NodeType::Response) {
+					if (!start_node->expectesResponse) {
+						return;
 					}
+					start_node->responses.push_back(end_node_id);
+				}
+				else {
+					start_node->nextNodeId = end_node_id;
 				}
-				start_node->nextNodeId = end_node_id;
 				end_node->prevNodeIds.push_back(start_node_id);
 				std::shared_ptr<Link> link = std::make_shared<Link>(++current_state.next_link_id, start_attr, end_attr);
 				current_state.links[link->id] = link;
 
+				listeners.OnLinkAdded(*link);
+				listeners.OnNodeChanged(*start_node, NodeChange::Connections);
+				listeners.OnNodeChanged(*end_node, NodeChange::Connections);
 			}
 
 			// create new node when dropping a link on empty space
@@ -246,24 +623,28 @@ namespace ede
 						return;
 					}
 					LOG("linked dropped");
-					std::shared_ptr<Node> start_node = current_state.nodes[started_attr >> NodePartShift::EndPin];
-					
-					if (start_node)
+					std::shared_ptr<Node> start_node = current_state.FindNode(started_attr >> NodePartShift::EndPin);
+					if (!start_node) {
+						return;
+					}
+
+
+					if (start_node->expectesResponse)
 					{
-						if (start_node->expectesResponse)
-						{
-							std::shared_ptr<Node> newNode = AddNode("Yes/No", ImGui::GetMousePos(), NodeType::Response);
-							newNode->prevNodeIds.push_back(started_attr >> NodePartShift::EndPin);
+						std::shared_ptr<Node> newNode = AddNode("Yes/No", ImGui::GetMousePos(), NodeType::Response);
+						newNode->prevNodeIds.push_back(started_attr >> NodePartShift::EndPin);
 
-							std::shared_ptr<Link> link = std::make_shared<Link>(
-								++current_state.next_link_id, started_attr, current_state.next_node_id << NodePartShift::InputPin);
+						std::shared_ptr<Link> link = std::make_shared<Link>(
+							++current_state.next_link_id, started_attr, current_state.next_node_id << NodePartShift::InputPin);
 
-							current_state.links[current_state.next_link_id] = link;
+						current_state.links[current_state.next_link_id] = link;
 
-							start_node->responses.push_back(current_state.next_node_id);
+						start_node->responses.push_back(current_state.next_node_id);
 
-							return;
-						}
+						listeners.OnLinkAdded(*link);
+						listeners.OnNodeChanged(*newNode, NodeChange::Connections);
+						listeners.OnNodeChanged(*start_node, NodeChange::Connections);
+						return;
 					}
 					if (start_node->nextNodeId == -1) // isn't connected to any node yet
 					{
@@ -276,6 +657,10 @@ namespace ede
 						current_state.links[current_state.next_link_id] = link;
 
 						start_node->nextNodeId = current_state.next_node_id;
+
+						listeners.OnLinkAdded(*link);
+						listeners.OnNodeChanged(*newNode, NodeChange::Connections);
+						listeners.OnNodeChanged(*start_node, NodeChange::Connections);
 					}
 				}
 			}
@@ -299,17 +684,6 @@ namespace ede
 				}
 			}
 
-			std::vector<int> GetConnectedLinks(int node_id) {
-				std::vector<int> resIds;
-				for (const auto& pair : current_state.links) {
-					std::shared_ptr<Link> link = pair.second;
-					if (link->EndsWithNode(node_id) || link->StartsWithNode(node_id)) {
-						resIds.push_back(link->id);
-					}
-				}
-				return resIds;
-			}
-
 			std::vector<Node> GetNodesData() {
 				std::vector<Node> res;
 				for (const auto& pair : current_state.nodes) {
@@ -327,7 +701,7 @@ namespace ede
 			 *                   Node creation/removal logic
 			 ******************************************************************************/
 
-			 // addition of node to state data
+			 // addition of node to state data, pos is in screen space
 			std::shared_ptr<Node> AddNode(const char* text, ImVec2 pos, NodeType type)
 			{
 				pos.y -= 110.f;
@@ -335,106 +709,105 @@ namespace ede
 				std::shared_ptr<Node> node = std::make_shared<Node>(++current_state.next_node_id, type, text, pos);
 
 				if (node) {
-					ImNodes::SetNodeScreenSpacePos(node->id, node->position);
+					ImNodes::SetNodeScreenSpacePos(node->id, pos);
+					node->position = ImNodes::GetNodeGridSpacePos(node->id);
 				}
 				current_state.nodes[node->id] = node;
+				listeners.OnNodeAdded(*node);
 				return node;
 			}
 
-			void HandleNodeRemoval() {
+			void AddRootNode() {
+				// spawn root node of conversation
+				AddNode("Conversation starter", ImVec2(150, ImGui::GetWindowSize().y / 1.2), NodeType::Speech);
+			}
+
+			// the node's position only lives in imnodes while it's on screen
+			void SyncSelectedNodePositions() {
 				const int num_nodes_selected = ImNodes::NumSelectedNodes();
-				const int num_links_selected = ImNodes::NumSelectedLinks();
-				if (num_links_selected > 0 && (ImGui::IsKeyReleased(ImGuiKey_Delete))) {
-					int* selected_links = new int[num_links_selected];
-					ImNodes::GetSelectedLinks(selected_links);
-					if (selected_links) {
-						for (int i = 0; i < num_links_selected; ++i) {
-							
-							// remove response if start_node was response. Also remove next_node_id and prevNodeId.
-
-							int link_id = selected_links[i];
-							std::shared_ptr<Link> link = current_state.links[link_id];
-							std::shared_ptr<Node> start_node = current_state.nodes[link->start_attr >> NodePartShift::EndPin];
-							int end_node_id = link->end_attr >> NodePartShift::InputPin;
-							if (start_node->expectesResponse) {
-								start_node->responses.erase(std::remove(start_node->responses.begin(), start_node->responses.end(), end_node_id), start_node->responses.end());
-							}
-							start_node->nextNodeId = -1;
-							std::vector<int> &ePrevNodes = current_state.nodes[end_node_id]->prevNodeIds;
-							ePrevNodes.erase(std::remove(ePrevNodes.begin(), ePrevNodes.end(), start_node->id), ePrevNodes.end());
+				if (num_nodes_selected == 0) {
+					return;
+				}
+				std::vector<int> selected_nodes(num_nodes_selected);
+				ImNodes::GetSelectedNodes(selected_nodes.data());
 
-							current_state.links.erase(link_id);
-						}
+				for (int node_id : selected_nodes) {
+					if (std::shared_ptr<Node> node = current_state.FindNode(node_id)) {
+						node->position = ImNodes::GetNodeGridSpacePos(node_id);
+						listeners.OnNodeChanged(*node, NodeChange::Position);
 					}
-					delete[] selected_links;
 				}
-				if (num_nodes_selected > 0 && (ImGui::IsKeyReleased(ImGuiKey_Delete)))
-				{
-					int* selected_nodes = new int[num_nodes_selected];
-					ImNodes::GetSelectedNodes(selected_nodes);
-					if (selected_nodes) {
-						for (int i = 0; i < num_nodes_selected; ++i) {
-
-							int node_id = selected_nodes[i];
-
-							// user shouldn't remove the root node
-							if (node_id == 0) {
-								continue;
-							}
-
-							// delete every related link
-							for (int link_id : GetConnectedLinks(node_id)) {
-								current_state.links.erase(link_id);
-							}
-
-							if (std::shared_ptr<Node> node = current_state.nodes[node_id]) {
-
-
-								for (int prevId : node->prevNodeIds) {
-									std::cout << "delete: now treating prevId: " << prevId << std::endl;
-									if (std::shared_ptr<Node> prev_node = current_state.nodes[prevId]) {
-										if (node->nodeType == NodeType::Response) { // if the node we are deleting is a response
-											std::vector<int>& responses = prev_node->responses;
-											responses.erase(std::remove(responses.begin(), responses.end(), node_id), responses.end());
-										}
-										else {
-											prev_node->nextNodeId = -1;
-											std::cout << "delete: Prev node with id: " << prevId << " was updated to have nextNodeId " << prev_node->nextNodeId << std::endl;
-										}
-									}
-								}
+			}
 
-								if (node->nextNodeId != -1) {
-									if (std::shared_ptr<Node> next_node = current_state.nodes[node->nextNodeId]) {
+			void HandleNodeRemoval() {
+				if (!ImGui::IsKeyReleased(ImGuiKey_Delete)) {
+					return;
+				}
+				const int num_nodes_selected = ImNodes::NumSelectedNodes();
+				const int num_links_selected = ImNodes::NumSelectedLinks();
+				if (num_nodes_selected == 0 && num_links_selected == 0) {
+					return;
+				}
 
-										auto& nPrevIds = next_node->prevNodeIds; // just an alias
-										
-										auto newEnd = std::remove(nPrevIds.begin(), nPrevIds.end(), node_id);
-										nPrevIds.erase(newEnd, nPrevIds.end());
-										
-										std::cout << "next_node info: " << next_node->id << "\n";
-									}
-								}
+				std::vector<int> selected_nodes(num_nodes_selected);
+				std::vector<int> selected_links(num_links_selected);
+				if (num_nodes_selected > 0) {
+					ImNodes::GetSelectedNodes(selected_nodes.data());
+				}
+				if (num_links_selected > 0) {
+					ImNodes::GetSelectedLinks(selected_links.data());
+				}
 
-							}
+				// the whole selection is removed in one go, see state_operations.h
+				RemoveNodesAndLinks(current_state, selected_nodes, selected_links, &listeners);
 
-							current_state.nodes.erase(node_id);
+				ImNodes::ClearNodeSelection();
+				ImNodes::ClearLinkSelection();
+			}
 
-						}
-						delete[] selected_nodes;
-					}
-				}
+			// whether the node's rect from the last frame overlaps the editor's canvas
+			bool IsNodeOnScreen(int node_id) const {
+				const ImVec2 pos = ImNodes::GetNodeScreenSpacePos(node_id);
+				const ImVec2 size = ImNodes::GetNodeDimensions(node_id);
+				const ImVec2 canvas_pos = ImGui::GetWindowPos();
+				const ImVec2 canvas_size = ImGui::GetWindowSize();
+				return pos.x <= canvas_pos.x + canvas_size.x && pos.x + size.x >= canvas_pos.x
+					&& pos.y <= canvas_pos.y + canvas_size.y && pos.y + size.y >= canvas_pos.y;
 			}
 
 			// Renders a node on the grid
-			void DrawNode(int node_id, const char* HeaderText)
+			void DrawNode(const std::shared_ptr<Node>& node, const char* HeaderText)
 			{
-				std::shared_ptr<Node> node = current_state.nodes[node_id];
 				if (node)
 				{
-
-					ImNodes::PushColorStyle(ImNodesCol_TitleBar, IM_COL32(66, 150, 250, 255));
-					ImNodes::PushColorStyle(ImNodesCol_TitleBarHovered, IM_COL32(86, 170, 255, 255));
+					const int node_id = node->id;
+
+					// nodes left out by the callback filter are still drawn, faded, so imnodes keeps their place on the canvas
+					const bool faded = IsFadedByFilter(node_id);
+					const int alpha = faded ? 50 : 255;
+					int pushed_colors = 2;
+
+					// nodes with a tag of the callback filter, then dead nodes, the conversation can never get to them.
+					// A load in progress isn't tracked until it completes
+					if (!callback_filter_fades_others && CarriesFilteredCallback(*node)) {
+						ImNodes::PushColorStyle(ImNodesCol_TitleBar, IM_COL32(200, 150, 40, 255));
+						ImNodes::PushColorStyle(ImNodesCol_TitleBarHovered, IM_COL32(225, 175, 60, 255));
+					}
+					else if (!loading && reachability.IsUnreachable(node_id)) {
+						ImNodes::PushColorStyle(ImNodesCol_TitleBar, IM_COL32(190, 70, 60, alpha));
+						ImNodes::PushColorStyle(ImNodesCol_TitleBarHovered, IM_COL32(215, 90, 80, alpha));
+					}
+					else {
+						ImNodes::PushColorStyle(ImNodesCol_TitleBar, IM_COL32(66, 150, 250, alpha));
+						ImNodes::PushColorStyle(ImNodesCol_TitleBarHovered, IM_COL32(86, 170, 255, alpha));
+					}
+					if (faded) {
+						ImNodes::PushColorStyle(ImNodesCol_NodeBackground, IM_COL32(50, 50, 50, alpha));
+						ImNodes::PushColorStyle(ImNodesCol_NodeBackgroundHovered, IM_COL32(75, 75, 75, alpha));
+						ImNodes::PushColorStyle(ImNodesCol_NodeOutline, IM_COL32(100, 100, 100, alpha));
+						ImGui::PushStyleVar(ImGuiStyleVar_Alpha, 0.25f);
+						pushed_colors += 3;
+					}
 
 					ImNodes::BeginNode(node_id);
 
@@ -454,7 +827,16 @@ namespace ede
 					ImNodes::BeginStaticAttribute(node_id << 16);
 					ImGui::PushItemWidth(200.0f);
 					ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(8.0f, 4.0f));
-					ImGui::InputText("Text", &current_state.nodes[node_id]->text);
+					// lazily loaded texts stay in their file until the node shows up on screen, a placeholder keeps its size meanwhile.
+					// Copying one out changes nothing the listeners see, it hashes like the text in the file until edited
+					if (node->HasLazyText() && !IsNodeOnScreen(node_id)) {
+						const ImGuiStyle& style = ImGui::GetStyle();
+						ImGui::Dummy(ImVec2(ImGui::CalcItemWidth() + style.ItemInnerSpacing.x + ImGui::CalcTextSize("Text").x, ImGui::GetFrameHeight()));
+					}
+					else if (ImGui::InputText("Text", &node->MaterializeText())) {
+						node->ForgetTextOrigin();
+						listeners.OnNodeChanged(*node, NodeChange::Text);
+					}
 					ImGui::PopStyleVar();
 					ImGui::PopItemWidth();
 					ImNodes::EndStaticAttribute();
@@ -464,7 +846,9 @@ namespace ede
 					{
 						if (node->nextNodeId == -1 && node->responses.empty())
 						{
-							ImGui::Checkbox("Expects response", &node->expectesResponse);
+							if (ImGui::Checkbox("Expects response", &node->expectesResponse)) {
+								listeners.OnNodeChanged(*node, NodeChange::ExpectsResponse);
+							}
 						}
 						else
 						{
@@ -502,6 +886,7 @@ namespace ede
 										node->selected_callbacks.erase(it);
 									}
 								}
+								listeners.OnNodeChanged(*node, NodeChange::Callbacks);
 							}
 
 							// Set the initial focus when opening the combo (scrolling + keyboard navigation focus)
@@ -532,8 +917,12 @@ namespace ede
 
 					ImNodes::EndNode();
 
-					ImNodes::PopColorStyle();
-					ImNodes::PopColorStyle();
+					if (faded) {
+						ImGui::PopStyleVar();
+					}
+					for (int i = 0; i < pushed_colors; i++) {
+						ImNodes::PopColorStyle();
+					}
 				}
 			}
 
@@ -545,6 +934,256 @@ namespace ede
 				return current_state.callbacks;
 			}
 
+			const std::vector<int>& GetUnreachableNodes() const {
+				static const std::vector<int> none;
+				return loading ? none : reachability.UnreachableNodes();
+			}
+
+			const PathAnalysis& GetPathAnalysis() {
+				static const PathAnalysis none;
+				return loading ? none : path_analyzer.Get(current_state);
+			}
+
+			// empty while a load is running, the tracker only hears of the loaded state once it completes
+			const GraphStats& GetGraphStats() const {
+				static const GraphStats none;
+				return loading ? none : graph_stats.Stats();
+			}
+
+			// the export has every word, even the ones still being counted
+			std::string GetGraphStatsJson() {
+				if (!loading) {
+					graph_stats.Update(/*wait=*/true);
+				}
+				std::map<std::string, size_t> callback_uses;
+				for (const std::string& callback : current_state.callbacks) {
+					callback_uses[callback] = callback_index.UseCount(callback);
+				}
+				return GraphStatsJson(GetGraphStats(), GetPathAnalysis(), callback_uses);
+			}
+
+			// null until the first pass, and while a load is running
+			std::shared_ptr<const ValidationReport> GetValidationReport() const {
+				return loading ? nullptr : validator.Report();
+			}
+
+			bool IsValidationPending() const {
+				return loading || validator.IsPending();
+			}
+
+			void ToggleIssuesWindow() {
+				bShowIssuesWindow = !bShowIssuesWindow;
+			}
+
+			// centers the canvas on the node and makes it the only selected one
+			void FocusNode(int node_id) {
+				if (!current_state.nodes.contains(node_id)) {
+					return;
+				}
+				ImNodes::ClearNodeSelection();
+				ImNodes::ClearLinkSelection();
+				ImNodes::SelectNode(node_id);
+				ImNodes::EditorContextMoveToNode(node_id);
+
+				// moving to the node puts it in the top left corner, the canvas is zoomed around that corner
+				const float zoom = ImNodes::EditorContextGetZoom();
+				const ImVec2 node_size = ImNodes::GetNodeDimensions(node_id);
+				ImVec2 panning = ImNodes::EditorContextGetPanning();
+				panning.x += (canvas_size.x / zoom - node_size.x) * 0.5f;
+				panning.y += (canvas_size.y / zoom - node_size.y) * 0.5f;
+				ImNodes::EditorContextResetPanning(panning);
+			}
+
+			// reruns the query only if it or a node's text changed since the last call, the panel asks every frame
+			const SearchResult& SearchNodes(const std::string& query) {
+				static const SearchResult none;
+				if (loading) {
+					return none;
+				}
+				if (query != last_search_query || text_search.Version() != last_search_version) {
+					const size_t max_results = 1000;
+					last_search = text_search.Search(current_state, query, max_results);
+					last_search_query = query;
+					last_search_version = text_search.Version();
+				}
+				return last_search;
+			}
+
+			// Arranges every node in layers from node 0, see graph_layout.h. Nodes are as big as they were last drawn
+			void AutoLayout() {
+				if (loading || current_state.nodes.empty()) {
+					return;
+				}
+				StopForceLayout();
+				std::unordered_map<int, ImVec2> node_sizes;
+				node_sizes.reserve(current_state.nodes.size());
+				for (const auto& [id, node] : current_state.nodes) {
+					if (node) {
+						node_sizes[id] = ImNodes::GetNodeDimensions(id);
+					}
+				}
+
+				const LayoutResult layout = LayeredLayout(current_state, node_sizes);
+				for (const auto& [id, position] : layout.positions) {
+					ImNodes::SetNodeGridSpacePos(id, position);
+					std::shared_ptr<Node> node = current_state.FindNode(id);
+					node->position = position;
+					listeners.OnNodeChanged(*node, NodeChange::Position);
+				}
+				FocusNode(0);
+			}
+
+			// Spreads the nodes out from where they are, on the force layout's worker. Runs again from scratch if it already is
+			void StartForceLayout() {
+				if (loading || current_state.nodes.empty()) {
+					return;
+				}
+				std::unordered_map<int, ImVec2> positions, node_sizes;
+				positions.reserve(current_state.nodes.size());
+				node_sizes.reserve(current_state.nodes.size());
+				for (const auto& [id, node] : current_state.nodes) {
+					if (node) {
+						positions[id] = ImNodes::GetNodeGridSpacePos(id);
+						node_sizes[id] = ImNodes::GetNodeDimensions(id);
+					}
+				}
+				force_layout.SetFixedNodes(FixedNodes());
+				force_layout.Start(current_state, positions, node_sizes);
+			}
+
+			// leaves the nodes where the force layout got them
+			void StopForceLayout() {
+				if (!force_layout.IsRunning()) {
+					return;
+				}
+				force_layout.Stop();
+				bool finished = false;
+				if (force_layout.TakePositions(force_layout_positions, finished)) {
+					ShowForceLayoutPositions();
+				}
+				CommitForceLayoutPositions();
+			}
+
+			// before the conversation is replaced, its pins don't mean anything to the next one
+			void ResetForceLayout() {
+				StopForceLayout();
+				pinned_nodes.clear();
+			}
+
+			bool IsForceLayoutRunning() const {
+				return force_layout.IsRunning();
+			}
+
+			// pins the selected nodes, or unpins them if they all are
+			void TogglePinSelectedNodes() {
+				const int num_nodes_selected = ImNodes::NumSelectedNodes();
+				if (num_nodes_selected == 0) {
+					return;
+				}
+				std::vector<int> selected_nodes(num_nodes_selected);
+				ImNodes::GetSelectedNodes(selected_nodes.data());
+				const bool all_pinned = std::all_of(selected_nodes.begin(), selected_nodes.end(), [this](int id) { return pinned_nodes.contains(id); });
+				for (int node_id : selected_nodes) {
+					if (all_pinned) {
+						pinned_nodes.erase(node_id);
+					}
+					else {
+						pinned_nodes.insert(node_id);
+					}
+				}
+			}
+
+			void UnpinAllNodes() {
+				pinned_nodes.clear();
+			}
+
+			bool HasPinnedNodes() const {
+				return !pinned_nodes.empty();
+			}
+
+			// the pinned nodes and the selected ones, so a node can be dragged while the others move around it
+			std::vector<std::pair<int, ImVec2>> FixedNodes() const {
+				std::vector<std::pair<int, ImVec2>> fixed_nodes;
+				for (int node_id : pinned_nodes) {
+					if (current_state.nodes.contains(node_id)) {
+						fixed_nodes.push_back({ node_id, ImNodes::GetNodeGridSpacePos(node_id) });
+					}
+				}
+				const int num_nodes_selected = ImNodes::NumSelectedNodes();
+				if (num_nodes_selected > 0) {
+					std::vector<int> selected_nodes(num_nodes_selected);
+					ImNodes::GetSelectedNodes(selected_nodes.data());
+					for (int node_id : selected_nodes) {
+						if (!pinned_nodes.contains(node_id) && current_state.nodes.contains(node_id)) {
+							fixed_nodes.push_back({ node_id, ImNodes::GetNodeGridSpacePos(node_id) });
+						}
+					}
+				}
+				return fixed_nodes;
+			}
+
+			// once per frame, before the nodes are drawn
+			void UpdateForceLayout() {
+				if (!force_layout.IsRunning()) {
+					return;
+				}
+				force_layout.SetFixedNodes(FixedNodes());
+				bool finished = false;
+				if (!force_layout.TakePositions(force_layout_positions, finished)) {
+					return;
+				}
+				ShowForceLayoutPositions();
+				if (finished) {
+					CommitForceLayoutPositions();
+				}
+			}
+
+			// Moves the nodes on the canvas only. Fixed ones are the user's, and nodes deleted since the start are gone
+			void ShowForceLayoutPositions() {
+				std::vector<int> selected_nodes(ImNodes::NumSelectedNodes());
+				if (!selected_nodes.empty()) {
+					ImNodes::GetSelectedNodes(selected_nodes.data());
+					std::sort(selected_nodes.begin(), selected_nodes.end());
+				}
+				for (const auto& [id, position] : force_layout_positions) {
+					if (pinned_nodes.contains(id) || std::binary_search(selected_nodes.begin(), selected_nodes.end(), id) || !current_state.nodes.contains(id)) {
+						continue;
+					}
+					ImNodes::SetNodeGridSpacePos(id, position);
+				}
+			}
+
+			void CommitForceLayoutPositions() {
+				for (const auto& [id, position] : force_layout_positions) {
+					if (std::shared_ptr<Node> node = current_state.FindNode(id)) {
+						node->position = ImNodes::GetNodeGridSpacePos(id);
+						listeners.OnNodeChanged(*node, NodeChange::Position);
+					}
+				}
+				force_layout_positions.clear();
+			}
+
+			// opens the search window with the query ready to be typed
+			void OpenSearchWindow() {
+				bShowSearchWindow = true;
+				focus_search_input = true;
+			}
+
+			// links have no position of their own, the canvas goes to the node at the link's input pin
+			void FocusLink(int link_id) {
+				std::shared_ptr<Link> link = current_state.FindLink(link_id);
+				if (!link) {
+					return;
+				}
+				const int end_id = static_cast<int>(static_cast<uint32_t>(link->end_attr) >> NodePartShift::InputPin);
+				ImNodes::ClearNodeSelection();
+				ImNodes::ClearLinkSelection();
+				ImNodes::SelectLink(link_id);
+				if (current_state.nodes.contains(end_id)) {
+					ImNodes::EditorContextMoveToNode(end_id);
+				}
+			}
+
 			void ToggleDemoWindow() {
 				bShowDemoWindow = !bShowDemoWindow;
 			}
@@ -561,31 +1200,431 @@ namespace ede
 				bShowNewFilePopup = true;
 			}
 
-			void RequestNotification(const char* title, const char* description) {
+			void RequestNotification(const std::string& title, const std::string& description) {
 				current_notification_title = title;
 				current_notification_description = description;
 				bShowPopupNotif = true;
 			}
 
+			// only the nodes the index has for the tag are touched. Copied, each change takes the node out of the index's list
 			void NotifyCallbackDeletion(const std::string& deleted_callback) {
-				for (auto& node_pair : current_state.nodes) {
-					std::shared_ptr<Node> node = node_pair.second;
-					if (node) {
-						node->selected_callbacks.erase(deleted_callback);
+				const std::set<int> users = callback_index.NodesWith(deleted_callback);
+				for (int node_id : users) {
+					std::shared_ptr<Node> node = current_state.FindNode(node_id);
+					if (node && node->selected_callbacks.erase(deleted_callback) > 0) {
+						listeners.OnNodeChanged(*node, NodeChange::Callbacks);
 					}
 				}
+				listeners.OnCallbackRemoved(deleted_callback);
+				callback_filter.erase(deleted_callback);
 			}
 
-			void SetState(const State& new_state) {
+			size_t GetCallbackUseCount(const std::string& callback) const {
+				return callback_index.UseCount(callback);
+			}
 
+			bool IsCallbackFiltered(const std::string& callback) const {
+				return callback_filter.contains(callback);
+			}
+
+			void ToggleCallbackFilter(const std::string& callback) {
+				if (!callback_filter.erase(callback)) {
+					callback_filter.insert(callback);
+				}
+			}
+
+			void ClearCallbackFilter() {
+				callback_filter.clear();
+			}
+
+			bool& CallbackFilterFadesOthers() {
+				return callback_filter_fades_others;
+			}
+
+			bool CarriesFilteredCallback(const Node& node) const {
+				return std::any_of(node.selected_callbacks.begin(), node.selected_callbacks.end(),
+					[this](const std::string& callback) { return callback_filter.contains(callback); });
+			}
+
+			// the filter only fades nodes out when asked to, and never while it's empty
+			bool IsFadedByFilter(int node_id) const {
+				if (callback_filter.empty() || !callback_filter_fades_others) {
+					return false;
+				}
+				std::shared_ptr<Node> node = current_state.FindNode(node_id);
+				return node && !CarriesFilteredCallback(*node);
+			}
+
+			void NotifyCallbackAdded(const std::string& added_callback) {
+				listeners.OnCallbackAdded(added_callback);
+			}
+
+			void SetState(const State& new_state) {
+				CancelLoad();
+				ResetForceLayout();
 				current_state = new_state;
+				PlaceLoadedNodes();
+				listeners.OnStateReset(current_state);
+				documents[active_document].saved_hash = content_hash.Hash();
+			}
+
+			void SetState(State&& new_state) {
+				CancelLoad();
+				ResetForceLayout();
+				current_state = std::move(new_state);
+				PlaceLoadedNodes();
+				listeners.OnStateReset(current_state);
+				documents[active_document].saved_hash = content_hash.Hash();
+			}
+
+			void AddStateListener(StateListener* listener) {
+				listeners.Add(listener);
+			}
+
+			void RemoveStateListener(StateListener* listener) {
+				listeners.Remove(listener);
+			}
+
+			/******************************************************************************
+			 *                   Crash recovery
+			 ******************************************************************************/
+
+			// Picks up the journals of a session that didn't exit cleanly, each in its own document, or starts a new
+			// conversation. Either way, every edit from here on is journaled.
+			void InitializeConversation() {
+				// the first one takes the standalone document, the others open next to it. Only the standalone one can be
+				// untitled, project conversations all have a file
+				std::vector<UnfinishedJournal> unfinished_journals = OperationJournal::FindUnfinishedJournals();
+				std::stable_partition(unfinished_journals.begin(), unfinished_journals.end(),
+					[](const UnfinishedJournal& unfinished) { return unfinished.document_path.empty(); });
+				bool recovered = false;
+				for (const UnfinishedJournal& unfinished : unfinished_journals) {
+					State recovered_state;
+					if (!OperationJournal::Replay(unfinished.journal_path, recovered_state) || recovered_state.nodes.empty()) {
+						OperationJournal::Discard(unfinished.journal_path);
+						continue;
+					}
+					if (recovered) {
+						Document document;
+						document.context = ImNodes::EditorContextCreate();
+						documents.push_back(std::move(document));
+						ActivateDocument(static_cast<int>(documents.size()) - 1);
+					}
+					SetState(std::move(recovered_state));
+					document_path = unfinished.document_path;
+					documents[active_document].path = document_path;
+					documents[active_document].saved_hash.reset();
+					recovered = true;
+				}
+				if (recovered) {
+					RequestNotification("Work recovered", "The last session didn't close properly.\nIts unsaved changes were recovered, don't forget to save them.");
+				}
+				else {
+					AddRootNode();
+				}
+
+				listeners.Add(&journal);
+				journal.Open(OperationJournal::JournalPathFor(document_path), document_path, snapshots.Take(current_state));
+			}
+
+			// moves the journal next to the file the conversation now belongs to
+			void SetDocumentPath(const std::string& path) {
+				documents[active_document].path = path;
+				if (path == document_path && journal.IsOpen()) {
+					return;
+				}
+				document_path = path;
+				if (journal.IsOpen()) {
+					journal.Close(/*discard=*/true);
+					journal.Open(OperationJournal::JournalPathFor(document_path), document_path, snapshots.Take(current_state));
+				}
+			}
+
+			// Clean exit, nothing to recover next time. Edited project conversations are saved like on close.
+			// Returns false, keeping the journal, if one of them or a running save fails
+			bool Shutdown() {
+				CancelLoad();
+				for (int i = static_cast<int>(documents.size()) - 1; i > 0; i--) {
+					if (!CloseDocument(i)) {
+						return false;
+					}
+				}
+				saver.Wait();
+				if (!CollectFinishedSave()) {
+					return false;
+				}
+				listeners.Remove(&journal);
+				journal.Close(/*discard=*/true);
+				return true;
+			}
+
+			/******************************************************************************
+			 *                   Documents and projects
+			 ******************************************************************************/
+
+			void CreateStandaloneDocument() {
+				Document standalone;
+				standalone.context = ImNodes::EditorContextCreate();
+				ImNodes::EditorContextSet(standalone.context);
+				documents.push_back(std::move(standalone));
+				listeners.Add(&content_hash);
+				listeners.Add(&reachability);
+				listeners.Add(&path_analyzer);
+				listeners.Add(&validator);
+				listeners.Add(&text_search);
+				listeners.Add(&callback_index);
+				listeners.Add(&graph_stats);
+				listeners.Add(&snapshots);
+			}
+
+			// the background save finished, the document it belongs to now lives at its path
+			void FinishSave() {
+				auto it = std::find_if(documents.begin(), documents.end(), [this](const Document& d) { return d.context == saving_context; });
+				saving_context = nullptr;
+				if (it == documents.end()) {
+					return;
+				}
+
+				const int document_index = static_cast<int>(it - documents.begin());
+				const bool active = document_index == active_document;
+				// edits made while it was written aren't in the file, the hash of the snapshot is what was saved
+				it->saved_hash = saving_hash;
+				if (active) {
+					SetDocumentPath(last_save.path);
+				}
+				else {
+					// the journal it left behind when it was set aside has nothing the file doesn't
+					if (!HasUnsavedChanges(document_index)) {
+						OperationJournal::Discard(OperationJournal::JournalPathFor(it->path));
+					}
+					it->path = last_save.path;
+				}
+
+				const int index = project.IsOpen() ? project.FindConversation(last_save.path) : -1;
+				if (index != -1) {
+					project.AddConversation(last_save.path, active ? current_state : it->state);
+					project.Save();
+				}
+			}
+
+			// swaps the shown conversation, with its own imnodes context, in and the current one out
+			void ActivateDocument(int index) {
+				if (index == active_document || index < 0 || index >= static_cast<int>(documents.size())) {
+					return;
+				}
+				// the load and the force layout belong to the document being left
+				CancelLoad();
+				ResetForceLayout();
+				Document& current = documents[active_document];
+				SyncNodePositions(current_state);
+				// with unsaved changes, its journal stays behind for recovery until it's saved or closed
+				const bool journaling = journal.IsOpen();
+				journal.Close(/*discard=*/!HasUnsavedChanges(active_document));
+				current.state = std::move(current_state);
+				current.hash = content_hash.Hash();
+
+				active_document = index;
+				Document& next = documents[index];
+				current_state = std::move(next.state);
+				next.state = {};
+				ImNodes::EditorContextSet(next.context);
+				listeners.OnStateReset(current_state);
+				document_path = next.path;
+				if (journaling) {
+					journal.Open(OperationJournal::JournalPathFor(document_path), document_path, snapshots.Take(current_state));
+				}
+				select_document_tab = index;
+			}
+
+			// Unloads a project conversation, writing it first if it was edited. It stays open if that fails
+			bool CloseDocument(int index) {
+				if (index <= 0 || index >= static_cast<int>(documents.size())) {
+					return false;
+				}
+				if (index == active_document) {
+					ActivateDocument(0);
+				}
+				// a save still writing it decides whether it has to be written again, and mustn't race the write below
+				saver.Wait();
+				CollectFinishedSave();
+
+				Document& document = documents[index];
+				const bool changed = HasUnsavedChanges(index);
+				std::string error;
+				// its own file can't be replaced while lazy texts keep it mapped
+				if (changed) {
+					MaterializeAllText(document.state);
+				}
+				if (changed && !SaveStateAtomically(document.state, document.path, &error)) {
+					RequestNotification("Could not close the conversation", "Saving it failed:\n" + error);
+					return false;
+				}
+				if (changed && project.FindConversation(document.path) != -1) {
+					project.AddConversation(document.path, document.state);
+					project.Save();
+				}
+				OperationJournal::Discard(OperationJournal::JournalPathFor(document.path));
+
+				if (saving_context == document.context) {
+					saving_context = nullptr;
+				}
+				ImNodes::EditorContextFree(document.context);
+				documents.erase(documents.begin() + index);
+				if (active_document > index) {
+					active_document--;
+				}
+				return true;
+			}
+
+			// compares normalized paths without touching the disk, the project window asks every frame
+			int FindDocument(const std::string& path) const {
+				const std::filesystem::path wanted = std::filesystem::path(path).lexically_normal();
+				for (int i = 0; i < static_cast<int>(documents.size()); i++) {
+					const std::string& document_file = i == active_document ? document_path : documents[i].path;
+					if (!document_file.empty() && std::filesystem::path(document_file).lexically_normal() == wanted) {
+						return i;
+					}
+				}
+				return -1;
+			}
+
+			// shows the conversation, loading it in its own document unless it's already open
+			bool OpenConversation(const std::string& path) {
+				int index = FindDocument(path);
+				if (index != -1) {
+					ActivateDocument(index);
+					return true;
+				}
+
+				Document document;
+				std::string error;
+				if (!LoadConversation(path, document.state, &error)) {
+					RequestNotification("Could not open the conversation", error);
+					return false;
+				}
+				document.path = path;
+				document.context = ImNodes::EditorContextCreate();
+				documents.push_back(std::move(document));
+				ActivateDocument(static_cast<int>(documents.size()) - 1);
+				documents[active_document].saved_hash = content_hash.Hash();
+				PlaceLoadedNodes();
+				return true;
+			}
+
+			bool IsConversationOpen(const std::string& path) const {
+				return FindDocument(path) != -1;
+			}
+
+			// takes the summary from the open document if there is one, otherwise the file is read once
+			bool AddConversationToProject(const std::string& path) {
+				if (!project.IsOpen()) {
+					return false;
+				}
+				const int index = FindDocument(path);
+				State loaded;
+				std::string error;
+				if (index == -1 && !LoadConversation(path, loaded, &error)) {
+					RequestNotification("Could not add the conversation", error);
+					return false;
+				}
+				const State& state = index == -1 ? loaded : index == active_document ? current_state : documents[index].state;
+				project.AddConversation(path, state);
+				if (!project.Save(&error)) {
+					RequestNotification("Could not save the project", error);
+					return false;
+				}
+				return true;
+			}
+
+			bool CreateProject(const std::string& path) {
+				if (!CloseProject()) {
+					return false;
+				}
+				std::string error;
+				if (!project.Create(path, &error)) {
+					RequestNotification("Could not create the project", error);
+					return false;
+				}
+				bShowProjectWindow = true;
+				return true;
+			}
+
+			// only reads the manifest, conversations are loaded when opened
+			bool OpenProject(const std::string& path) {
+				if (!CloseProject()) {
+					return false;
+				}
+				std::string error;
+				if (!project.Load(path, &error)) {
+					RequestNotification("Could not open the project", error);
+					return false;
+				}
+				bShowProjectWindow = true;
+				return true;
+			}
+
+			// stops at the first conversation that can't be saved, which stays open with the project
+			bool CloseProject() {
+				for (int i = static_cast<int>(documents.size()) - 1; i > 0; i--) {
+					if (!CloseDocument(i)) {
+						return false;
+					}
+				}
+				project.Close();
+				return true;
+			}
+
+			const Project& GetProject() const {
+				return project;
+			}
+
+			void ToggleProjectWindow() {
+				bShowProjectWindow = !bShowProjectWindow;
+			}
 
+			void ShowDocumentTabs() {
+				int activate_index = -1;
+				int close_index = -1;
+				if (ImGui::BeginTabBar("Documents", ImGuiTabBarFlags_FittingPolicyScroll)) {
+					for (int i = 0; i < static_cast<int>(documents.size()); i++) {
+						const std::string& path = i == active_document ? document_path : documents[i].path;
+						const bool changed = HasUnsavedChanges(i);
+						// the context pointer keeps the tab's id stable when earlier tabs close
+						std::string label = (path.empty() ? std::string("Untitled") : std::filesystem::path(path).filename().string())
+							+ (changed ? " *" : "") + "###" + std::to_string(reinterpret_cast<uintptr_t>(documents[i].context));
+
+						bool open = true;
+						ImGuiTabItemFlags flags = select_document_tab == i ? ImGuiTabItemFlags_SetSelected : ImGuiTabItemFlags_None;
+						if (ImGui::BeginTabItem(label.c_str(), i == 0 ? nullptr : &open, flags)) {
+							if (i != active_document && select_document_tab == -1) {
+								activate_index = i;
+							}
+							ImGui::EndTabItem();
+						}
+						if (!open) {
+							close_index = i;
+						}
+					}
+					ImGui::EndTabBar();
+				}
+				select_document_tab = -1;
+
+				if (activate_index != -1) {
+					ActivateDocument(activate_index);
+				}
+				if (close_index != -1) {
+					CloseDocument(close_index);
+				}
+			}
+
+			// hands the positions of a freshly set state over to imnodes
+			void PlaceLoadedNodes() {
 				for (const auto& node_pair : current_state.nodes) {
 
 					std::shared_ptr<Node> node = node_pair.second;
 
 					if (node) {
-						ImNodes::SetNodeScreenSpacePos(node->id, node->position);
+						ImNodes::SetNodeGridSpacePos(node->id, node->position);
 					}
 
 				}
@@ -602,12 +1641,12 @@ namespace ede
 
 	void InitializeConversation()
 	{
-		// spawn root node of conversation
-		editor.AddNode("Conversation starter", ImVec2(150, ImGui::GetWindowSize().y / 1.2), NodeType::Speech);
+		editor.InitializeConversation();
 	}
 
 	void NodeEditorInitialize()
 	{
+		editor.CreateStandaloneDocument();
 		ImNodes::SetNodeGridSpacePos(1, ImVec2(200.0f, 200.0f));
 
 		ImNodesStyle& style = ImNodes::GetStyle();
@@ -621,16 +1660,23 @@ namespace ede
 		style.NodePadding = ImVec2(8.0f, 8.0f);
 		style.NodeCornerRounding = 6.0f;
 		style.NodeBorderThickness = 1.0f;
+
+		// non-overlapping nodes share draw channels, big graphs would otherwise need two per node
+		style.Flags |= ImNodesStyleFlags_SharedNodeChannels;
 	}
 
 	void NodeEditorShow() { editor.show(); }
 
-	void NodeEditorShutdown() {}
+	bool NodeEditorShutdown() { return editor.Shutdown(); }
 
 	/*************************************
 	*               Getters
 	**************************************/
 
+	const std::unordered_map<int, std::shared_ptr<Node>>& GetNodesMap() {
+		return editor.GetNodesMap();
+	}
+
 	std::vector<std::shared_ptr<Node>> GetNodesVec() {
 		const auto& nodesMap = editor.GetNodesMap();
 
@@ -643,6 +1689,14 @@ namespace ede
 		return nodes;
 	}
 
+	const GraphStats& GetGraphStats() {
+		return editor.GetGraphStats();
+	}
+
+	std::string GetGraphStatsJson() {
+		return editor.GetGraphStatsJson();
+	}
+
 	int GetNumNodesOfType(NodeType type) {
 		const auto& nodesMap = editor.GetNodesMap();
 		int res = 0;
@@ -665,6 +1719,14 @@ namespace ede
 		return editor.GetCallbacks();
 	}
 
+	const std::vector<int>& GetUnreachableNodes() {
+		return editor.GetUnreachableNodes();
+	}
+
+	const PathAnalysis& GetPathAnalysis() {
+		return editor.GetPathAnalysis();
+	}
+
 	const State& GetCurrentState() {
 		return editor.GetCurrentState();
 	}
@@ -688,6 +1750,30 @@ namespace ede
 	void NotifyCallbackDeletion(const std::string& deleted_callback) {
 		editor.NotifyCallbackDeletion(deleted_callback);
 	}
+
+	size_t GetCallbackUseCount(const std::string& callback) {
+		return editor.GetCallbackUseCount(callback);
+	}
+
+	bool IsCallbackFiltered(const std::string& callback) {
+		return editor.IsCallbackFiltered(callback);
+	}
+
+	void ToggleCallbackFilter(const std::string& callback) {
+		editor.ToggleCallbackFilter(callback);
+	}
+
+	void ClearCallbackFilter() {
+		editor.ClearCallbackFilter();
+	}
+
+	bool& CallbackFilterFadesOthers() {
+		return editor.CallbackFilterFadesOthers();
+	}
+	void NotifyCallbackAdded(const std::string& added_callback) {
+		editor.NotifyCallbackAdded(added_callback);
+	}
+
 	void ShowNewFilePopup() {
 		editor.ShowNewFilePopup();
 	}
@@ -696,10 +1782,135 @@ namespace ede
 		editor.SetState(new_state);
 	}
 
+	void SetState(State&& new_state) {
+		editor.SetState(std::move(new_state));
+	}
+
 	void RequestNotification(const char* title, const char* description) {
 		editor.RequestNotification(title, description);
 	}
 
+	bool SaveStateInBackground(const std::string& path) {
+		return editor.SaveStateInBackground(path);
+	}
+
+	void LoadStateInBackground(const std::string& path) {
+		editor.LoadStateInBackground(path);
+	}
+
+	bool IsLoading() {
+		return editor.IsLoading();
+	}
+
+	bool HasUnsavedChanges() {
+		return editor.HasUnsavedChanges();
+	}
+
+	const std::string& GetDocumentPath() {
+		return editor.GetDocumentPath();
+	}
+
+	void SetDocumentPath(const std::string& path) {
+		editor.SetDocumentPath(path);
+	}
+
+	bool CreateProject(const std::string& path) {
+		return editor.CreateProject(path);
+	}
+
+	bool OpenProject(const std::string& path) {
+		return editor.OpenProject(path);
+	}
+
+	bool CloseProject() {
+		return editor.CloseProject();
+	}
+
+	const Project& GetProject() {
+		return editor.GetProject();
+	}
+
+	bool AddConversationToProject(const std::string& path) {
+		return editor.AddConversationToProject(path);
+	}
+
+	bool OpenConversation(const std::string& path) {
+		return editor.OpenConversation(path);
+	}
+
+	bool IsConversationOpen(const std::string& path) {
+		return editor.IsConversationOpen(path);
+	}
+
+	void ToggleProjectWindow() {
+		editor.ToggleProjectWindow();
+	}
+
+	void AddStateListener(StateListener* listener) {
+		editor.AddStateListener(listener);
+	}
+
+	void RemoveStateListener(StateListener* listener) {
+		editor.RemoveStateListener(listener);
+	}
+
+	void FocusNode(int node_id) {
+		editor.FocusNode(node_id);
+	}
+
+	void FocusLink(int link_id) {
+		editor.FocusLink(link_id);
+	}
+
+	const SearchResult& SearchNodes(const std::string& query) {
+		return editor.SearchNodes(query);
+	}
+
+	void OpenSearchWindow() {
+		editor.OpenSearchWindow();
+	}
+
+	void AutoLayout() {
+		editor.AutoLayout();
+	}
+
+	void ToggleForceLayout() {
+		if (editor.IsForceLayoutRunning()) {
+			editor.StopForceLayout();
+		}
+		else {
+			editor.StartForceLayout();
+		}
+	}
+
+	bool IsForceLayoutRunning() {
+		return editor.IsForceLayoutRunning();
+	}
+
+	void TogglePinSelectedNodes() {
+		editor.TogglePinSelectedNodes();
+	}
+
+	void UnpinAllNodes() {
+		editor.UnpinAllNodes();
+	}
+
+	bool HasPinnedNodes() {
+		return editor.HasPinnedNodes();
+	}
+
+	std::shared_ptr<const ValidationReport> GetValidationReport() {
+		return editor.GetValidationReport();
+	}
+
+	bool IsValidationPending() {
+		return editor.IsValidationPending();
+	}
+
+	void ToggleIssuesWindow() {
+		editor.ToggleIssuesWindow();
+	}
+
 	bool IsInputPin(int attribute)
 	{
 		return (attribute & (0xFF << NodePartShift::InputPin)) && !(attribute & (0xFF << NodePartShift::EndPin));
@@ -0,0 +1,61 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include <cstdio>
+#include <vector>
+
+namespace ede
+{
+	// Collects the output in a fixed size buffer and hands it to the file whenever it fills up
+	class FileSink
+	{
+	public:
+		explicit FileSink(std::FILE* _file) : file(_file) {
+			buffer.reserve(BufferSize);
+		}
+
+		void Write(const char* data, size_t size) {
+			if (buffer.size() + size > BufferSize) {
+				Flush();
+				// too big to be worth buffering
+				if (size > BufferSize) {
+					WriteToFile(data, size);
+					return;
+				}
+			}
+			buffer.insert(buffer.end(), data, data + size);
+		}
+
+		void Write(char c) {
+			if (buffer.size() == BufferSize) {
+				Flush();
+			}
+			buffer.push_back(c);
+		}
+
+		bool Flush() {
+			WriteToFile(buffer.data(), buffer.size());
+			buffer.clear();
+			return !failed;
+		}
+
+	private:
+		static constexpr size_t BufferSize = 64 * 1024;
+
+		void WriteToFile(const char* data, size_t size) {
+			if (size > 0 && std::fwrite(data, 1, size, file) != size) {
+				failed = true;
+			}
+		}
+
+		std::FILE*        file;
+		std::vector<char> buffer;
+		bool              failed = false;
+	};
+}
@@ -0,0 +1,310 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "force_layout.h"
+#include "state_hash.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ede
+{
+	namespace
+	{
+		const ImVec2 DefaultNodeSize = ImVec2(260.0f, 150.0f);
+
+		// deeper than this, the points of a cell are as good as on top of each other and stay in one leaf
+		const int MaxDepth = 24;
+
+		// cooled down this far, relative to the ideal distance, the nodes have settled
+		const double SettledTemperature = 0.01;
+	}
+
+	ForceLayout::~ForceLayout()
+	{
+		Stop();
+	}
+
+	void ForceLayout::Start(const State& state, const std::unordered_map<int, ImVec2>& positions, const std::unordered_map<int, ImVec2>& sizes,
+		const ForceLayoutOptions& layout_options)
+	{
+		Stop();
+		options = layout_options;
+		ids.clear();
+		half_sizes.clear();
+		centers.clear();
+		edges.clear();
+		index_of.clear();
+
+		const std::vector<const Node*> nodes = NodesInIdOrder(state);
+		const size_t n = nodes.size();
+		index_of.reserve(n);
+		double diagonals = 0.0;
+		middle = {};
+		for (size_t i = 0; i < n; i++) {
+			const int id = nodes[i]->id;
+			index_of[id] = static_cast<int>(i);
+			ids.push_back(id);
+
+			auto size = sizes.find(id);
+			const ImVec2 node_size = size != sizes.end() && size->second.x > 0.0f && size->second.y > 0.0f ? size->second : DefaultNodeSize;
+			half_sizes.push_back({ node_size.x * 0.5, node_size.y * 0.5 });
+			diagonals += std::hypot(node_size.x, node_size.y);
+
+			// nodes piled on one spot would all push each other the same way, a spiral a pixel apart tells them apart
+			auto position = positions.find(id);
+			const ImVec2 top_left = position != positions.end() ? position->second : nodes[i]->position;
+			const double angle = i * 2.399963;
+			const double radius = std::sqrt(static_cast<double>(i));
+			centers.push_back({ top_left.x + half_sizes.back().x + radius * std::cos(angle), top_left.y + half_sizes.back().y + radius * std::sin(angle) });
+			middle.x += centers.back().x;
+			middle.y += centers.back().y;
+		}
+		if (n == 0) {
+			return;
+		}
+		middle.x /= n;
+		middle.y /= n;
+
+		for (size_t i = 0; i < n; i++) {
+			auto connect = [&](int target_id) {
+				auto it = index_of.find(target_id);
+				if (it != index_of.end() && it->second != static_cast<int>(i)) {
+					edges.push_back(std::minmax(static_cast<int>(i), it->second));
+				}
+			};
+			connect(nodes[i]->nextNodeId);
+			for (int response_id : nodes[i]->responses) {
+				connect(response_id);
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		// far enough apart that two connected nodes don't overlap
+		ideal_distance = options.ideal_distance > 0.0f ? options.ideal_distance : diagonals / n + 40.0;
+		// hot enough to spread a pile of nodes out to about the size they'll end up taking
+		temperature = ideal_distance * std::max(2.0, std::sqrt(static_cast<double>(n)) * 0.5);
+		displacements.assign(n, {});
+		fixed.assign(n, 0);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			published.clear();
+			published_finished = false;
+			fixed_nodes_changed = true;
+		}
+		published_iteration = 0;
+		taken_iteration = 0;
+		stopping = false;
+		running = true;
+		worker = std::thread(&ForceLayout::Run, this);
+	}
+
+	void ForceLayout::Stop()
+	{
+		stopping = true;
+		if (worker.joinable()) {
+			worker.join();
+		}
+		running = false;
+	}
+
+	void ForceLayout::SetFixedNodes(std::vector<std::pair<int, ImVec2>> fixed_positions)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		fixed_nodes = std::move(fixed_positions);
+		fixed_nodes_changed = true;
+	}
+
+	bool ForceLayout::TakePositions(std::vector<std::pair<int, ImVec2>>& positions, bool& finished)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		const int iteration = published_iteration.load();
+		if (iteration == taken_iteration) {
+			return false;
+		}
+		taken_iteration = iteration;
+		positions.swap(published);
+		finished = published_finished;
+		if (finished) {
+			running = false;
+		}
+		return true;
+	}
+
+	void ForceLayout::Run()
+	{
+		for (int iteration = 0; iteration < options.max_iterations && !stopping && temperature > ideal_distance * SettledTemperature; iteration++) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (fixed_nodes_changed) {
+					std::fill(fixed.begin(), fixed.end(), 0);
+					for (const auto& [id, top_left] : fixed_nodes) {
+						auto it = index_of.find(id);
+						if (it != index_of.end()) {
+							fixed[it->second] = 1;
+							centers[it->second] = { top_left.x + half_sizes[it->second].x, top_left.y + half_sizes[it->second].y };
+						}
+					}
+					fixed_nodes_changed = false;
+				}
+			}
+			Iterate();
+			Publish(false);
+		}
+		Publish(true);
+	}
+
+	void ForceLayout::Iterate()
+	{
+		const size_t n = centers.size();
+
+		Vec low = centers.front(), high = centers.front();
+		for (const Vec& center : centers) {
+			low = { std::min(low.x, center.x), std::min(low.y, center.y) };
+			high = { std::max(high.x, center.x), std::max(high.y, center.y) };
+		}
+		cells.clear();
+		cell_points.resize(n);
+		for (size_t i = 0; i < n; i++) {
+			cell_points[i] = static_cast<int>(i);
+		}
+		BuildCell(0, static_cast<int>(n), low, std::max(high.x - low.x, high.y - low.y) + 1.0, 0);
+
+		for (size_t i = 0; i < n; i++) {
+			displacements[i] = fixed[i] ? Vec{} : Repulsion(static_cast<int>(i));
+		}
+
+		// connected nodes pull each other by the square of their distance
+		for (const auto& [a, b] : edges) {
+			const double dx = centers[a].x - centers[b].x;
+			const double dy = centers[a].y - centers[b].y;
+			const double distance = std::max(std::sqrt(dx * dx + dy * dy), 0.01);
+			const double pull = distance / ideal_distance; // distance² / ideal_distance, over distance for the direction
+			displacements[a].x -= dx * pull;
+			displacements[a].y -= dy * pull;
+			displacements[b].x += dx * pull;
+			displacements[b].y += dy * pull;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			if (fixed[i]) {
+				continue;
+			}
+			Vec& move = displacements[i];
+			move.x += (middle.x - centers[i].x) * options.gravity;
+			move.y += (middle.y - centers[i].y) * options.gravity;
+			const double length = std::sqrt(move.x * move.x + move.y * move.y);
+			if (length > 0.0) {
+				const double step = std::min(length, temperature) / length;
+				centers[i].x += move.x * step;
+				centers[i].y += move.y * step;
+			}
+		}
+		temperature *= options.cooling;
+	}
+
+	// The cell of the points cell_points[first, last) in the square from corner, returned by index.
+	// Children are built after their parent, cells may move while they are
+	int ForceLayout::BuildCell(int first, int last, Vec corner, double size, int depth)
+	{
+		const int index = static_cast<int>(cells.size());
+		cells.emplace_back();
+
+		Vec sum;
+		for (int i = first; i < last; i++) {
+			sum.x += centers[cell_points[i]].x;
+			sum.y += centers[cell_points[i]].y;
+		}
+		const int count = last - first;
+		Cell& cell = cells[index];
+		cell.mass = count;
+		cell.center_of_mass = { sum.x / count, sum.y / count };
+		cell.size = size;
+		if (count == 1 || depth == MaxDepth) {
+			cell.first = first;
+			cell.count = count;
+			return index;
+		}
+
+		const double half = size * 0.5;
+		const Vec split = { corner.x + half, corner.y + half };
+		auto begin = cell_points.begin();
+		auto left = [&](int point) { return centers[point].x < split.x; };
+		auto top = [&](int point) { return centers[point].y < split.y; };
+		const int middle_x = static_cast<int>(std::partition(begin + first, begin + last, left) - begin);
+		const int middle_left = static_cast<int>(std::partition(begin + first, begin + middle_x, top) - begin);
+		const int middle_right = static_cast<int>(std::partition(begin + middle_x, begin + last, top) - begin);
+
+		const int bounds[5] = { first, middle_left, middle_x, middle_right, last };
+		const Vec corners[4] = { corner, { corner.x, split.y }, { split.x, corner.y }, split };
+		for (int quadrant = 0; quadrant < 4; quadrant++) {
+			if (bounds[quadrant] < bounds[quadrant + 1]) {
+				const int child = BuildCell(bounds[quadrant], bounds[quadrant + 1], corners[quadrant], half, depth + 1);
+				cells[index].children[quadrant] = child;
+			}
+		}
+		return index;
+	}
+
+	// Every other node pushes by the square of the ideal distance over their distance. Cells far enough away push as one
+	ForceLayout::Vec ForceLayout::Repulsion(int point) const
+	{
+		const Vec p = centers[point];
+		const double k2 = ideal_distance * ideal_distance;
+		const double theta2 = static_cast<double>(options.theta) * options.theta;
+		Vec force;
+		auto push = [&](Vec from, double mass) {
+			const double dx = p.x - from.x;
+			const double dy = p.y - from.y;
+			const double scale = mass * k2 / std::max(dx * dx + dy * dy, 1.0);
+			force.x += dx * scale;
+			force.y += dy * scale;
+		};
+
+		int stack[MaxDepth * 3 + 4];
+		int top = 0;
+		stack[top++] = 0;
+		while (top > 0) {
+			const Cell& cell = cells[stack[--top]];
+			if (cell.count > 0) {
+				for (int i = cell.first; i < cell.first + cell.count; i++) {
+					if (cell_points[i] != point) {
+						push(centers[cell_points[i]], 1.0);
+					}
+				}
+				continue;
+			}
+			const double dx = p.x - cell.center_of_mass.x;
+			const double dy = p.y - cell.center_of_mass.y;
+			if (cell.size * cell.size < theta2 * (dx * dx + dy * dy)) {
+				push(cell.center_of_mass, cell.mass);
+				continue;
+			}
+			for (int child : cell.children) {
+				if (child != -1) {
+					stack[top++] = child;
+				}
+			}
+		}
+		return force;
+	}
+
+	void ForceLayout::Publish(bool finished)
+	{
+		std::vector<std::pair<int, ImVec2>> positions;
+		positions.reserve(ids.size());
+		for (size_t i = 0; i < ids.size(); i++) {
+			positions.push_back({ ids[i], ImVec2(static_cast<float>(centers[i].x - half_sizes[i].x), static_cast<float>(centers[i].y - half_sizes[i].y)) });
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		published.swap(positions);
+		published_finished = finished;
+		published_iteration++;
+	}
+}
@@ -0,0 +1,128 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/******************************************************************************
+ *               Spreading the nodes out with forces, live
+ *
+ *   For conversations that loop and cross link too much for layers, see
+ *   graph_layout.h. Every node pushes every other away and connected nodes
+ *   pull each other closer (Fruchterman and Reingold), with a slight pull
+ *   to the middle so unconnected parts don't drift off. Each move is capped
+ *   by a temperature that cools every iteration until the nodes settle.
+ *
+ *   The pushes of all pairs would be quadratic. The nodes go into a
+ *   quadtree instead, and a cell far enough from a node, compared to its
+ *   size, pushes it as a single node at its center of mass (Barnes and Hut),
+ *   so an iteration is O(N log N).
+ *
+ *   Iterations run on a worker thread. The UI takes the latest positions
+ *   once per frame to show the nodes moving, and hands back the fixed nodes,
+ *   the pinned ones and the ones being dragged, which the worker leaves
+ *   where they are.
+ ******************************************************************************/
+
+namespace ede
+{
+	struct ForceLayoutOptions
+	{
+		float ideal_distance = 0.0f; // between connected nodes, 0 to take it from the node sizes
+		float theta = 0.9f;          // a cell pushes as one node once its size is under theta times its distance
+		float gravity = 0.02f;
+		float cooling = 0.97f;       // the temperature is multiplied by it every iteration
+		int   max_iterations = 800;
+	};
+
+	class ForceLayout
+	{
+	public:
+		ForceLayout() = default;
+		~ForceLayout(); // stops the worker
+
+		ForceLayout(const ForceLayout&) = delete;
+		ForceLayout& operator=(const ForceLayout&) = delete;
+
+		// Starts from the nodes' positions, top left corners in grid space like their sizes. Connections are the ones
+		// state has now, later edits aren't followed. A running layout is stopped first
+		void Start(const State& state, const std::unordered_map<int, ImVec2>& positions, const std::unordered_map<int, ImVec2>& sizes,
+			const ForceLayoutOptions& options = {});
+		void Stop();
+
+		// started, and the last positions weren't taken yet
+		bool IsRunning() const { return running; }
+		int Iteration() const { return published_iteration.load(); }
+
+		// Nodes that don't move, at these top left corners. Replaces the previous ones, the next iteration picks them up
+		void SetFixedNodes(std::vector<std::pair<int, ImVec2>> fixed);
+
+		// The latest positions if an iteration finished since the last call, top left corners by node id.
+		// After the one with finished set there are no more
+		bool TakePositions(std::vector<std::pair<int, ImVec2>>& positions, bool& finished);
+
+	private:
+		struct Vec
+		{
+			double x = 0.0, y = 0.0;
+		};
+
+		// flat, children are -1 when missing. Leaves hold a range of points, more than one only at the depth limit
+		struct Cell
+		{
+			Vec    center_of_mass;
+			double mass = 0.0;
+			double size = 0.0;
+			int    children[4] = { -1, -1, -1, -1 };
+			int    first = 0;
+			int    count = 0;
+		};
+
+		// worker side
+		void Run();
+		void Iterate();
+		int BuildCell(int first, int last, Vec corner, double size, int depth);
+		Vec Repulsion(int point) const;
+		void Publish(bool finished);
+
+		std::vector<int>                 ids;
+		std::vector<Vec>                 half_sizes;
+		std::vector<Vec>                 centers;
+		std::vector<Vec>                 displacements;
+		std::vector<std::pair<int, int>> edges; // each connection once, whatever its direction
+		std::vector<uint8_t>             fixed;
+		std::vector<Cell>                cells;
+		std::vector<int>                 cell_points; // point indices, leaves point into it
+		std::unordered_map<int, int>     index_of;
+		Vec                              middle;
+		double                           ideal_distance = 1.0;
+		double                           temperature = 0.0;
+		ForceLayoutOptions               options;
+
+		// handed over between the threads
+		std::thread                         worker;
+		std::atomic<bool>                   stopping = false;
+		std::mutex                          mutex;
+		std::vector<std::pair<int, ImVec2>> published;
+		bool                                published_finished = false;
+		std::atomic<int>                    published_iteration = 0;
+		std::vector<std::pair<int, ImVec2>> fixed_nodes;
+		bool                                fixed_nodes_changed = false;
+
+		// UI side
+		int  taken_iteration = 0;
+		bool running = false;
+	};
+}
@@ -0,0 +1,491 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "graph_layout.h"
+#include "state_hash.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+
+namespace ede
+{
+	namespace
+	{
+		// vertices per layer, in order
+		using Ordering = std::vector<std::vector<int>>;
+
+		// Real nodes are vertices 0 to real_count - 1 in id order, the invisible ones come after.
+		// Only read once built, the restarts share it
+		struct LayeredGraph
+		{
+			size_t                        real_count = 0;
+			std::vector<int>              layer_of;
+			std::vector<float>            height;
+			std::vector<std::vector<int>> up;   // neighbours in the previous layer
+			std::vector<std::vector<int>> down; // neighbours in the next layer
+			Ordering                      layers; // the search's order, where the first restart starts
+		};
+
+		struct RestartResult
+		{
+			Ordering order;
+			size_t   crossings = 0;
+		};
+
+		// the invisible nodes of long connections, past this many a connection is left out of the ordering
+		size_t DummyBudget(size_t node_count)
+		{
+			return node_count * 8 + 1024;
+		}
+
+		void UpdatePositions(const std::vector<int>& layer, std::vector<int>& pos)
+		{
+			for (size_t i = 0; i < layer.size(); i++) {
+				pos[layer[i]] = static_cast<int>(i);
+			}
+		}
+
+		// Two segments between a layer and the next cross when their ends are in opposite orders. With the segments in the
+		// order of their upper ends, that's every lower end smaller than one before it, counted with a Fenwick tree
+		size_t CountCrossings(const LayeredGraph& graph, const Ordering& order, const std::vector<int>& pos, std::vector<int>& ends, std::vector<int>& tree)
+		{
+			size_t crossings = 0;
+			for (size_t layer = 0; layer + 1 < order.size(); layer++) {
+				ends.clear();
+				for (int v : order[layer]) {
+					const size_t first = ends.size();
+					for (int w : graph.down[v]) {
+						ends.push_back(pos[w]);
+					}
+					std::sort(ends.begin() + first, ends.end());
+				}
+
+				const int size = static_cast<int>(order[layer + 1].size());
+				tree.assign(size + 1, 0);
+				for (size_t i = 0; i < ends.size(); i++) {
+					size_t not_greater = 0;
+					for (int j = ends[i] + 1; j > 0; j -= j & -j) {
+						not_greater += tree[j];
+					}
+					crossings += i - not_greater;
+					for (int j = ends[i] + 1; j <= size; j += j & -j) {
+						tree[j]++;
+					}
+				}
+			}
+			return crossings;
+		}
+
+		// Orders the layer by the mean position of each vertex's neighbours, vertices without any keep their place
+		void SortByBarycenter(std::vector<int>& layer, const std::vector<std::vector<int>>& neighbours, std::vector<int>& pos, std::vector<std::pair<double, int>>& keys)
+		{
+			keys.clear();
+			for (size_t i = 0; i < layer.size(); i++) {
+				const std::vector<int>& adjacent = neighbours[layer[i]];
+				double key = static_cast<double>(i);
+				if (!adjacent.empty()) {
+					double sum = 0.0;
+					for (int w : adjacent) {
+						sum += pos[w];
+					}
+					key = sum / adjacent.size();
+				}
+				keys.push_back({ key, layer[i] });
+			}
+			std::stable_sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+			for (size_t i = 0; i < keys.size(); i++) {
+				layer[i] = keys[i].second;
+			}
+			UpdatePositions(layer, pos);
+		}
+
+		// Another start for the sweeps, still one that keeps branches together: the order a depth first search finds the
+		// vertices in, going through each vertex's next ones in a shuffled order
+		void SearchOrder(const LayeredGraph& graph, uint32_t seed, Ordering& order)
+		{
+			std::mt19937 rng(seed);
+			std::vector<int> found(graph.layer_of.size(), -1);
+			std::vector<int> stack, next;
+			int counter = 0;
+
+			std::vector<int> starts = graph.layers.front();
+			std::shuffle(starts.begin(), starts.end(), rng);
+			auto search = [&](int start) {
+				stack.push_back(start);
+				while (!stack.empty()) {
+					const int v = stack.back();
+					stack.pop_back();
+					if (found[v] != -1) {
+						continue;
+					}
+					found[v] = counter++;
+					next = graph.down[v];
+					std::shuffle(next.begin(), next.end(), rng);
+					stack.insert(stack.end(), next.begin(), next.end());
+				}
+			};
+			for (int start : starts) {
+				search(start);
+			}
+			// what only the turned around connections lead to starts past the first layer
+			for (const std::vector<int>& layer : graph.layers) {
+				for (int v : layer) {
+					search(v);
+				}
+			}
+
+			for (std::vector<int>& layer : order) {
+				std::sort(layer.begin(), layer.end(), [&found](int a, int b) { return found[a] < found[b]; });
+			}
+		}
+
+		// Sweeps down then up until a pair of sweeps doesn't beat the best order twice in a row
+		RestartResult MinimizeCrossings(const LayeredGraph& graph, int restart, int sweeps)
+		{
+			Ordering order = graph.layers;
+			if (restart > 0) {
+				SearchOrder(graph, static_cast<uint32_t>(restart), order);
+			}
+
+			std::vector<int> pos(graph.layer_of.size());
+			for (const std::vector<int>& layer : order) {
+				UpdatePositions(layer, pos);
+			}
+			std::vector<int> ends, tree;
+			std::vector<std::pair<double, int>> keys;
+
+			RestartResult best{ order, CountCrossings(graph, order, pos, ends, tree) };
+			int stale = 0;
+			for (int sweep = 0; sweep < sweeps && best.crossings > 0; sweep++) {
+				for (size_t layer = 1; layer < order.size(); layer++) {
+					SortByBarycenter(order[layer], graph.up, pos, keys);
+				}
+				for (size_t layer = order.size() - 1; layer-- > 0;) {
+					SortByBarycenter(order[layer], graph.down, pos, keys);
+				}
+
+				const size_t crossings = CountCrossings(graph, order, pos, ends, tree);
+				if (crossings < best.crossings) {
+					best.order = order;
+					best.crossings = crossings;
+					stale = 0;
+				}
+				else if (++stale == 2) {
+					break;
+				}
+			}
+			return best;
+		}
+
+		// Puts the layer's tops as close to desired as they get, keeping their order and each one at least gap below the
+		// previous one's bottom. Shifted by how far each has to be from the first, the tops only have to not decrease,
+		// which pooling adjacent violators solves exactly
+		void PlaceLayer(const std::vector<int>& layer, const LayeredGraph& graph, const std::vector<double>& desired, float node_gap, std::vector<double>& y)
+		{
+			struct Block
+			{
+				double sum;
+				size_t count;
+				double Value() const { return sum / count; }
+			};
+			std::vector<double> offsets(layer.size());
+			std::vector<Block> blocks;
+			blocks.reserve(layer.size());
+
+			double offset = 0.0;
+			for (size_t i = 0; i < layer.size(); i++) {
+				const int v = layer[i];
+				if (i > 0) {
+					const int previous = layer[i - 1];
+					const bool both_invisible = static_cast<size_t>(v) >= graph.real_count && static_cast<size_t>(previous) >= graph.real_count;
+					offset += graph.height[previous] + (both_invisible ? node_gap * 0.5f : node_gap);
+				}
+				offsets[i] = offset;
+
+				blocks.push_back({ desired[v] - offset, 1 });
+				while (blocks.size() > 1 && blocks[blocks.size() - 2].Value() > blocks.back().Value()) {
+					blocks[blocks.size() - 2].sum += blocks.back().sum;
+					blocks[blocks.size() - 2].count += blocks.back().count;
+					blocks.pop_back();
+				}
+			}
+
+			size_t i = 0;
+			for (const Block& block : blocks) {
+				for (size_t j = 0; j < block.count; j++, i++) {
+					y[layer[i]] = block.Value() + offsets[i];
+				}
+			}
+		}
+
+		// where each vertex of the layer would like its top, centered on its neighbours. Vertices without any stay put
+		void DesiredTops(const LayeredGraph& graph, const std::vector<int>& layer, bool use_up, bool use_down, const std::vector<double>& y, std::vector<double>& desired)
+		{
+			for (int v : layer) {
+				double sum = 0.0;
+				size_t count = 0;
+				auto add = [&](const std::vector<int>& adjacent) {
+					for (int w : adjacent) {
+						sum += y[w] + graph.height[w] * 0.5;
+					}
+					count += adjacent.size();
+				};
+				if (use_up) add(graph.up[v]);
+				if (use_down) add(graph.down[v]);
+				desired[v] = count == 0 ? y[v] : sum / count - graph.height[v] * 0.5;
+			}
+		}
+	}
+
+	LayoutResult LayeredLayout(const State& state, const std::unordered_map<int, ImVec2>& node_sizes, const LayoutOptions& options)
+	{
+		auto start = std::chrono::steady_clock::now();
+		LayoutResult result;
+
+		const std::vector<const Node*> nodes = NodesInIdOrder(state);
+		const size_t n = nodes.size();
+		if (n == 0) {
+			return result;
+		}
+		std::unordered_map<int, int> index_of;
+		index_of.reserve(n);
+		for (size_t i = 0; i < n; i++) {
+			index_of[nodes[i]->id] = static_cast<int>(i);
+		}
+
+		std::vector<std::vector<int>> out(n);
+		for (size_t i = 0; i < n; i++) {
+			auto connect = [&](int target_id) {
+				auto it = index_of.find(target_id);
+				if (it != index_of.end() && it->second != static_cast<int>(i)) {
+					out[i].push_back(it->second);
+				}
+			};
+			connect(nodes[i]->nextNodeId);
+			for (int response_id : nodes[i]->responses) {
+				connect(response_id);
+			}
+			std::sort(out[i].begin(), out[i].end());
+			out[i].erase(std::unique(out[i].begin(), out[i].end()), out[i].end());
+		}
+
+		/******************************************************************************
+		 *   1. break the loops, from node 0 first, then from every node it doesn't reach
+		 ******************************************************************************/
+		std::vector<std::pair<int, int>> edges; // turned around where they went back
+		std::vector<int> preorder(n, -1);
+		{
+			enum : uint8_t { Unvisited, OnPath, Done };
+			std::vector<uint8_t> visit(n, Unvisited);
+			std::vector<std::pair<int, size_t>> stack;
+			int counter = 0;
+
+			auto search = [&](int start) {
+				visit[start] = OnPath;
+				preorder[start] = counter++;
+				stack.push_back({ start, 0 });
+				while (!stack.empty()) {
+					const int v = stack.back().first;
+					const size_t next = stack.back().second++;
+					if (next == out[v].size()) {
+						visit[v] = Done;
+						stack.pop_back();
+						continue;
+					}
+					const int w = out[v][next];
+					if (visit[w] == OnPath) {
+						edges.push_back({ w, v });
+					}
+					else {
+						edges.push_back({ v, w });
+						if (visit[w] == Unvisited) {
+							visit[w] = OnPath;
+							preorder[w] = counter++;
+							stack.push_back({ w, 0 });
+						}
+					}
+				}
+			};
+
+			auto root = index_of.find(0);
+			if (root != index_of.end()) {
+				search(root->second);
+			}
+			for (size_t i = 0; i < n; i++) {
+				if (visit[i] == Unvisited) {
+					search(static_cast<int>(i));
+				}
+			}
+			// a turned around connection can double one going the other way
+			std::sort(edges.begin(), edges.end());
+			edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+		}
+
+		/******************************************************************************
+		 *   2. layers, by longest path in topological order
+		 ******************************************************************************/
+		LayeredGraph graph;
+		graph.real_count = n;
+		graph.layer_of.assign(n, 0);
+		{
+			std::vector<int> in_degree(n, 0);
+			std::vector<size_t> first(n + 1, 0); // edges are sorted by their start
+			for (const auto& [from, to] : edges) {
+				in_degree[to]++;
+				first[from + 1]++;
+			}
+			for (size_t i = 0; i < n; i++) {
+				first[i + 1] += first[i];
+			}
+
+			std::vector<int> ready;
+			for (size_t i = 0; i < n; i++) {
+				if (in_degree[i] == 0) {
+					ready.push_back(static_cast<int>(i));
+				}
+			}
+			while (!ready.empty()) {
+				const int v = ready.back();
+				ready.pop_back();
+				for (size_t e = first[v]; e < first[v + 1]; e++) {
+					const int w = edges[e].second;
+					graph.layer_of[w] = std::max(graph.layer_of[w], graph.layer_of[v] + 1);
+					if (--in_degree[w] == 0) {
+						ready.push_back(w);
+					}
+				}
+			}
+		}
+
+		// invisible nodes for every layer a connection skips, placed in the order of the node it starts from
+		std::vector<double> initial_key(n);
+		for (size_t i = 0; i < n; i++) {
+			initial_key[i] = preorder[i];
+		}
+		graph.height.resize(n);
+		for (size_t i = 0; i < n; i++) {
+			auto size = node_sizes.find(nodes[i]->id);
+			graph.height[i] = size != node_sizes.end() && size->second.y > 0.0f ? size->second.y : options.default_node_size.y;
+		}
+		graph.up.resize(n);
+		graph.down.resize(n);
+
+		const size_t dummy_budget = DummyBudget(n);
+		for (const auto& [from, to] : edges) {
+			const size_t span = static_cast<size_t>(graph.layer_of[to] - graph.layer_of[from]);
+			if (span - 1 > dummy_budget - result.dummy_count) {
+				continue;
+			}
+			int previous = from;
+			for (size_t step = 1; step < span; step++) {
+				const int dummy = static_cast<int>(graph.layer_of.size());
+				graph.layer_of.push_back(graph.layer_of[from] + static_cast<int>(step));
+				graph.height.push_back(0.0f);
+				graph.up.push_back({ previous });
+				graph.down.push_back({});
+				graph.down[previous].push_back(dummy);
+				initial_key.push_back(preorder[from]);
+				previous = dummy;
+				result.dummy_count++;
+			}
+			graph.down[previous].push_back(to);
+			graph.up[to].push_back(previous);
+		}
+
+		const size_t vertex_count = graph.layer_of.size();
+		result.layer_count = static_cast<size_t>(*std::max_element(graph.layer_of.begin(), graph.layer_of.begin() + n)) + 1;
+		graph.layers.resize(result.layer_count);
+		for (size_t v = 0; v < vertex_count; v++) {
+			graph.layers[graph.layer_of[v]].push_back(static_cast<int>(v));
+		}
+		for (std::vector<int>& layer : graph.layers) {
+			std::stable_sort(layer.begin(), layer.end(), [&initial_key](int a, int b) { return initial_key[a] < initial_key[b]; });
+		}
+
+		/******************************************************************************
+		 *   3. orderings with few crossings, the restarts spread over the cores
+		 ******************************************************************************/
+		const int restarts = std::max(1, options.restarts);
+		std::vector<RestartResult> restart_results(restarts);
+		{
+			std::atomic<int> next_restart = 0;
+			auto work = [&]() {
+				for (int restart = next_restart++; restart < restarts; restart = next_restart++) {
+					restart_results[restart] = MinimizeCrossings(graph, restart, options.sweeps);
+				}
+			};
+			// a small graph is sorted before a thread would have started
+			const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+			const unsigned thread_count = vertex_count < 256 ? 1u : std::min(cores, static_cast<unsigned>(restarts));
+			std::vector<std::thread> workers;
+			for (unsigned i = 1; i < thread_count; i++) {
+				workers.emplace_back(work);
+			}
+			work();
+			for (std::thread& worker : workers) {
+				worker.join();
+			}
+		}
+		// the lowest restart wins a tie, so the layout is the same whatever the number of threads
+		const RestartResult& best = *std::min_element(restart_results.begin(), restart_results.end(),
+			[](const RestartResult& a, const RestartResult& b) { return a.crossings < b.crossings; });
+		result.crossings = best.crossings;
+
+		/******************************************************************************
+		 *   4. coordinates
+		 ******************************************************************************/
+		std::vector<float> layer_x(result.layer_count, 0.0f);
+		{
+			std::vector<float> layer_width(result.layer_count, 0.0f);
+			for (size_t i = 0; i < n; i++) {
+				auto size = node_sizes.find(nodes[i]->id);
+				const float width = size != node_sizes.end() && size->second.x > 0.0f ? size->second.x : options.default_node_size.x;
+				layer_width[graph.layer_of[i]] = std::max(layer_width[graph.layer_of[i]], width);
+			}
+			for (size_t layer = 1; layer < result.layer_count; layer++) {
+				layer_x[layer] = layer_x[layer - 1] + layer_width[layer - 1] + options.layer_gap;
+			}
+		}
+
+		// stacked first, then pulled towards the neighbours on the left, on the right, and both
+		std::vector<double> y(vertex_count, 0.0), desired(vertex_count, 0.0);
+		for (const std::vector<int>& layer : best.order) {
+			PlaceLayer(layer, graph, desired, options.node_gap, y);
+		}
+		auto place = [&](const std::vector<int>& layer, bool use_up, bool use_down) {
+			DesiredTops(graph, layer, use_up, use_down, y, desired);
+			PlaceLayer(layer, graph, desired, options.node_gap, y);
+		};
+		for (int pass = 0; pass < 2; pass++) {
+			for (const std::vector<int>& layer : best.order) {
+				place(layer, true, false);
+			}
+			for (size_t layer = best.order.size(); layer-- > 0;) {
+				place(best.order[layer], false, true);
+			}
+		}
+		for (const std::vector<int>& layer : best.order) {
+			place(layer, true, true);
+		}
+
+		double top = y[0];
+		for (size_t i = 0; i < n; i++) {
+			top = std::min(top, y[i]);
+		}
+		result.positions.reserve(n);
+		for (size_t i = 0; i < n; i++) {
+			result.positions.push_back({ nodes[i]->id, ImVec2(layer_x[graph.layer_of[i]], static_cast<float>(y[i] - top)) });
+		}
+
+		result.duration_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+}
@@ -0,0 +1,61 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/******************************************************************************
+ *                 Arranging the nodes in layers, left to right
+ *
+ *   A layered (Sugiyama) layout, the way the conversation reads: node 0 in
+ *   the first layer, every node at least one layer right of the nodes that
+ *   lead to it.
+ *
+ *   1. Loops are broken by turning around the connections a depth first
+ *      search from node 0 finds going back to a node it's still in.
+ *   2. Each node's layer is the longest path to it. Connections spanning
+ *      several layers get a chain of invisible nodes, one per layer.
+ *   3. Nodes in a layer are reordered to cut down the crossings, sweeping
+ *      the layers back and forth and sorting each by the mean position of
+ *      its neighbours in the previous one. Sweeps only find a local minimum,
+ *      so several start from different orders, one per thread, and the one
+ *      ending with the fewest crossings wins. The first starts from the
+ *      search's order, the others from searches going through the branches
+ *      in shuffled orders, seeded so the layout doesn't depend on the
+ *      number of cores.
+ *   4. Layers are placed side by side as wide as their widest node. In a
+ *      layer, nodes keep their order and go as close as possible to their
+ *      neighbours without overlapping (an isotonic regression).
+ ******************************************************************************/
+
+namespace ede
+{
+	struct LayoutOptions
+	{
+		ImVec2 default_node_size = ImVec2(260.0f, 150.0f); // for nodes without a known size
+		float  layer_gap = 120.0f; // horizontal space between layers
+		float  node_gap = 40.0f;   // vertical space between nodes of a layer
+		int    sweeps = 24;        // most down and up sweep pairs per restart, they stop once they stop helping
+		int    restarts = 8;       // orderings tried, spread over the cores
+	};
+
+	struct LayoutResult
+	{
+		std::vector<std::pair<int, ImVec2>> positions; // node id -> top left corner, in id order
+		size_t layer_count = 0;
+		size_t dummy_count = 0; // invisible nodes of connections spanning several layers
+		size_t crossings = 0;   // of the chosen order, counting the invisible nodes' segments
+		double duration_ms = 0.0;
+	};
+
+	// sizes are grid space, nodes missing from node_sizes or with an empty size get options.default_node_size
+	LayoutResult LayeredLayout(const State& state, const std::unordered_map<int, ImVec2>& node_sizes, const LayoutOptions& options = {});
+}
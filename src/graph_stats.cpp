@@ -0,0 +1,146 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "graph_stats.h"
+#include <nlohmann/json.hpp>
+
+namespace ede
+{
+	size_t CountWords(std::string_view text)
+	{
+		size_t words = 0;
+		bool in_word = false;
+		for (char c : text) {
+			const bool space = c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+			words += !space && !in_word;
+			in_word = !space;
+		}
+		return words;
+	}
+
+	std::string GraphStatsJson(const GraphStats& stats, const PathAnalysis& paths, const std::map<std::string, size_t>& callback_uses)
+	{
+		nlohmann::ordered_json j;
+		j["nodes"] = stats.node_count;
+		j["speech_nodes"] = stats.speech_count;
+		j["response_nodes"] = stats.response_count;
+		j["connections"] = stats.connection_count;
+		j["average_branching"] = stats.AverageBranching();
+		j["words"] = stats.word_count;
+		j["max_depth"] = paths.max_depth;
+		j["longest_playthrough"] = paths.longest_path;
+		j["playthroughs"] = paths.path_count;
+		j["playthroughs_saturated"] = paths.path_count_saturated;
+		j["loops"] = paths.loops.size();
+		j["nodes_in_loops"] = paths.nodes_in_loops;
+		j["callback_uses"] = stats.callback_uses;
+		j["callbacks"] = callback_uses;
+		return j.dump(4);
+	}
+
+	GraphStatsTracker::Contribution GraphStatsTracker::ConnectionsAndCallbacks(const Node& node, size_t words)
+	{
+		Contribution contribution;
+		contribution.type = node.nodeType;
+		contribution.words = words;
+		contribution.connections = (node.nextNodeId != -1 ? 1 : 0) + node.responses.size();
+		contribution.callbacks = node.selected_callbacks.size();
+		return contribution;
+	}
+
+	void GraphStatsTracker::Add(const Contribution& contribution)
+	{
+		stats.node_count++;
+		(contribution.type == NodeType::Speech ? stats.speech_count : stats.response_count)++;
+		stats.word_count += contribution.words;
+		stats.connection_count += contribution.connections;
+		stats.leading_node_count += contribution.connections > 0;
+		stats.callback_uses += contribution.callbacks;
+	}
+
+	void GraphStatsTracker::Remove(const Contribution& contribution)
+	{
+		stats.node_count--;
+		(contribution.type == NodeType::Speech ? stats.speech_count : stats.response_count)--;
+		stats.word_count -= contribution.words;
+		stats.connection_count -= contribution.connections;
+		stats.leading_node_count -= contribution.connections > 0;
+		stats.callback_uses -= contribution.callbacks;
+	}
+
+	// lazy texts count no words until the scan has read them
+	void GraphStatsTracker::OnStateReset(const State& state)
+	{
+		stats = {};
+		contributions.clear();
+		contributions.reserve(state.nodes.size());
+		scan.Start(state, CountWords);
+		stats.counting_words = !scan.Pending().empty();
+		for (const auto& [id, node] : state.nodes) {
+			if (node) {
+				const Contribution contribution = ConnectionsAndCallbacks(*node, node->HasLazyText() ? 0 : CountWords(node->text));
+				Add(contribution);
+				contributions[id] = contribution;
+			}
+		}
+	}
+
+	void GraphStatsTracker::Update(bool wait)
+	{
+		std::vector<std::pair<int, size_t>> read;
+		if (!scan.Take(read, wait)) {
+			return;
+		}
+		for (const auto& [node_id, words] : read) {
+			auto it = contributions.find(node_id);
+			if (it != contributions.end()) {
+				stats.word_count += words;
+				it->second.words = words;
+			}
+		}
+		stats.counting_words = false;
+	}
+
+	void GraphStatsTracker::OnNodeAdded(const Node& node)
+	{
+		OnNodeRemoved(node.id);
+		const Contribution contribution = ConnectionsAndCallbacks(node, CountWords(node.TextView()));
+		Add(contribution);
+		contributions[node.id] = contribution;
+	}
+
+	void GraphStatsTracker::OnNodeRemoved(int node_id)
+	{
+		scan.Forget(node_id);
+		auto it = contributions.find(node_id);
+		if (it != contributions.end()) {
+			Remove(it->second);
+			contributions.erase(it);
+		}
+	}
+
+	// only a text edit counts the node's words again, the rest is a few sizes
+	void GraphStatsTracker::OnNodeChanged(const Node& node, NodeChange change)
+	{
+		if (change == NodeChange::Position) {
+			return;
+		}
+		auto it = contributions.find(node.id);
+		if (it == contributions.end()) {
+			OnNodeAdded(node);
+			return;
+		}
+		if (change == NodeChange::Text) {
+			scan.Forget(node.id);
+		}
+		const size_t words = change == NodeChange::Text ? CountWords(node.TextView()) : it->second.words;
+		Remove(it->second);
+		it->second = ConnectionsAndCallbacks(node, words);
+		Add(it->second);
+	}
+}
@@ -0,0 +1,87 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "lazy_text_scan.h"
+#include "path_analysis.h"
+#include "state_listener.h"
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/******************************************************************************
+ *                   Counts of the conversation, kept as it's edited
+ *
+ *   Every node adds its type, words, connections and callback tags to the
+ *   totals, and what it added is kept so an edit takes the old values out
+ *   and puts the new ones in, without going over the other nodes. Reading
+ *   the totals costs nothing. Words of the texts a lazy load left in their
+ *   file are counted in the background (lazy_text_scan.h) and added to the
+ *   totals once they're all read. Depth and the longest playthrough depend on
+ *   the whole graph and come from path_analysis.h, which only runs again
+ *   when a connection changes.
+ ******************************************************************************/
+
+namespace ede
+{
+	struct GraphStats
+	{
+		size_t node_count = 0;
+		size_t speech_count = 0;
+		size_t response_count = 0;
+		size_t connection_count = 0;   // next nodes and responses
+		size_t leading_node_count = 0; // nodes with at least one connection
+		size_t word_count = 0;
+		size_t callback_uses = 0;      // tags on nodes, each node's each tag
+		bool   counting_words = false; // lazy texts are still being read, word_count leaves them out
+
+		// ways on from a node that has any
+		double AverageBranching() const { return leading_node_count == 0 ? 0.0 : static_cast<double>(connection_count) / leading_node_count; }
+	};
+
+	// words of a text, the runs of characters between ASCII whitespace
+	size_t CountWords(std::string_view text);
+
+	// The statistics as JSON, for dashboards, with the uses of every declared callback tag
+	std::string GraphStatsJson(const GraphStats& stats, const PathAnalysis& paths, const std::map<std::string, size_t>& callback_uses);
+
+	class GraphStatsTracker : public StateListener
+	{
+	public:
+		const GraphStats& Stats() const { return stats; }
+
+		// Adds the words of the lazy texts once the background scan has read them all. Meant to be called once per frame
+		// from the UI thread, wait blocks until the scan is done, for when the texts' file is about to be replaced
+		void Update(bool wait = false);
+
+		void OnStateReset(const State& state) override;
+		void OnNodeAdded(const Node& node) override;
+		void OnNodeRemoved(int node_id) override;
+		void OnNodeChanged(const Node& node, NodeChange change) override;
+
+	private:
+		// what a node adds to the totals
+		struct Contribution
+		{
+			NodeType type = NodeType::Speech;
+			size_t   words = 0;
+			size_t   connections = 0;
+			size_t   callbacks = 0;
+		};
+
+		void Add(const Contribution& contribution);
+		void Remove(const Contribution& contribution);
+		static Contribution ConnectionsAndCallbacks(const Node& node, size_t words);
+
+		GraphStats                            stats;
+		std::unordered_map<int, Contribution> contributions;
+		LazyTextScan<size_t>                  scan; // words of the texts left out of the reset
+	};
+}
@@ -0,0 +1,115 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include <atomic>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/******************************************************************************
+ *              Reading lazily loaded texts off the UI thread
+ *
+ *   A lazy load leaves the texts in the mapped file (TextLoading::Lazy),
+ *   and reading all of them pages the whole file in. Listeners that need
+ *   something out of every text leave the lazy ones out of their reset
+ *   and hand them to a scan, which reads them on a worker thread. The
+ *   results are taken on the UI thread once they're all in, except for
+ *   the nodes that were edited or removed in the meantime.
+ ******************************************************************************/
+
+namespace ede
+{
+	template <typename Result>
+	class LazyTextScan
+	{
+	public:
+		using Compute = Result (*)(std::string_view text);
+
+		LazyTextScan() = default;
+		~LazyTextScan() { Cancel(); }
+
+		LazyTextScan(const LazyTextScan&) = delete;
+		LazyTextScan& operator=(const LazyTextScan&) = delete;
+
+		// Drops the previous scan and starts reading the state's lazy texts through compute.
+		// The file they're in stays mapped until the scan is done or canceled
+		void Start(const State& state, Compute compute) {
+			Cancel();
+			std::vector<std::pair<int, std::string_view>> texts;
+			for (const auto& [id, node] : state.nodes) {
+				if (node && node->HasLazyText()) {
+					texts.emplace_back(id, node->lazy_text);
+					pending.insert(id);
+				}
+			}
+			if (texts.empty()) {
+				return;
+			}
+			worker = std::thread([this, texts = std::move(texts), storage = state.text_storage, compute]() {
+				std::vector<std::pair<int, Result>> read;
+				read.reserve(texts.size());
+				for (const auto& [id, text] : texts) {
+					if (canceled) {
+						break;
+					}
+					read.emplace_back(id, compute(text));
+				}
+				results = std::move(read);
+				done = true;
+			});
+		}
+
+		void Cancel() {
+			if (worker.joinable()) {
+				canceled = true;
+				worker.join();
+			}
+			canceled = false;
+			done = false;
+			results.clear();
+			pending.clear();
+		}
+
+		// nodes whose text is still being read, in no particular order
+		const std::unordered_set<int>& Pending() const { return pending; }
+
+		// the node was edited or removed, what the scan reads of it is out of date
+		void Forget(int node_id) { pending.erase(node_id); }
+
+		// Hands over what was read of the nodes still pending, once the whole scan is done.
+		// wait blocks until then, for when the texts' file is about to be replaced
+		bool Take(std::vector<std::pair<int, Result>>& out, bool wait) {
+			if (!worker.joinable() || (!wait && !done)) {
+				return false;
+			}
+			worker.join();
+			out.clear();
+			for (auto& [id, result] : results) {
+				if (pending.contains(id)) {
+					out.emplace_back(id, std::move(result));
+				}
+			}
+			done = false;
+			results.clear();
+			pending.clear();
+			return true;
+		}
+
+	private:
+		std::thread                         worker;
+		std::atomic<bool>                   done = false;
+		std::atomic<bool>                   canceled = false;
+		std::vector<std::pair<int, Result>> results; // written by the worker before done
+		std::unordered_set<int>             pending;
+	};
+}
@@ -106,6 +106,7 @@
      ImVec4 clear_color = ImVec4(0.0f, 0.0f, 0.0f, 1.00f);
      
      bool done = false;
+     bool quit_requested = false; // the editor decides at the end of the frame, it may still have work to save
      bool hasRootSpawned = false;
      ImGui::LoadIniSettingsFromMemory(DEFAULT_INI);
 	 ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 3.0f);
@@ -131,10 +132,10 @@
          {
              ImGui_ImplSDL2_ProcessEvent(&event);
              if (event.type == SDL_QUIT)
-                 done = true;
+                 quit_requested = true;
              if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE &&
                  event.window.windowID == SDL_GetWindowID(window))
-                 done = true;
+                 quit_requested = true;
 			 if (event.type == SDL_KEYDOWN)
 			 {
 				 if ((event.key.keysym.mod & KMOD_CTRL) && event.key.keysym.sym == SDLK_x)
@@ -159,6 +160,23 @@
 				 {
 					 ede::ShowNewFilePopup();
 				 }
+				 if ((event.key.keysym.mod & KMOD_CTRL) && event.key.keysym.sym == SDLK_f)
+				 {
+					 ede::OpenSearchWindow();
+				 }
+				 if ((event.key.keysym.mod & KMOD_CTRL) && event.key.keysym.sym == SDLK_l)
+				 {
+					 if (event.key.keysym.mod & KMOD_SHIFT) {
+						 ede::ToggleForceLayout();
+					 }
+					 else {
+						 ede::AutoLayout();
+					 }
+				 }
+				 if ((event.key.keysym.mod & KMOD_CTRL) && event.key.keysym.sym == SDLK_p)
+				 {
+					 ede::TogglePinSelectedNodes();
+				 }
 			 }
          }
  
@@ -198,13 +216,18 @@
 			 ImGui::MarkIniSettingsDirty();
 			 ede::marked_for_UI_reset = false;
          }
+
+         // a conversation that can't be saved keeps the editor open, its notification shows next frame
+         if (quit_requested) {
+             quit_requested = false;
+             done = ede::NodeEditorShutdown();
+         }
      }
  
      // Cleanup
      ImGui::PopStyleVar(1);
      ImGui_ImplOpenGL3_Shutdown();
      ImGui_ImplSDL2_Shutdown();
-     ede::NodeEditorShutdown();
      ImNodes::DestroyContext();
      ImGui::DestroyContext();
  
@@ -0,0 +1,138 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "mapped_file.h"
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ede
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other) {
+			Close();
+			std::swap(data, other.data);
+			std::swap(size, other.size);
+#ifdef _WIN32
+			std::swap(file_handle, other.file_handle);
+			std::swap(mapping_handle, other.mapping_handle);
+#endif
+		}
+		return *this;
+	}
+
+#ifdef _WIN32
+
+	bool MappedFile::Open(const std::string& path)
+	{
+		Close();
+
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping == NULL) {
+			CloseHandle(file);
+			return false;
+		}
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == NULL) {
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		data = static_cast<const uint8_t*>(view);
+		size = static_cast<size_t>(file_size.QuadPart);
+		file_handle = file;
+		mapping_handle = mapping;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data != nullptr) {
+			UnmapViewOfFile(data);
+			CloseHandle(mapping_handle);
+			CloseHandle(file_handle);
+		}
+		data = nullptr;
+		size = 0;
+		file_handle = nullptr;
+		mapping_handle = nullptr;
+	}
+
+#else
+
+	bool MappedFile::Open(const std::string& path)
+	{
+		Close();
+
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0) {
+			close(fd);
+			return false;
+		}
+
+		void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		// the mapping keeps the file alive on its own
+		close(fd);
+		if (view == MAP_FAILED) {
+			return false;
+		}
+
+		data = static_cast<const uint8_t*>(view);
+		size = static_cast<size_t>(info.st_size);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data != nullptr) {
+			munmap(const_cast<uint8_t*>(data), size);
+		}
+		data = nullptr;
+		size = 0;
+	}
+
+#endif
+}
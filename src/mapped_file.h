@@ -0,0 +1,44 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ede
+{
+	// Read-only memory mapping of a whole file, unmapped when destroyed
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// fails for missing and empty files
+		bool Open(const std::string& path);
+		void Close();
+
+		bool           IsOpen() const { return data != nullptr; }
+		const uint8_t* Data() const { return data; }
+		size_t         Size() const { return size; }
+
+	private:
+		const uint8_t* data = nullptr;
+		size_t         size = 0;
+#ifdef _WIN32
+		void*          file_handle = nullptr;
+		void*          mapping_handle = nullptr;
+#endif
+	};
+}
@@ -0,0 +1,703 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "operation_journal.h"
+#include "background_save.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+namespace ede
+{
+	namespace
+	{
+		constexpr char     Magic[4] = { 'E', 'D', 'E', 'J' };
+		// 2: positions are in grid space, version 1 wrote them in screen space at whatever the panning was
+		constexpr uint32_t Version = 2;
+
+		// remembers which journals the running session left open, two lines each. Gone after a clean exit
+		constexpr const char* SessionFile = "journal_session.txt";
+		constexpr const char* AppDirectoryName = "EasyDialogueEditor";
+		constexpr const char* UntitledJournal = "untitled.journal";
+		constexpr const char* JournalExtension = ".journal";
+
+		// compaction waits for at least this much to be appended, small graphs would compact all the time otherwise
+		constexpr uint64_t MinCompactionBytes = 64 * 1024;
+
+		enum class RecordType : uint8_t
+		{
+			Reset = 1,
+			Counters,
+			NodeUpsert,
+			NodeText,
+			NodePosition,
+			NodeRemove,
+			LinkUpsert,
+			LinkRemove,
+			CallbackAdd,
+			CallbackRemove,
+		};
+
+		// Per user, so what's recovered doesn't depend on the directory the editor was started from.
+		// The working directory is only left if the environment doesn't say where the user's data goes
+		std::filesystem::path AppDataDirectory() {
+			std::filesystem::path directory;
+#ifdef _WIN32
+			wchar_t* local_app_data = nullptr;
+			size_t length = 0;
+			if (_wdupenv_s(&local_app_data, &length, L"LOCALAPPDATA") == 0 && local_app_data != nullptr && *local_app_data != L'\0') {
+				directory = std::filesystem::path(local_app_data) / AppDirectoryName;
+			}
+			std::free(local_app_data);
+#else
+			if (const char* data_home = std::getenv("XDG_DATA_HOME"); data_home != nullptr && *data_home != '\0') {
+				directory = std::filesystem::path(data_home) / AppDirectoryName;
+			}
+			else if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+				directory = std::filesystem::path(home) / ".local" / "share" / AppDirectoryName;
+			}
+#endif
+			std::error_code ec;
+			if (!directory.empty() && !std::filesystem::create_directories(directory, ec) && ec) {
+				directory.clear();
+			}
+			return directory;
+		}
+
+		std::string SessionFilePath() {
+			return (AppDataDirectory() / SessionFile).string();
+		}
+
+		std::vector<UnfinishedJournal> ReadSession() {
+			std::vector<UnfinishedJournal> journals;
+			std::ifstream session(SessionFilePath());
+			UnfinishedJournal journal;
+			while (std::getline(session, journal.journal_path) && std::getline(session, journal.document_path)) {
+				if (!journal.journal_path.empty()) {
+					journals.push_back(journal);
+				}
+			}
+			return journals;
+		}
+
+		// the session file goes away with its last journal, a session with none left exited cleanly
+		void WriteSession(const std::vector<UnfinishedJournal>& journals) {
+			if (journals.empty()) {
+				std::remove(SessionFilePath().c_str());
+				return;
+			}
+			std::ofstream session(SessionFilePath(), std::ios::trunc);
+			for (const UnfinishedJournal& journal : journals) {
+				session << journal.journal_path << "\n" << journal.document_path << "\n";
+			}
+		}
+
+		// FNV-1a, enough to tell a torn record from a whole one
+		uint32_t Checksum(const char* data, size_t size) {
+			uint32_t hash = 2166136261u;
+			for (size_t i = 0; i < size; i++) {
+				hash = (hash ^ static_cast<uint8_t>(data[i])) * 16777619u;
+			}
+			return hash;
+		}
+
+		/******************************************************************************
+		 *                                 Encoding
+		 ******************************************************************************/
+
+		class RecordWriter
+		{
+		public:
+			explicit RecordWriter(std::vector<char>& _out) : out(_out) {}
+
+			void Begin(RecordType type) {
+				start = out.size();
+				U32(0); // size, patched in End()
+				U8(static_cast<uint8_t>(type));
+			}
+
+			void End() {
+				uint32_t size = static_cast<uint32_t>(out.size() - start - sizeof(uint32_t));
+				std::memcpy(out.data() + start, &size, sizeof(size));
+				U32(Checksum(out.data() + start + sizeof(uint32_t), size));
+			}
+
+			void U8(uint8_t v) { out.push_back(static_cast<char>(v)); }
+			void U32(uint32_t v) { Raw(&v, sizeof(v)); }
+			void I32(int32_t v) { Raw(&v, sizeof(v)); }
+			void F32(float v) { Raw(&v, sizeof(v)); }
+
+			void Str(std::string_view s) {
+				U32(static_cast<uint32_t>(s.size()));
+				Raw(s.data(), s.size());
+			}
+
+			void Ints(const std::vector<int>& ints) {
+				U32(static_cast<uint32_t>(ints.size()));
+				for (int i : ints) {
+					I32(i);
+				}
+			}
+
+		private:
+			void Raw(const void* data, size_t size) {
+				const char* bytes = static_cast<const char*>(data);
+				out.insert(out.end(), bytes, bytes + size);
+			}
+
+			std::vector<char>& out;
+			size_t             start = 0;
+		};
+
+		void WriteNode(RecordWriter& w, const Node& node) {
+			w.Begin(RecordType::NodeUpsert);
+			w.I32(node.id);
+			w.U8(static_cast<uint8_t>(node.nodeType));
+			w.U8(node.expectesResponse ? 1 : 0);
+			w.I32(node.nextNodeId);
+			w.F32(node.position.x);
+			w.F32(node.position.y);
+			w.Str(node.TextView());
+			w.Ints(node.prevNodeIds);
+			w.Ints(node.responses);
+			w.U32(static_cast<uint32_t>(node.selected_callbacks.size()));
+			for (const std::string& callback : node.selected_callbacks) {
+				w.Str(callback);
+			}
+			w.End();
+		}
+
+		void WriteLink(RecordWriter& w, const Link& link) {
+			w.Begin(RecordType::LinkUpsert);
+			w.I32(link.id);
+			w.I32(link.start_attr);
+			w.I32(link.end_attr);
+			w.End();
+		}
+
+		// the whole state as records, starting from a reset
+		void WriteSnapshot(std::vector<char>& out, const State& state) {
+			RecordWriter w(out);
+			w.Begin(RecordType::Reset);
+			w.End();
+
+			w.Begin(RecordType::Counters);
+			w.I32(state.next_node_id);
+			w.I32(state.next_link_id);
+			w.End();
+
+			for (const std::string& callback : state.callbacks) {
+				w.Begin(RecordType::CallbackAdd);
+				w.Str(callback);
+				w.End();
+			}
+			for (const auto& pair : state.nodes) {
+				if (pair.second) {
+					WriteNode(w, *pair.second);
+				}
+			}
+			for (const auto& pair : state.links) {
+				if (pair.second) {
+					WriteLink(w, *pair.second);
+				}
+			}
+		}
+
+		/******************************************************************************
+		 *                                 Decoding
+		 ******************************************************************************/
+
+		// reads a record's payload, every read fails once the payload runs out
+		class RecordReader
+		{
+		public:
+			RecordReader(const char* _data, size_t _size) : data(_data), size(_size) {}
+
+			bool U8(uint8_t& v) { return Raw(&v, sizeof(v)); }
+			bool U32(uint32_t& v) { return Raw(&v, sizeof(v)); }
+			bool I32(int32_t& v) { return Raw(&v, sizeof(v)); }
+			bool F32(float& v) { return Raw(&v, sizeof(v)); }
+
+			bool Str(std::string& s) {
+				uint32_t length;
+				if (!U32(length) || length > size - offset) {
+					return false;
+				}
+				s.assign(data + offset, length);
+				offset += length;
+				return true;
+			}
+
+			bool Ints(std::vector<int>& ints) {
+				uint32_t count;
+				if (!U32(count) || count > (size - offset) / sizeof(int32_t)) {
+					return false;
+				}
+				ints.resize(count);
+				for (uint32_t i = 0; i < count; i++) {
+					int32_t v;
+					I32(v);
+					ints[i] = v;
+				}
+				return true;
+			}
+
+		private:
+			bool Raw(void* out, size_t n) {
+				if (n > size - offset) {
+					return false;
+				}
+				std::memcpy(out, data + offset, n);
+				offset += n;
+				return true;
+			}
+
+			const char* data;
+			size_t      size;
+			size_t      offset = 0;
+		};
+
+		bool ApplyRecord(State& state, RecordType type, RecordReader& r) {
+			switch (type) {
+			case RecordType::Reset:
+				state = {};
+				return true;
+
+			case RecordType::Counters: {
+				int32_t next_node_id, next_link_id;
+				if (!r.I32(next_node_id) || !r.I32(next_link_id)) return false;
+				state.next_node_id = next_node_id;
+				state.next_link_id = next_link_id;
+				return true;
+			}
+
+			case RecordType::NodeUpsert: {
+				int32_t id, next_node_id;
+				uint8_t node_type, expects_response;
+				float x, y;
+				std::string text;
+				if (!r.I32(id) || !r.U8(node_type) || !r.U8(expects_response) || !r.I32(next_node_id) ||
+					!r.F32(x) || !r.F32(y) || !r.Str(text)) {
+					return false;
+				}
+				auto node = std::make_shared<Node>(id, static_cast<NodeType>(node_type), std::string(), ImVec2(x, y));
+				node->text = std::move(text);
+				node->expectesResponse = expects_response != 0;
+				node->nextNodeId = next_node_id;
+				uint32_t callback_count;
+				if (!r.Ints(node->prevNodeIds) || !r.Ints(node->responses) || !r.U32(callback_count)) {
+					return false;
+				}
+				for (uint32_t i = 0; i < callback_count; i++) {
+					std::string callback;
+					if (!r.Str(callback)) return false;
+					node->selected_callbacks.insert(std::move(callback));
+				}
+				// ids are handed out by incrementing the counters, the highest one seen is the counter
+				state.next_node_id = std::max(state.next_node_id, id);
+				state.nodes[id] = std::move(node);
+				return true;
+			}
+
+			case RecordType::NodeText: {
+				int32_t id;
+				std::string text;
+				if (!r.I32(id) || !r.Str(text)) return false;
+				if (std::shared_ptr<Node> node = state.FindNode(id)) {
+					node->text = std::move(text);
+				}
+				return true;
+			}
+
+			case RecordType::NodePosition: {
+				int32_t id;
+				float x, y;
+				if (!r.I32(id) || !r.F32(x) || !r.F32(y)) return false;
+				if (std::shared_ptr<Node> node = state.FindNode(id)) {
+					node->position = ImVec2(x, y);
+				}
+				return true;
+			}
+
+			case RecordType::NodeRemove: {
+				int32_t id;
+				if (!r.I32(id)) return false;
+				state.nodes.erase(id);
+				return true;
+			}
+
+			case RecordType::LinkUpsert: {
+				int32_t id, start_attr, end_attr;
+				if (!r.I32(id) || !r.I32(start_attr) || !r.I32(end_attr)) return false;
+				state.next_link_id = std::max(state.next_link_id, id);
+				state.links[id] = std::make_shared<Link>(id, start_attr, end_attr);
+				return true;
+			}
+
+			case RecordType::LinkRemove: {
+				int32_t id;
+				if (!r.I32(id)) return false;
+				state.links.erase(id);
+				return true;
+			}
+
+			case RecordType::CallbackAdd: {
+				std::string callback;
+				if (!r.Str(callback)) return false;
+				state.callbacks.insert(std::move(callback));
+				return true;
+			}
+
+			case RecordType::CallbackRemove: {
+				std::string callback;
+				if (!r.Str(callback)) return false;
+				for (auto& pair : state.nodes) {
+					if (pair.second) {
+						pair.second->selected_callbacks.erase(callback);
+					}
+				}
+				state.callbacks.erase(callback);
+				return true;
+			}
+			}
+			return false;
+		}
+
+		void WriteHeader(std::vector<char>& out) {
+			out.insert(out.end(), Magic, Magic + sizeof(Magic));
+			const char* version = reinterpret_cast<const char*>(&Version);
+			out.insert(out.end(), version, version + sizeof(Version));
+		}
+	}
+
+	/******************************************************************************
+	 *                                  Journal
+	 ******************************************************************************/
+
+	OperationJournal::~OperationJournal()
+	{
+		StopCompaction();
+		// a journal destroyed without Close() is an unclean exit, keep it for recovery
+		if (file != nullptr) {
+			std::fclose(file);
+		}
+	}
+
+	std::string OperationJournal::JournalPathFor(const std::string& document_path)
+	{
+		return document_path.empty() ? (AppDataDirectory() / UntitledJournal).string() : document_path + JournalExtension;
+	}
+
+	void OperationJournal::Open(const std::string& journal_path, const std::string& journal_document_path, std::shared_ptr<const State> snapshot)
+	{
+		if (IsOpen()) {
+			Close(true);
+		}
+		path = journal_path;
+		document_path = journal_document_path;
+		StartCompaction(std::move(snapshot));
+	}
+
+	void OperationJournal::Close(bool discard)
+	{
+		if (!IsOpen()) {
+			return;
+		}
+		// a journal left behind must hold everything, the first snapshot included
+		if (discard) {
+			StopCompaction();
+		}
+		else if (compacting) {
+			FinishCompaction();
+		}
+		if (file != nullptr) {
+			if (!discard && !pending.empty()) {
+				std::fwrite(pending.data(), 1, pending.size(), file);
+			}
+			std::fclose(file);
+			file = nullptr;
+		}
+		pending.clear();
+		since_snapshot.clear();
+		compaction_requested = false;
+		snapshot_bytes = 0;
+		appended_bytes = 0;
+
+		if (discard) {
+			Discard(path);
+		}
+		session_written = false;
+		path.clear();
+		document_path.clear();
+	}
+
+	void OperationJournal::Flush(SnapshotCache& snapshots, const State& state)
+	{
+		if (!IsOpen()) {
+			return;
+		}
+		if (compacting && compaction_done) {
+			FinishCompaction();
+		}
+
+		// a crash of the editor loses nothing past this point. The OS may still hold it in its cache,
+		// fsync-ing every frame would cost more than the journal is meant to
+		if (!pending.empty()) {
+			if (file != nullptr) {
+				std::fwrite(pending.data(), 1, pending.size(), file);
+				std::fflush(file);
+				appended_bytes += pending.size();
+			}
+			// the snapshot being written doesn't have them
+			if (compacting) {
+				since_snapshot.insert(since_snapshot.end(), pending.begin(), pending.end());
+			}
+			pending.clear();
+		}
+
+		if (!compacting && (compaction_requested || (file != nullptr && appended_bytes > std::max(snapshot_bytes, MinCompactionBytes)))) {
+			StartCompaction(snapshots.Take(state));
+		}
+	}
+
+	// Writes the snapshot to a temporary file next to the journal and flushes it to the disk, on the worker.
+	// The old journal stays until FinishCompaction replaces it, a crash halfway leaves it intact
+	void OperationJournal::StartCompaction(std::shared_ptr<const State> snapshot)
+	{
+		compacting = true;
+		compaction_requested = false;
+		compaction_done = false;
+		compaction_canceled = false;
+		since_snapshot.clear();
+		compactor = std::thread([this, snapshot = std::move(snapshot), temp_path = path + ".tmp"]() {
+			std::vector<char> bytes;
+			WriteHeader(bytes);
+			WriteSnapshot(bytes, *snapshot);
+
+			bool written = false;
+			if (!compaction_canceled) {
+				std::FILE* temp = std::fopen(temp_path.c_str(), "wb");
+				if (temp != nullptr) {
+					written = std::fwrite(bytes.data(), 1, bytes.size(), temp) == bytes.size() && FlushFileToDisk(temp);
+					written = std::fclose(temp) == 0 && written;
+					if (!written) {
+						std::remove(temp_path.c_str());
+					}
+				}
+			}
+			compaction_bytes = bytes.size();
+			compaction_written = written;
+			compaction_done = true;
+		});
+	}
+
+	// the records journaled while the snapshot was written go after it, then it takes the old journal's place
+	void OperationJournal::FinishCompaction()
+	{
+		compactor.join();
+		compacting = false;
+		if (!compaction_written) {
+			// journaling goes on in the old file, which has every record
+			since_snapshot.clear();
+			return;
+		}
+
+		const std::string temp_path = path + ".tmp";
+		std::FILE* temp = std::fopen(temp_path.c_str(), "ab");
+		bool written = temp != nullptr && std::fwrite(since_snapshot.data(), 1, since_snapshot.size(), temp) == since_snapshot.size();
+		written = temp != nullptr && std::fclose(temp) == 0 && written;
+
+		// Windows won't replace a file that's still open
+		const bool had_file = file != nullptr;
+		if (had_file) {
+			std::fclose(file);
+			file = nullptr;
+		}
+		if (!written || !ReplaceFileAtomically(temp_path, path)) {
+			std::remove(temp_path.c_str());
+			if (had_file) {
+				file = std::fopen(path.c_str(), "ab");
+			}
+			since_snapshot.clear();
+			return;
+		}
+
+		file = std::fopen(path.c_str(), "ab");
+		snapshot_bytes = compaction_bytes;
+		appended_bytes = since_snapshot.size();
+		since_snapshot.clear();
+
+		if (!session_written) {
+			std::vector<UnfinishedJournal> journals = ReadSession();
+			auto it = std::find_if(journals.begin(), journals.end(), [this](const UnfinishedJournal& j) { return j.journal_path == path; });
+			if (it == journals.end()) {
+				journals.push_back({ path, document_path });
+			}
+			else {
+				it->document_path = document_path;
+			}
+			WriteSession(journals);
+			session_written = true;
+		}
+	}
+
+	// waits for the worker, whose snapshot is dropped
+	void OperationJournal::StopCompaction()
+	{
+		if (!compacting) {
+			return;
+		}
+		compaction_canceled = true;
+		compactor.join();
+		compacting = false;
+		since_snapshot.clear();
+		std::remove((path + ".tmp").c_str());
+	}
+
+	std::vector<UnfinishedJournal> OperationJournal::FindUnfinishedJournals()
+	{
+		return ReadSession();
+	}
+
+	void OperationJournal::Discard(const std::string& journal_path)
+	{
+		std::remove(journal_path.c_str());
+		std::vector<UnfinishedJournal> journals = ReadSession();
+		const size_t count = journals.size();
+		std::erase_if(journals, [&](const UnfinishedJournal& j) { return j.journal_path == journal_path; });
+		if (journals.size() != count) {
+			WriteSession(journals);
+		}
+	}
+
+	bool OperationJournal::Replay(const std::string& journal_path, State& out_state)
+	{
+		std::ifstream in(journal_path, std::ios::binary);
+		if (!in.is_open()) {
+			return false;
+		}
+		std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+		if (data.size() < sizeof(Magic) + sizeof(Version) || std::memcmp(data.data(), Magic, sizeof(Magic)) != 0) {
+			return false;
+		}
+		uint32_t version;
+		std::memcpy(&version, data.data() + sizeof(Magic), sizeof(version));
+		if (version != Version) {
+			return false;
+		}
+
+		State state;
+		size_t offset = sizeof(Magic) + sizeof(Version);
+		// a record's size and checksum alone take 8 bytes, a shorter tail is a torn append
+		while (data.size() - offset >= 2 * sizeof(uint32_t)) {
+			uint32_t size;
+			std::memcpy(&size, data.data() + offset, sizeof(size));
+			if (size == 0 || size > data.size() - offset - 2 * sizeof(uint32_t)) {
+				break;
+			}
+			const char* record = data.data() + offset + sizeof(uint32_t);
+			uint32_t checksum;
+			std::memcpy(&checksum, record + size, sizeof(checksum));
+			if (checksum != Checksum(record, size)) {
+				break;
+			}
+
+			RecordReader reader(record + 1, size - 1);
+			if (!ApplyRecord(state, static_cast<RecordType>(record[0]), reader)) {
+				break;
+			}
+			offset += 2 * sizeof(uint32_t) + size;
+		}
+
+		out_state = std::move(state);
+		return true;
+	}
+
+	/******************************************************************************
+	 *                              State changes
+	 ******************************************************************************/
+
+	void OperationJournal::OnStateReset(const State&)
+	{
+		// nothing appended before the reset matters anymore, the next Flush() writes a snapshot
+		pending.clear();
+		compaction_requested = true;
+	}
+
+	void OperationJournal::OnNodeAdded(const Node& node)
+	{
+		RecordWriter w(pending);
+		WriteNode(w, node);
+	}
+
+	void OperationJournal::OnNodeRemoved(int node_id)
+	{
+		RecordWriter w(pending);
+		w.Begin(RecordType::NodeRemove);
+		w.I32(node_id);
+		w.End();
+	}
+
+	void OperationJournal::OnNodeChanged(const Node& node, NodeChange change)
+	{
+		RecordWriter w(pending);
+		switch (change) {
+		case NodeChange::Text:
+			w.Begin(RecordType::NodeText);
+			w.I32(node.id);
+			w.Str(node.TextView());
+			w.End();
+			break;
+		case NodeChange::Position:
+			w.Begin(RecordType::NodePosition);
+			w.I32(node.id);
+			w.F32(node.position.x);
+			w.F32(node.position.y);
+			w.End();
+			break;
+		default:
+			WriteNode(w, node);
+			break;
+		}
+	}
+
+	void OperationJournal::OnLinkAdded(const Link& link)
+	{
+		RecordWriter w(pending);
+		WriteLink(w, link);
+	}
+
+	void OperationJournal::OnLinkRemoved(int link_id)
+	{
+		RecordWriter w(pending);
+		w.Begin(RecordType::LinkRemove);
+		w.I32(link_id);
+		w.End();
+	}
+
+	void OperationJournal::OnCallbackAdded(const std::string& callback)
+	{
+		RecordWriter w(pending);
+		w.Begin(RecordType::CallbackAdd);
+		w.Str(callback);
+		w.End();
+	}
+
+	void OperationJournal::OnCallbackRemoved(const std::string& callback)
+	{
+		RecordWriter w(pending);
+		w.Begin(RecordType::CallbackRemove);
+		w.Str(callback);
+		w.End();
+	}
+}
@@ -0,0 +1,125 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "state_listener.h"
+#include "background_save.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/******************************************************************************
+ *              Operation journal, for recovering work after a crash
+ *
+ *   The journal file starts with a snapshot of the state, written as
+ *   records, and every change made afterwards is appended as one more
+ *   small record. Once the appended records outgrow the snapshot, the
+ *   file is rewritten as a fresh snapshot (compaction), so appending
+ *   costs what the edit costs and the file never grows unbounded.
+ *
+ *   Compaction writes a snapshot of the state (see SnapshotCache) to a
+ *   temporary file on a worker thread. Edits made meanwhile keep being
+ *   appended to the old journal, and are appended to the new one too
+ *   before it replaces the old one, so the UI never waits for the disk.
+ *
+ *   Unsaved conversations and the session file, which lists the journals
+ *   to recover, live in the user's application data directory. There's
+ *   one per document with unsaved changes, the editor only journals the
+ *   one shown and leaves the others' journals behind until they're saved.
+ *
+ *   Record: [u32 size][u8 type][payload: size - 1 bytes][u32 checksum]
+ *   Node positions are in grid space like Node::position, so records made
+ *   before and after panning the canvas agree.
+ ******************************************************************************/
+
+namespace ede
+{
+	// a journal some session left open, and the save file it belongs to (empty for an unsaved conversation)
+	struct UnfinishedJournal
+	{
+		std::string journal_path;
+		std::string document_path;
+	};
+
+	class OperationJournal : public StateListener
+	{
+	public:
+		OperationJournal() = default;
+		~OperationJournal();
+
+		OperationJournal(const OperationJournal&) = delete;
+		OperationJournal& operator=(const OperationJournal&) = delete;
+
+		// Starts a fresh journal at journal_path, holding the snapshot. It's written in the background,
+		// the session only points at the journal once it's on the disk.
+		// document_path is the save file the journal belongs to, empty for an unsaved conversation.
+		void Open(const std::string& journal_path, const std::string& document_path, std::shared_ptr<const State> snapshot);
+
+		// Stops journaling. discard removes the journal and forgets it in the session, which is what a clean exit
+		// or a save does. Otherwise every record gathered so far is written and the file is left behind for Replay,
+		// the way a document with unsaved changes is set aside for another one.
+		void Close(bool discard);
+
+		bool IsOpen() const { return !path.empty(); }
+
+		// Writes the records gathered since the last call, and starts compacting from a snapshot of state when it's due.
+		// Called once per frame, so a crash loses at most the frame's changes.
+		void Flush(SnapshotCache& snapshots, const State& state);
+
+		// Journals left open by a session that never closed, one per document with unsaved changes, found through
+		// the session file. Empty when the last session exited cleanly.
+		static std::vector<UnfinishedJournal> FindUnfinishedJournals();
+
+		// removes a journal that was left behind by Close(false), once its document was saved or closed
+		static void Discard(const std::string& journal_path);
+
+		// Rebuilds the state recorded in the journal. Reading stops quietly at a torn or corrupted
+		// record, which is what a crash in the middle of a write leaves at the end of the file.
+		static bool Replay(const std::string& journal_path, State& out_state);
+
+		// where the journal of a document lives: next to it, or in the application data directory while it's unsaved
+		static std::string JournalPathFor(const std::string& document_path);
+
+		void OnStateReset(const State& state) override;
+		void OnNodeAdded(const Node& node) override;
+		void OnNodeRemoved(int node_id) override;
+		void OnNodeChanged(const Node& node, NodeChange change) override;
+		void OnLinkAdded(const Link& link) override;
+		void OnLinkRemoved(int link_id) override;
+		void OnCallbackAdded(const std::string& callback) override;
+		void OnCallbackRemoved(const std::string& callback) override;
+
+	private:
+		void StartCompaction(std::shared_ptr<const State> snapshot);
+		void FinishCompaction();
+		void StopCompaction();
+
+		std::FILE*        file = nullptr;       // null until the first snapshot is written
+		std::string       path;
+		std::string       document_path;
+		std::vector<char> pending;              // encoded records not written yet
+		uint64_t          snapshot_bytes = 0;   // size of the file right after the last compaction
+		uint64_t          appended_bytes = 0;   // written since then
+		bool              compaction_requested = false;
+		bool              session_written = false; // the session file lists the journal
+
+		// the compaction running on the worker, and the records to append to its snapshot
+		std::thread       compactor;
+		bool              compacting = false;
+		std::vector<char> since_snapshot;
+		std::atomic<bool> compaction_done = false;
+		std::atomic<bool> compaction_canceled = false;
+		bool              compaction_written = false; // set by the worker before compaction_done
+		uint64_t          compaction_bytes = 0;
+	};
+}
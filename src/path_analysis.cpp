@@ -0,0 +1,212 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "path_analysis.h"
+#include "state_hash.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace ede
+{
+	namespace
+	{
+		constexpr uint32_t Unvisited = std::numeric_limits<uint32_t>::max();
+
+		uint64_t SaturatingAdd(uint64_t a, uint64_t b)
+		{
+			return b > PathAnalysis::MaxPathCount - a ? PathAnalysis::MaxPathCount : a + b;
+		}
+	}
+
+	PathAnalysis AnalyzePaths(const State& state)
+	{
+		PathAnalysis analysis;
+
+		// nodes in id order and their connections as indices, connections to missing nodes are left out
+		std::vector<const Node*> nodes = NodesInIdOrder(state);
+		const uint32_t count = static_cast<uint32_t>(nodes.size());
+		std::unordered_map<int, uint32_t> index_of;
+		index_of.reserve(count);
+		for (uint32_t i = 0; i < count; i++) {
+			index_of.emplace(nodes[i]->id, i);
+		}
+
+		std::vector<uint32_t> edge_begin(count + 1);
+		std::vector<uint32_t> edges;
+		edges.reserve(count);
+		auto add_edge = [&](int target_id) {
+			auto it = index_of.find(target_id);
+			if (it != index_of.end()) {
+				edges.push_back(it->second);
+			}
+		};
+		for (uint32_t i = 0; i < count; i++) {
+			edge_begin[i] = static_cast<uint32_t>(edges.size());
+			if (nodes[i]->nextNodeId != -1) {
+				add_edge(nodes[i]->nextNodeId);
+			}
+			for (int response : nodes[i]->responses) {
+				add_edge(response);
+			}
+		}
+		edge_begin[count] = static_cast<uint32_t>(edges.size());
+
+		// Tarjan's, with an explicit call stack so long chains of nodes can't overflow the real one
+		std::vector<uint32_t> order(count, Unvisited);
+		std::vector<uint32_t> low(count, 0);
+		std::vector<uint32_t> component(count, Unvisited);
+		std::vector<uint32_t> scc_stack;
+		std::vector<bool>     on_stack(count, false);
+		uint32_t              next_order = 0;
+
+		struct Frame
+		{
+			uint32_t node;
+			uint32_t next_edge;
+		};
+		std::vector<Frame> calls;
+
+		// per component, filled as they complete
+		std::vector<uint64_t> paths;
+		std::vector<size_t>   longest;
+		std::vector<bool>     reaches_loop;
+		std::vector<uint32_t> members;
+
+		auto enter = [&](uint32_t node) {
+			order[node] = low[node] = next_order++;
+			scc_stack.push_back(node);
+			on_stack[node] = true;
+			calls.push_back({ node, edge_begin[node] });
+		};
+
+		// everything the component leads to is complete, its counts are final
+		auto complete_component = [&](uint32_t root) {
+			const uint32_t id = static_cast<uint32_t>(paths.size());
+			members.clear();
+			uint32_t member;
+			do {
+				member = scc_stack.back();
+				scc_stack.pop_back();
+				on_stack[member] = false;
+				component[member] = id;
+				members.push_back(member);
+			} while (member != root);
+
+			uint64_t leaving_paths = 0;
+			size_t longest_exit = 0;
+			bool has_exit = false;
+			bool is_loop = members.size() > 1;
+			bool leads_to_loop = false;
+			for (uint32_t m : members) {
+				for (uint32_t e = edge_begin[m]; e < edge_begin[m + 1]; e++) {
+					const uint32_t target = component[edges[e]];
+					if (target == id) {
+						is_loop = is_loop || edges[e] == m;
+						continue;
+					}
+					has_exit = true;
+					leaving_paths = SaturatingAdd(leaving_paths, paths[target]);
+					longest_exit = std::max(longest_exit, longest[target]);
+					leads_to_loop = leads_to_loop || reaches_loop[target];
+				}
+			}
+			paths.push_back(has_exit ? leaving_paths : 1);
+			longest.push_back(members.size() + longest_exit);
+			reaches_loop.push_back(is_loop || leads_to_loop);
+
+			if (is_loop) {
+				std::vector<int>& loop = analysis.loops.emplace_back();
+				loop.reserve(members.size());
+				for (uint32_t m : members) {
+					loop.push_back(nodes[m]->id);
+				}
+				std::sort(loop.begin(), loop.end());
+				analysis.nodes_in_loops += loop.size();
+			}
+		};
+
+		auto visit_from = [&](uint32_t start) {
+			enter(start);
+			while (!calls.empty()) {
+				Frame& frame = calls.back();
+				const uint32_t node = frame.node;
+				if (frame.next_edge < edge_begin[node + 1]) {
+					const uint32_t target = edges[frame.next_edge++];
+					if (order[target] == Unvisited) {
+						enter(target);
+					}
+					else if (on_stack[target]) {
+						low[node] = std::min(low[node], order[target]);
+					}
+					continue;
+				}
+				calls.pop_back();
+				if (!calls.empty()) {
+					low[calls.back().node] = std::min(low[calls.back().node], low[node]);
+				}
+				if (low[node] == order[node]) {
+					complete_component(node);
+				}
+			}
+		};
+
+		for (uint32_t i = 0; i < count; i++) {
+			if (order[i] == Unvisited) {
+				visit_from(i);
+			}
+		}
+
+		auto root = index_of.find(0);
+		if (root != index_of.end()) {
+			const uint32_t root_component = component[root->second];
+			analysis.path_count = paths[root_component];
+			analysis.path_count_saturated = analysis.path_count == PathAnalysis::MaxPathCount;
+			analysis.root_reaches_loop = reaches_loop[root_component];
+			analysis.longest_path = longest[root_component];
+
+			// breadth first from the root, the last node it gets to is the deepest
+			std::vector<uint32_t> depth(count, Unvisited);
+			std::vector<uint32_t> queue = { root->second };
+			depth[root->second] = 0;
+			for (size_t i = 0; i < queue.size(); i++) {
+				const uint32_t node = queue[i];
+				for (uint32_t e = edge_begin[node]; e < edge_begin[node + 1]; e++) {
+					if (depth[edges[e]] == Unvisited) {
+						depth[edges[e]] = depth[node] + 1;
+						queue.push_back(edges[e]);
+					}
+				}
+			}
+			analysis.max_depth = depth[queue.back()];
+		}
+
+		std::sort(analysis.loops.begin(), analysis.loops.end(),
+			[](const std::vector<int>& a, const std::vector<int>& b) { return a.front() < b.front(); });
+		return analysis;
+	}
+
+	/******************************************************************************
+	 *                              PathAnalyzer
+	 ******************************************************************************/
+
+	const PathAnalysis& PathAnalyzer::Get(const State& state)
+	{
+		if (dirty) {
+			analysis = AnalyzePaths(state);
+			dirty = false;
+		}
+		return analysis;
+	}
+
+	void PathAnalyzer::OnNodeChanged(const Node&, NodeChange change)
+	{
+		if (change == NodeChange::Connections) {
+			dirty = true;
+		}
+	}
+}
@@ -0,0 +1,69 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "state_listener.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/******************************************************************************
+ *              Loops and playthroughs of a conversation
+ *
+ *   Nodes that can lead back to themselves are grouped into their strongly
+ *   connected components, in one pass (Tarjan's). Components come out of it
+ *   after everything they lead to, so the paths from each one are counted
+ *   as it comes out, from the counts of the ones it leads to. Both steps
+ *   look at every node and connection once, however much the dialogue
+ *   branches.
+ *
+ *   A loop is walked through once: a path enters it, and leaves it
+ *   through one of its connections or ends there if none leaves. The
+ *   longest playthrough is counted the same way, a component at a time,
+ *   with every node of a loop it walks through.
+ ******************************************************************************/
+
+namespace ede
+{
+	struct PathAnalysis
+	{
+		static constexpr uint64_t MaxPathCount = std::numeric_limits<uint64_t>::max();
+
+		// distinct paths from the root to a node that leads nowhere, stops at MaxPathCount
+		uint64_t path_count = 0;
+		bool     path_count_saturated = false;
+
+		// node ids of every group of nodes that can lead back to themselves, sorted,
+		// groups in order of their smallest id. A node pointing at itself is a group of one
+		std::vector<std::vector<int>> loops;
+		size_t nodes_in_loops = 0;
+		bool   root_reaches_loop = false; // playthroughs can go on forever
+
+		size_t longest_path = 0; // most nodes on a playthrough, with every node of the loops it walks through once
+		size_t max_depth = 0;    // connections from the root to the node farthest from it, the shortest way there
+	};
+
+	PathAnalysis AnalyzePaths(const State& state);
+
+	// Keeps the last analysis until a connection changes, so drawing it every frame costs nothing
+	class PathAnalyzer : public StateListener
+	{
+	public:
+		const PathAnalysis& Get(const State& state);
+
+		void OnStateReset(const State&) override { dirty = true; }
+		void OnNodeAdded(const Node&) override { dirty = true; }
+		void OnNodeRemoved(int) override { dirty = true; }
+		void OnNodeChanged(const Node& node, NodeChange change) override;
+
+	private:
+		PathAnalysis analysis;
+		bool         dirty = true;
+	};
+}
@@ -0,0 +1,354 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "progressive_load.h"
+#include "state_binary.h"
+#include "state_io.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <numeric>
+#include <streambuf>
+#include <unordered_map>
+
+namespace ede
+{
+	namespace
+	{
+		// share of the progress bar taken by parsing a json file, publishing the nodes is the rest
+		constexpr float JsonParseShare = 0.9f;
+
+		// Feeds the json parser from a file while reporting how far it got.
+		// Reading ends early, as if the file did, once cancel is set
+		class ProgressStreamBuf : public std::streambuf
+		{
+		public:
+			ProgressStreamBuf(std::ifstream& file, uint64_t file_size, std::atomic<float>& progress, const std::atomic<bool>& cancel)
+				: file(file), file_size(file_size), progress(progress), cancel(cancel), buffer(64 * 1024) {}
+
+		protected:
+			int_type underflow() override {
+				if (cancel) {
+					return traits_type::eof();
+				}
+				const std::streamsize count = file.rdbuf()->sgetn(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+				if (count <= 0) {
+					return traits_type::eof();
+				}
+				bytes_read += static_cast<uint64_t>(count);
+				if (file_size > 0) {
+					progress = JsonParseShare * static_cast<float>(std::min<double>(1.0, double(bytes_read) / double(file_size)));
+				}
+				setg(buffer.data(), buffer.data(), buffer.data() + count);
+				return traits_type::to_int_type(buffer[0]);
+			}
+
+		private:
+			std::ifstream&            file;
+			uint64_t                  file_size;
+			uint64_t                  bytes_read = 0;
+			std::atomic<float>&       progress;
+			const std::atomic<bool>&  cancel;
+			std::vector<char>         buffer;
+		};
+
+		// Breadth first over count nodes, using order itself as the queue.
+		// id_of(i) is the id of the i-th node, for_each_child(i, visit) calls visit(child id) for its next node and responses
+		template <typename IdOf, typename ForEachChild>
+		std::vector<size_t> BreadthFirstOrder(size_t count, IdOf id_of, ForEachChild for_each_child)
+		{
+			std::unordered_map<int, size_t> index_of;
+			index_of.reserve(count);
+			for (size_t i = 0; i < count; i++) {
+				index_of.emplace(id_of(i), i);
+			}
+
+			std::vector<size_t> order;
+			order.reserve(count);
+			std::vector<bool> visited(count, false);
+			auto visit_from = [&](size_t start) {
+				visited[start] = true;
+				order.push_back(start);
+				for (size_t head = order.size() - 1; head < order.size(); head++) {
+					for_each_child(order[head], [&](int child_id) {
+						auto it = index_of.find(child_id);
+						if (it != index_of.end() && !visited[it->second]) {
+							visited[it->second] = true;
+							order.push_back(it->second);
+						}
+					});
+				}
+			};
+
+			auto root = index_of.find(0);
+			if (root != index_of.end()) {
+				visit_from(root->second);
+			}
+			if (order.size() < count) {
+				std::vector<size_t> by_id(count);
+				std::iota(by_id.begin(), by_id.end(), size_t(0));
+				std::sort(by_id.begin(), by_id.end(), [&](size_t a, size_t b) { return id_of(a) < id_of(b); });
+				for (size_t i : by_id) {
+					if (!visited[i]) {
+						visit_from(i);
+					}
+				}
+			}
+			return order;
+		}
+
+		// pins are encoded the way the editor does it, overflow included, so they match the links' attributes
+		int InputPin(int node_id) { return static_cast<int>(static_cast<uint32_t>(node_id) << NodePartShift::InputPin); }
+		int OutputPin(int node_id) { return static_cast<int>(static_cast<uint32_t>(node_id) << NodePartShift::EndPin); }
+
+		// Splits the nodes, given in publishing order, into batches and hands every link to the first batch
+		// that has both of its pins. make_node(i) builds the i-th node of ids.
+		// Returns false if the load was canceled on the way
+		template <typename MakeNode, typename PublishFn>
+		bool PublishInOrder(const std::vector<int>& ids, MakeNode make_node, std::vector<std::shared_ptr<Link>>&& links,
+			State&& header, size_t batch_size, float progress_start, std::atomic<float>& progress,
+			const std::atomic<bool>& cancel, PublishFn publish)
+		{
+			batch_size = std::max<size_t>(batch_size, 1);
+			const size_t batch_count = std::max<size_t>((ids.size() + batch_size - 1) / batch_size, 1);
+
+			std::unordered_map<int, size_t> input_pin_batch;
+			std::unordered_map<int, size_t> output_pin_batch;
+			input_pin_batch.reserve(ids.size());
+			output_pin_batch.reserve(ids.size());
+			for (size_t i = 0; i < ids.size(); i++) {
+				input_pin_batch.emplace(InputPin(ids[i]), i / batch_size);
+				// ids 256 apart share an output pin once it overflows, the later batch has both
+				auto [it, inserted] = output_pin_batch.emplace(OutputPin(ids[i]), i / batch_size);
+				it->second = std::max(it->second, i / batch_size);
+			}
+
+			std::vector<std::vector<std::shared_ptr<Link>>> batch_links(batch_count);
+			for (std::shared_ptr<Link>& link : links) {
+				if (!link) {
+					continue;
+				}
+				// a link to a pin no node has goes out with the last batch
+				size_t batch = batch_count - 1;
+				auto start = output_pin_batch.find(link->start_attr);
+				auto end = input_pin_batch.find(link->end_attr);
+				if (start != output_pin_batch.end() && end != input_pin_batch.end()) {
+					batch = std::max(start->second, end->second);
+				}
+				batch_links[batch].push_back(std::move(link));
+			}
+
+			for (size_t b = 0; b < batch_count; b++) {
+				if (cancel) {
+					return false;
+				}
+				State batch = b == 0 ? std::move(header) : State{};
+				const size_t first = b * batch_size;
+				const size_t last = std::min(first + batch_size, ids.size());
+				batch.nodes.reserve(last - first);
+				for (size_t i = first; i < last; i++) {
+					batch.nodes[ids[i]] = make_node(i);
+				}
+				batch.links.reserve(batch_links[b].size());
+				for (std::shared_ptr<Link>& link : batch_links[b]) {
+					batch.links[link->id] = std::move(link);
+				}
+				publish(std::move(batch));
+				progress = progress_start + (1.0f - progress_start) * float(b + 1) / float(batch_count);
+			}
+			return true;
+		}
+	}
+
+	std::vector<int> RootFirstOrder(const State& state)
+	{
+		std::vector<const Node*> nodes;
+		nodes.reserve(state.nodes.size());
+		for (const auto& pair : state.nodes) {
+			if (pair.second) {
+				nodes.push_back(pair.second.get());
+			}
+		}
+
+		std::vector<size_t> order = BreadthFirstOrder(nodes.size(),
+			[&](size_t i) { return nodes[i]->id; },
+			[&](size_t i, auto visit) {
+				if (nodes[i]->nextNodeId != -1) {
+					visit(nodes[i]->nextNodeId);
+				}
+				for (int response : nodes[i]->responses) {
+					visit(response);
+				}
+			});
+
+		std::vector<int> ids;
+		ids.reserve(order.size());
+		for (size_t i : order) {
+			ids.push_back(nodes[i]->id);
+		}
+		return ids;
+	}
+
+	/******************************************************************************
+	 *                              ProgressiveLoader
+	 ******************************************************************************/
+
+	void ProgressiveLoader::Cancel()
+	{
+		cancel_requested = true;
+		if (worker.joinable()) {
+			worker.join();
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		batches.clear();
+		result = {};
+		finished = false;
+	}
+
+	void ProgressiveLoader::Start(const std::string& path, size_t batch_size)
+	{
+		Cancel();
+
+		busy = true;
+		cancel_requested = false;
+		progress = 0.0f;
+		worker = std::thread([this, path, batch_size]() {
+			auto start = std::chrono::steady_clock::now();
+
+			LoadResult outcome;
+			outcome.path = path;
+			outcome.success = Run(path, batch_size, outcome);
+			outcome.canceled = !outcome.success && cancel_requested;
+			outcome.duration_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				result = std::move(outcome);
+			}
+			progress = 1.0f;
+			finished = true;
+			busy = false;
+		});
+	}
+
+	void ProgressiveLoader::Publish(State&& batch)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		batches.push_back(std::move(batch));
+	}
+
+	bool ProgressiveLoader::TakeBatch(State& out_batch)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (batches.empty()) {
+			return false;
+		}
+		out_batch = std::move(batches.front());
+		batches.pop_front();
+		return true;
+	}
+
+	bool ProgressiveLoader::PollFinished(LoadResult& out_result)
+	{
+		if (!finished) {
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!batches.empty()) {
+			return false;
+		}
+		finished = false;
+		out_result = std::move(result);
+		return true;
+	}
+
+	bool ProgressiveLoader::Run(const std::string& path, size_t batch_size, LoadResult& outcome)
+	{
+		auto publish = [this](State&& batch) { Publish(std::move(batch)); };
+
+		// mapping the file costs next to nothing, the nodes are built batch by batch straight from the records
+		if (IsBinaryStatePath(path)) {
+			auto view = std::make_shared<BinaryStateView>();
+			if (!view->Open(path, &outcome.error)) {
+				return false;
+			}
+			std::span<const binary::NodeRecord> records = view->Nodes();
+			std::vector<size_t> order = BreadthFirstOrder(records.size(),
+				[&](size_t i) { return records[i].id; },
+				[&](size_t i, auto visit) {
+					if (records[i].next_node_id != -1) {
+						visit(records[i].next_node_id);
+					}
+					for (int32_t response : view->Responses(records[i])) {
+						visit(response);
+					}
+				});
+
+			std::vector<int> ids;
+			ids.reserve(order.size());
+			for (size_t i : order) {
+				ids.push_back(records[i].id);
+			}
+
+			std::vector<std::shared_ptr<Link>> links;
+			links.reserve(view->Links().size());
+			for (const binary::LinkRecord& record : view->Links()) {
+				links.push_back(std::make_shared<Link>(record.id, record.start_attr, record.end_attr));
+			}
+
+			State header;
+			header.next_node_id = view->Header().next_node_id;
+			header.next_link_id = view->Header().next_link_id;
+			for (const binary::StringRecord& callback : view->Callbacks()) {
+				header.callbacks.emplace(view->String(callback));
+			}
+			header.text_storage_path = path;
+
+			const BinaryStateView& records_view = *view;
+			header.text_storage = std::move(view);
+			outcome.node_count = ids.size();
+			return PublishInOrder(ids, [&](size_t i) { return records_view.MakeNode(records[order[i]], TextLoading::Lazy); },
+				std::move(links), std::move(header), batch_size, 0.0f, progress, cancel_requested, publish);
+		}
+
+		// json has to be parsed to its end before anything is known about the root, only the hand over is progressive
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) {
+			outcome.error = "could not open " + path;
+			return false;
+		}
+		const std::streamoff file_size = file.tellg();
+		file.seekg(0);
+
+		ProgressStreamBuf progress_buffer(file, file_size > 0 ? static_cast<uint64_t>(file_size) : 0, progress, cancel_requested);
+		std::istream stream(&progress_buffer);
+		State loaded;
+		if (!ReadStateJson(stream, loaded, &outcome.error)) {
+			return false;
+		}
+		if (cancel_requested) {
+			return false;
+		}
+
+		std::vector<int> ids = RootFirstOrder(loaded);
+		std::vector<std::shared_ptr<Link>> links;
+		links.reserve(loaded.links.size());
+		for (auto& pair : loaded.links) {
+			links.push_back(std::move(pair.second));
+		}
+
+		State header;
+		header.next_node_id = loaded.next_node_id;
+		header.next_link_id = loaded.next_link_id;
+		header.callbacks = std::move(loaded.callbacks);
+		outcome.node_count = ids.size();
+		return PublishInOrder(ids, [&](size_t i) { return std::move(loaded.nodes[ids[i]]); },
+			std::move(links), std::move(header), batch_size, JsonParseShare, progress, cancel_requested, publish);
+	}
+}
@@ -0,0 +1,84 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/******************************************************************************
+ *          Loading a state on a worker thread, a piece at a time
+ *
+ *   The worker reads the file and hands the nodes over in batches,
+ *   breadth first from the root (id 0), so the start of a conversation
+ *   is on screen long before the end of a big file has been read.
+ *   A link travels in the first batch that has both of its nodes.
+ ******************************************************************************/
+
+namespace ede
+{
+	// Ids of the nodes in the order a conversation reaches them: breadth first from the root,
+	// then, in id order, the nodes the root doesn't lead to along with everything they lead to.
+	std::vector<int> RootFirstOrder(const State& state);
+
+	struct LoadResult
+	{
+		bool        success = false;
+		bool        canceled = false;
+		std::string path;
+		std::string error;
+		size_t      node_count = 0;
+		double      duration_ms = 0.0;
+	};
+
+	// Runs one load at a time. Start(), TakeBatch() and PollFinished() are meant to be called from the UI thread.
+	class ProgressiveLoader
+	{
+	public:
+		ProgressiveLoader() = default;
+		~ProgressiveLoader() { Cancel(); }
+
+		ProgressiveLoader(const ProgressiveLoader&) = delete;
+		ProgressiveLoader& operator=(const ProgressiveLoader&) = delete;
+
+		// Binary files keep their texts in the mapped file, see TextLoading::Lazy.
+		// A load that's still running is canceled first
+		void Start(const std::string& path, size_t batch_size = 2048);
+
+		// Stops the worker and drops the batches it published but nobody took. The worker checks
+		// between batches and every 64KB of json it reads, so this returns quickly
+		void Cancel();
+
+		bool  IsBusy() const { return busy; }
+		float Progress() const { return progress; }
+
+		// Moves the next batch into out_batch. The first one also carries the callbacks, the id counters
+		// and the text storage of the file, the others only nodes and links. Returns false when none is ready.
+		bool TakeBatch(State& out_batch);
+
+		// returns true once per load, after the worker finished and every batch was taken
+		bool PollFinished(LoadResult& out_result);
+
+	private:
+		void Publish(State&& batch);
+		bool Run(const std::string& path, size_t batch_size, LoadResult& outcome);
+
+		std::thread        worker;
+		std::atomic<bool>  busy = false;
+		std::atomic<bool>  finished = false;
+		std::atomic<bool>  cancel_requested = false;
+		std::atomic<float> progress = 0.0f;
+		std::mutex         mutex; // guards batches and result
+		std::deque<State>  batches;
+		LoadResult         result;
+	};
+}
@@ -0,0 +1,201 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "project.h"
+#include "background_save.h"
+#include "state_binary.h"
+#include "state_io.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace ede
+{
+	namespace
+	{
+		constexpr int ManifestVersion = 1;
+
+		bool Fail(std::string* error, const std::string& message) {
+			if (error != nullptr) {
+				*error = message;
+			}
+			return false;
+		}
+
+		bool ByPath(const ConversationSummary& a, const ConversationSummary& b) {
+			return a.path < b.path;
+		}
+	}
+
+	ConversationSummary SummarizeState(const State& state)
+	{
+		ConversationSummary summary;
+		std::set<std::string> callbacks;
+		for (const auto& pair : state.nodes) {
+			if (!pair.second) {
+				continue;
+			}
+			(pair.second->nodeType == NodeType::Speech ? summary.speech_count : summary.response_count)++;
+			callbacks.insert(pair.second->selected_callbacks.begin(), pair.second->selected_callbacks.end());
+		}
+		summary.link_count = static_cast<int>(state.links.size());
+		summary.callbacks.assign(callbacks.begin(), callbacks.end());
+		return summary;
+	}
+
+	bool LoadConversation(const std::string& path, State& out_state, std::string* error)
+	{
+		if (IsBinaryStatePath(path)) {
+			return ReadStateBinary(path, out_state, error, TextLoading::Lazy);
+		}
+		return ReadStateJson(path, out_state, error);
+	}
+
+	/******************************************************************************
+	 *                                 Manifest
+	 ******************************************************************************/
+
+	bool Project::Create(const std::string& new_path, std::string* error)
+	{
+		Close();
+		path = fs::absolute(new_path).string();
+		if (!Save(error)) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	bool Project::Load(const std::string& new_path, std::string* error)
+	{
+		std::ifstream file(new_path);
+		if (!file.is_open()) {
+			return Fail(error, "Could not open " + new_path);
+		}
+
+		std::vector<ConversationSummary> loaded;
+		try {
+			json j = json::parse(file);
+			if (j.at("version").get<int>() > ManifestVersion) {
+				return Fail(error, new_path + " was made by a newer version of the editor");
+			}
+			for (const json& jc : j.at("conversations")) {
+				ConversationSummary summary;
+				jc.at("path").get_to(summary.path);
+				summary.speech_count = jc.value("speech_count", 0);
+				summary.response_count = jc.value("response_count", 0);
+				summary.link_count = jc.value("link_count", 0);
+				summary.callbacks = jc.value("callbacks", std::vector<std::string>{});
+				loaded.push_back(std::move(summary));
+			}
+		}
+		catch (const json::exception& e) {
+			return Fail(error, e.what());
+		}
+
+		std::sort(loaded.begin(), loaded.end(), ByPath);
+		path = fs::absolute(new_path).string();
+		conversations = std::move(loaded);
+		return true;
+	}
+
+	bool Project::Save(std::string* error) const
+	{
+		json jconversations = json::array();
+		for (const ConversationSummary& summary : conversations) {
+			jconversations.push_back({
+				{"path", summary.path},
+				{"speech_count", summary.speech_count},
+				{"response_count", summary.response_count},
+				{"link_count", summary.link_count},
+				{"callbacks", summary.callbacks},
+			});
+		}
+		json j = { {"version", ManifestVersion}, {"conversations", std::move(jconversations)} };
+		std::string text = j.dump(4);
+
+		const std::string temp_path = path + ".tmp";
+		std::FILE* file = std::fopen(temp_path.c_str(), "w");
+		if (file == nullptr) {
+			return Fail(error, "Could not create " + temp_path);
+		}
+		bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size() && FlushFileToDisk(file);
+		written = std::fclose(file) == 0 && written;
+		if (!written || !ReplaceFileAtomically(temp_path, path)) {
+			std::remove(temp_path.c_str());
+			return Fail(error, "Could not write " + path);
+		}
+		return true;
+	}
+
+	void Project::Close()
+	{
+		path.clear();
+		conversations.clear();
+	}
+
+	std::string Project::Name() const
+	{
+		return fs::path(path).stem().string();
+	}
+
+	/******************************************************************************
+	 *                              Conversations
+	 ******************************************************************************/
+
+	std::string Project::RelativePath(const std::string& absolute_path) const
+	{
+		std::error_code ec;
+		fs::path relative = fs::relative(absolute_path, fs::path(path).parent_path(), ec);
+		return ec || relative.empty() ? fs::path(absolute_path).generic_string() : relative.generic_string();
+	}
+
+	std::string Project::AbsolutePath(const ConversationSummary& conversation) const
+	{
+		fs::path conversation_path(conversation.path);
+		if (conversation_path.is_absolute()) {
+			return conversation_path.make_preferred().string();
+		}
+		return (fs::path(path).parent_path() / conversation_path).lexically_normal().make_preferred().string();
+	}
+
+	int Project::FindConversation(const std::string& absolute_path) const
+	{
+		ConversationSummary key;
+		key.path = RelativePath(absolute_path);
+		auto it = std::lower_bound(conversations.begin(), conversations.end(), key, ByPath);
+		return it != conversations.end() && it->path == key.path ? static_cast<int>(it - conversations.begin()) : -1;
+	}
+
+	int Project::AddConversation(const std::string& absolute_path, const State& state)
+	{
+		ConversationSummary summary = SummarizeState(state);
+		summary.path = RelativePath(absolute_path);
+
+		auto it = std::lower_bound(conversations.begin(), conversations.end(), summary, ByPath);
+		if (it != conversations.end() && it->path == summary.path) {
+			*it = std::move(summary);
+		}
+		else {
+			it = conversations.insert(it, std::move(summary));
+		}
+		return static_cast<int>(it - conversations.begin());
+	}
+
+	void Project::RemoveConversation(int index)
+	{
+		if (index >= 0 && index < static_cast<int>(conversations.size())) {
+			conversations.erase(conversations.begin() + index);
+		}
+	}
+}
@@ -0,0 +1,71 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ *        Projects: a manifest of conversation files and what's in them
+ *
+ *   The manifest (.edeproj, JSON) lists each conversation's file, relative
+ *   to the manifest, with a summary taken when the conversation was last
+ *   saved from the editor. Opening a project only reads the manifest, the
+ *   conversations themselves are loaded one by one when they're opened.
+ ******************************************************************************/
+
+namespace ede
+{
+	constexpr const char* ProjectExtension = ".edeproj";
+
+	struct ConversationSummary
+	{
+		std::string              path; // relative to the manifest's folder, '/' separated
+		int                      speech_count = 0;
+		int                      response_count = 0;
+		int                      link_count = 0;
+		std::vector<std::string> callbacks; // used by its nodes, sorted
+	};
+
+	ConversationSummary SummarizeState(const State& state);
+
+	// Reads a .json or .edeb state, binary texts are loaded lazily (see Node::lazy_text)
+	bool LoadConversation(const std::string& path, State& out_state, std::string* error = nullptr);
+
+	class Project
+	{
+	public:
+		// an empty project, written to path right away
+		bool Create(const std::string& path, std::string* error = nullptr);
+		bool Load(const std::string& path, std::string* error = nullptr);
+		// written through a temporary file, like the saves
+		bool Save(std::string* error = nullptr) const;
+		void Close();
+
+		bool               IsOpen() const { return !path.empty(); }
+		const std::string& Path() const { return path; }
+		std::string        Name() const;
+
+		const std::vector<ConversationSummary>& Conversations() const { return conversations; }
+		std::string AbsolutePath(const ConversationSummary& conversation) const;
+
+		// -1 if the file isn't part of the project
+		int FindConversation(const std::string& absolute_path) const;
+
+		// Adds the file with state's summary, or refreshes the summary if it's already in. Returns its index
+		int AddConversation(const std::string& absolute_path, const State& state);
+		void RemoveConversation(int index);
+
+	private:
+		std::string RelativePath(const std::string& absolute_path) const;
+
+		std::string                      path;
+		std::vector<ConversationSummary> conversations; // sorted by path
+	};
+}
@@ -0,0 +1,232 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "reachability.h"
+#include <algorithm>
+
+namespace ede
+{
+	namespace
+	{
+		// the conversation starts at the root, nothing ever points at it
+		constexpr int RootNodeId = 0;
+
+		std::vector<int> OutgoingIds(const Node& node)
+		{
+			std::vector<int> out;
+			out.reserve(node.responses.size() + 1);
+			if (node.nextNodeId != -1) {
+				out.push_back(node.nextNodeId);
+			}
+			out.insert(out.end(), node.responses.begin(), node.responses.end());
+			return out;
+		}
+	}
+
+	bool ReachabilityTracker::IsUnreachable(int node_id) const
+	{
+		return unreachable.contains(node_id);
+	}
+
+	const std::vector<int>& ReachabilityTracker::UnreachableNodes() const
+	{
+		if (list_dirty) {
+			unreachable_list.assign(unreachable.begin(), unreachable.end());
+			list_dirty = false;
+		}
+		return unreachable_list;
+	}
+
+	bool ReachabilityTracker::IsLive(int node_id) const
+	{
+		auto it = entries.find(node_id);
+		return it != entries.end() && it->second.exists && it->second.reachable;
+	}
+
+	void ReachabilityTracker::MarkReachable(int node_id)
+	{
+		entries[node_id].reachable = true;
+		unreachable.erase(node_id);
+		list_dirty = true;
+	}
+
+	// walks everything the node leads to that isn't reachable yet
+	void ReachabilityTracker::Propagate(int node_id)
+	{
+		auto start = entries.find(node_id);
+		if (start == entries.end() || !start->second.exists || start->second.reachable) {
+			return;
+		}
+		std::vector<int> stack = { node_id };
+		MarkReachable(node_id);
+		while (!stack.empty()) {
+			const int id = stack.back();
+			stack.pop_back();
+			for (int target : entries[id].out) {
+				auto it = entries.find(target);
+				if (it != entries.end() && it->second.exists && !it->second.reachable) {
+					MarkReachable(target);
+					stack.push_back(target);
+				}
+			}
+		}
+	}
+
+	// Takes back everything that was reachable through starts, then gives it back to the nodes
+	// a reachable node still points at. Costs what was reachable through starts, not the graph
+	void ReachabilityTracker::Retract(const std::vector<int>& starts)
+	{
+		std::vector<int> taken;
+		for (int start : starts) {
+			if (start != RootNodeId && IsLive(start)) {
+				taken.push_back(start);
+				entries[start].reachable = false;
+			}
+		}
+		for (size_t head = 0; head < taken.size(); head++) {
+			for (int target : entries[taken[head]].out) {
+				if (target != RootNodeId && IsLive(target)) {
+					taken.push_back(target);
+					entries[target].reachable = false;
+				}
+			}
+		}
+		if (taken.empty()) {
+			return;
+		}
+		unreachable.insert(taken.begin(), taken.end());
+		list_dirty = true;
+
+		for (int id : taken) {
+			const std::vector<int>& in = entries[id].in;
+			if (std::any_of(in.begin(), in.end(), [this](int source) { return IsLive(source); })) {
+				Propagate(id);
+			}
+		}
+	}
+
+	// replaces the node's outgoing edges, walking only what the difference makes or stops making reachable
+	void ReachabilityTracker::SetEdges(int node_id, std::vector<int> out)
+	{
+		Entry& entry = entries[node_id];
+		std::vector<int> old_out = std::move(entry.out);
+		entry.out = std::move(out);
+
+		std::vector<int> dropped;
+		for (int target : old_out) {
+			Entry& target_entry = entries[target];
+			auto it = std::find(target_entry.in.begin(), target_entry.in.end(), node_id);
+			if (it != target_entry.in.end()) {
+				target_entry.in.erase(it);
+			}
+			if (std::find(entry.out.begin(), entry.out.end(), target) == entry.out.end()) {
+				dropped.push_back(target);
+			}
+		}
+		for (int target : entry.out) {
+			entries[target].in.push_back(node_id);
+		}
+
+		// ids nothing points at and no node has are forgotten
+		auto forget_if_unused = [this](int id) {
+			auto it = entries.find(id);
+			if (it != entries.end() && !it->second.exists && it->second.in.empty() && it->second.out.empty()) {
+				entries.erase(it);
+			}
+		};
+
+		if (!entry.exists || !entry.reachable) {
+			for (int target : dropped) {
+				forget_if_unused(target);
+			}
+			return;
+		}
+		Retract(dropped);
+		for (int target : dropped) {
+			forget_if_unused(target);
+		}
+		for (int target : entries[node_id].out) {
+			Propagate(target);
+		}
+	}
+
+	void ReachabilityTracker::OnStateReset(const State& state)
+	{
+		entries.clear();
+		unreachable.clear();
+		list_dirty = true;
+		entries.reserve(state.nodes.size());
+		for (const auto& pair : state.nodes) {
+			if (pair.second) {
+				Entry& entry = entries[pair.first];
+				entry.exists = true;
+				entry.out = OutgoingIds(*pair.second);
+				unreachable.insert(pair.first);
+			}
+		}
+		for (const auto& pair : state.nodes) {
+			if (pair.second) {
+				for (int target : entries[pair.first].out) {
+					entries[target].in.push_back(pair.first);
+				}
+			}
+		}
+		Propagate(RootNodeId);
+	}
+
+	void ReachabilityTracker::OnNodeAdded(const Node& node)
+	{
+		Entry& entry = entries[node.id];
+		if (entry.exists) {
+			OnNodeChanged(node, NodeChange::Connections);
+			return;
+		}
+		entry.exists = true;
+		entry.reachable = false;
+		unreachable.insert(node.id);
+		list_dirty = true;
+		SetEdges(node.id, OutgoingIds(node));
+
+		// nodes that pointed at the id before it existed, as when a removal is undone
+		const std::vector<int>& in = entries[node.id].in;
+		if (node.id == RootNodeId || std::any_of(in.begin(), in.end(), [this](int source) { return IsLive(source); })) {
+			Propagate(node.id);
+		}
+	}
+
+	void ReachabilityTracker::OnNodeRemoved(int node_id)
+	{
+		auto it = entries.find(node_id);
+		if (it == entries.end() || !it->second.exists) {
+			return;
+		}
+		SetEdges(node_id, {});
+
+		Entry& entry = entries[node_id];
+		entry.exists = false;
+		entry.reachable = false;
+		unreachable.erase(node_id);
+		list_dirty = true;
+		if (entry.in.empty()) {
+			entries.erase(node_id);
+		}
+	}
+
+	void ReachabilityTracker::OnNodeChanged(const Node& node, NodeChange change)
+	{
+		if (change != NodeChange::Connections) {
+			return;
+		}
+		auto it = entries.find(node.id);
+		if (it == entries.end() || !it->second.exists) {
+			OnNodeAdded(node);
+			return;
+		}
+		SetEdges(node.id, OutgoingIds(node));
+	}
+}
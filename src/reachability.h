@@ -0,0 +1,65 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "state_listener.h"
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+/******************************************************************************
+ *          Which nodes a conversation can still get to from the root
+ *
+ *   Kept up to date edit by edit. A new connection only walks what it
+ *   makes reachable. A removed connection or node only looks at what
+ *   was reachable through it: those nodes are taken out, and the ones
+ *   that still have a reachable node pointing at them are walked again.
+ *   The whole graph is only walked when the state is reset.
+ ******************************************************************************/
+
+namespace ede
+{
+	class ReachabilityTracker : public StateListener
+	{
+	public:
+		// false for nodes the tracker doesn't know, a node is only flagged once it's known to be unreachable
+		bool IsUnreachable(int node_id) const;
+
+		size_t UnreachableCount() const { return unreachable.size(); }
+
+		// sorted ids of the nodes the root doesn't lead to, rebuilt only after a change
+		const std::vector<int>& UnreachableNodes() const;
+
+		void OnStateReset(const State& state) override;
+		void OnNodeAdded(const Node& node) override;
+		void OnNodeRemoved(int node_id) override;
+		void OnNodeChanged(const Node& node, NodeChange change) override;
+
+	private:
+		struct Entry
+		{
+			std::vector<int> out;  // nextNodeId, then responses
+			std::vector<int> in;   // one entry per edge pointing here, duplicates included
+			bool exists = false;   // edges may point at nodes that don't exist (yet)
+			bool reachable = false;
+		};
+
+		void SetEdges(int node_id, std::vector<int> out);
+		void MarkReachable(int node_id);
+		void Propagate(int node_id);
+		void Retract(const std::vector<int>& starts);
+		bool IsLive(int node_id) const;
+
+		std::unordered_map<int, Entry> entries;
+		std::set<int>                  unreachable; // existing nodes only
+
+		mutable std::vector<int> unreachable_list;
+		mutable bool             list_dirty = true;
+	};
+}
@@ -16,9 +16,11 @@
 #include <algorithm>
 
 #include <string>
+#include <string_view>
 #include <format>
 #include <iostream>
 #include <set>
+#include <filesystem>
 #include <imgui_internal.h>
 
 using json = nlohmann::json;
@@ -157,12 +159,54 @@ namespace ede {
 			if (ImGui::MenuItem("Export Dialogue", "Ctrl+X")) {
 				ede::FileDialogs::ExportDialogueJsonFile();
 			}
+			if (ImGui::MenuItem("Export Statistics...")) {
+				ede::FileDialogs::ExportGraphStats();
+			}
+			ImGui::Separator();
+			const bool project_open = ede::GetProject().IsOpen();
+			if (ImGui::MenuItem("New Project...")) {
+				ede::FileDialogs::NewProject();
+			}
+			if (ImGui::MenuItem("Open Project...")) {
+				ede::FileDialogs::OpenProject();
+			}
+			if (ImGui::MenuItem("Add Conversation to Project...", nullptr, false, project_open)) {
+				ede::FileDialogs::AddConversationToProject();
+			}
+			if (ImGui::MenuItem("Close Project", nullptr, false, project_open)) {
+				ede::CloseProject();
+			}
+			ImGui::EndMenu();
+		}
+		if (ImGui::BeginMenu("Graph")) {
+			if (ImGui::MenuItem("Auto Layout", "Ctrl+L")) {
+				ede::AutoLayout();
+			}
+			if (ImGui::MenuItem(ede::IsForceLayoutRunning() ? "Stop Force Layout" : "Force Layout", "Ctrl+Shift+L")) {
+				ede::ToggleForceLayout();
+			}
+			ImGui::Separator();
+			if (ImGui::MenuItem("Pin / Unpin Selected Nodes", "Ctrl+P")) {
+				ede::TogglePinSelectedNodes();
+			}
+			if (ImGui::MenuItem("Unpin All Nodes", nullptr, false, ede::HasPinnedNodes())) {
+				ede::UnpinAllNodes();
+			}
 			ImGui::EndMenu();
 		}
 		if (ImGui::BeginMenu("Window")) {
 			if (ImGui::MenuItem("Reset layout", "Ctrl+R")) {
 				ede::marked_for_UI_reset = true;
 			}
+			if (ImGui::MenuItem("Project", nullptr, false, ede::GetProject().IsOpen())) {
+				ede::ToggleProjectWindow();
+			}
+			if (ImGui::MenuItem("Issues")) {
+				ede::ToggleIssuesWindow();
+			}
+			if (ImGui::MenuItem("Search", "Ctrl+F")) {
+				ede::OpenSearchWindow();
+			}
 #ifdef _DEBUG
 			if (ImGui::MenuItem("Toggle Demo Window"))
 			{
@@ -181,19 +225,323 @@ namespace ede {
 			}
 			ImGui::EndMenu();
 		}
+
+		// right aligned, which file is shown and whether it has unsaved changes
+		const std::string& document_path = ede::GetDocumentPath();
+		std::string document_label = document_path.empty() ? std::string("Untitled") : std::filesystem::path(document_path).filename().string();
+		if (ede::HasUnsavedChanges()) {
+			document_label += " (unsaved changes)";
+		}
+		const float label_width = ImGui::CalcTextSize(document_label.c_str()).x + ImGui::GetStyle().ItemSpacing.x * 2.0f;
+		ImGui::SameLine(ImGui::GetWindowWidth() - label_width);
+		ImGui::TextDisabled("%s", document_label.c_str());
+
 		ImGui::EndMainMenuBar();
 		ImGui::PopStyleVar();
 	}
 
+	// Lists the project's conversations with the summary stored in the manifest, nothing is loaded to draw it.
+	// Double clicking a conversation opens it in its own tab
+	void ShowProjectWindow(bool* p_open)
+	{
+		const Project& project = ede::GetProject();
+		const std::vector<ConversationSummary>& conversations = project.Conversations();
+
+		std::string title = "Project: " + project.Name() + "###Project";
+		if (!ImGui::Begin(title.c_str(), p_open)) {
+			ImGui::End();
+			return;
+		}
+
+		if (ImGui::Button("Add conversation...")) {
+			ede::FileDialogs::AddConversationToProject();
+		}
+		ImGui::SameLine();
+		ImGui::TextDisabled("%d conversations", static_cast<int>(conversations.size()));
+
+		std::string path_to_open;
+		const ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+		if (ImGui::BeginTable("Conversations", 5, table_flags)) {
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Conversation", ImGuiTableColumnFlags_WidthStretch, 2.0f);
+			ImGui::TableSetupColumn("Speech", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableSetupColumn("Responses", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableSetupColumn("Links", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableSetupColumn("Callbacks", ImGuiTableColumnFlags_WidthStretch, 1.0f);
+			ImGui::TableHeadersRow();
+
+			// only the visible rows are drawn, projects can hold hundreds of conversations
+			ImGuiListClipper clipper;
+			clipper.Begin(static_cast<int>(conversations.size()));
+			while (clipper.Step()) {
+				for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+					const ConversationSummary& conversation = conversations[row];
+					const std::string path = project.AbsolutePath(conversation);
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::PushID(row);
+					if (ImGui::Selectable(conversation.path.c_str(), ede::IsConversationOpen(path),
+						ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)
+						&& ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+						path_to_open = path;
+					}
+					ImGui::PopID();
+
+					ImGui::TableNextColumn();
+					ImGui::Text("%d", conversation.speech_count);
+					ImGui::TableNextColumn();
+					ImGui::Text("%d", conversation.response_count);
+					ImGui::TableNextColumn();
+					ImGui::Text("%d", conversation.link_count);
+					ImGui::TableNextColumn();
+					std::string callbacks;
+					for (const std::string& callback : conversation.callbacks) {
+						callbacks += callbacks.empty() ? callback : " " + callback;
+					}
+					ImGui::TextUnformatted(callbacks.c_str());
+				}
+			}
+			ImGui::EndTable();
+		}
+		ImGui::End();
+
+		// opening changes the tabs, wait until the window is done with the list
+		if (!path_to_open.empty()) {
+			ede::OpenConversation(path_to_open);
+		}
+	}
+
+	// What the background validation found, clicking an issue goes to its node or link.
+	// Only the visible rows are drawn, a broken import can have thousands
+	void ShowIssuesWindow(bool* p_open)
+	{
+		ImGui::SetNextWindowSize(ImVec2(520.0f, 300.0f), ImGuiCond_FirstUseEver);
+		if (!ImGui::Begin("Issues", p_open)) {
+			ImGui::End();
+			return;
+		}
+
+		std::shared_ptr<const ValidationReport> report = ede::GetValidationReport();
+		if (!report) {
+			ImGui::TextDisabled("Checking the conversation...");
+			ImGui::End();
+			return;
+		}
+
+		ImGui::Text("%zu errors, %zu warnings", report->error_count, report->warning_count);
+		ImGui::SameLine();
+		if (ede::IsValidationPending()) {
+			ImGui::TextDisabled("(checking the latest edits...)");
+		}
+		else {
+			ImGui::TextDisabled("(last check: %zu nodes, %zu links in %.1f ms)", report->nodes_checked, report->links_checked, report->duration_ms);
+		}
+		ImGui::Separator();
+
+		if (report->issues.empty()) {
+			ImGui::TextUnformatted("No issues found.");
+			ImGui::End();
+			return;
+		}
+
+		ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+		if (ImGui::BeginTable("IssuesTable", 3, flags)) {
+			ImGui::TableSetupScrollFreeze(0, 1);
+			ImGui::TableSetupColumn("Severity", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableSetupColumn("Where", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableSetupColumn("Issue", ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableHeadersRow();
+
+			ImGuiListClipper clipper;
+			clipper.Begin(static_cast<int>(report->issues.size()));
+			while (clipper.Step()) {
+				for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+					const ValidationIssue& issue = report->issues[row];
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					const bool is_error = issue.severity == IssueSeverity::Error;
+					ImGui::TextColored(is_error ? ImVec4(1.0f, 0.4f, 0.35f, 1.0f) : ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "%s", IssueSeverityName(issue.severity));
+
+					ImGui::TableNextColumn();
+					std::string where = issue.node_id != -1 ? std::format("Node {}", issue.node_id)
+						: issue.link_id != -1 ? std::format("Link {}", issue.link_id) : std::string("State");
+					ImGui::PushID(row);
+					if (ImGui::Selectable(where.c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
+						if (issue.node_id != -1) {
+							ede::FocusNode(issue.node_id);
+						}
+						else if (issue.link_id != -1) {
+							ede::FocusLink(issue.link_id);
+						}
+					}
+					ImGui::PopID();
+
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(issue.message.c_str());
+				}
+			}
+			ImGui::EndTable();
+		}
+		ImGui::End();
+	}
+
+	// the text around the first match, on a single line
+	static std::string SearchSnippet(std::string_view text, std::string_view query)
+	{
+		const size_t context = 24;
+		size_t at = FindIgnoringCase(text, query);
+		if (at == std::string_view::npos) {
+			at = 0;
+		}
+		const size_t begin = at > context ? at - context : 0;
+		const size_t end = std::min(text.size(), at + query.size() + context * 2);
+		std::string snippet = (begin > 0 ? "..." : "") + std::string(text.substr(begin, end - begin)) + (end < text.size() ? "..." : "");
+		std::replace(snippet.begin(), snippet.end(), '\n', ' ');
+		return snippet;
+	}
+
+	// Finds nodes by their text as it's typed. Clicking a result, or Enter for the next one, centers the canvas on it
+	void ShowSearchWindow(bool* p_open, bool focus_input)
+	{
+		ImGui::SetNextWindowSize(ImVec2(420.0f, 360.0f), ImGuiCond_FirstUseEver);
+		if (focus_input) {
+			ImGui::SetNextWindowFocus();
+		}
+		if (!ImGui::Begin("Search", p_open)) {
+			ImGui::End();
+			return;
+		}
+
+		static char query[256] = "";
+		static int current_result = -1;
+		if (focus_input || ImGui::IsWindowAppearing()) {
+			ImGui::SetKeyboardFocusHere();
+		}
+		ImGui::SetNextItemWidth(-FLT_MIN);
+		const bool next_result = ImGui::InputTextWithHint("##SearchQuery", "Search node text...", query, IM_ARRAYSIZE(query),
+			ImGuiInputTextFlags_EnterReturnsTrue);
+		if (ImGui::IsItemEdited()) {
+			current_result = -1;
+		}
+
+		const SearchResult& result = ede::SearchNodes(query);
+		if (next_result) {
+			// Enter leaves the input, keep typing or pressing Enter without clicking it again
+			ImGui::SetKeyboardFocusHere(-1);
+			if (!result.node_ids.empty()) {
+				current_result = (current_result + 1) % static_cast<int>(result.node_ids.size());
+				ede::FocusNode(result.node_ids[current_result]);
+			}
+		}
+
+		if (query[0] != '\0') {
+			if (result.match_count > result.node_ids.size()) {
+				ImGui::TextDisabled("%zu matches, showing the first %zu", result.match_count, result.node_ids.size());
+			}
+			else {
+				ImGui::TextDisabled("%zu matches", result.match_count);
+			}
+		}
+
+		ImGui::BeginChild("SearchResults");
+		const State& state = ede::GetCurrentState();
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int>(result.node_ids.size()));
+		while (clipper.Step()) {
+			for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+				const int node_id = result.node_ids[row];
+				std::shared_ptr<Node> node = state.FindNode(node_id);
+				if (!node) {
+					continue;
+				}
+				// the snippet goes next to the selectable, a "##" in the text would cut a label short
+				ImGui::PushID(node_id);
+				if (ImGui::Selectable("##SearchResult", row == current_result)) {
+					current_result = row;
+					ede::FocusNode(node_id);
+				}
+				ImGui::SameLine();
+				ImGui::TextDisabled("Node %d", node_id);
+				ImGui::SameLine();
+				ImGui::TextUnformatted(SearchSnippet(node->TextView(), query).c_str());
+				ImGui::PopID();
+			}
+		}
+		ImGui::EndChild();
+		ImGui::End();
+	}
+
 	void ShowGraphInfoWindow()
 	{
 		float raw_text_block_height = 35.0f;
 		ImGui::Begin("Story Graph Info");
-		auto nodes = ede::GetNodesVec();
+		// kept up to date by every edit, nothing here goes over the nodes
+		const GraphStats& stats = ede::GetGraphStats();
+		ImGui::Text("Total number of nodes: %zu", stats.node_count);
+		ImGui::Text("Number of Speech nodes: %zu", stats.speech_count);
+		ImGui::Text("Number of Response nodes: %zu", stats.response_count);
+		ImGui::Text("Connections: %zu, %.2f per branching node", stats.connection_count, stats.AverageBranching());
+		ImGui::Text("Words: %zu%s", stats.word_count, stats.counting_words ? " (counting...)" : "");
+		ImGui::Text("Callback tags on nodes: %zu", stats.callback_uses);
+
+		// unreachable nodes are tracked as the graph is edited, listing them costs nothing more
+		const std::vector<int>& unreachable_nodes = ede::GetUnreachableNodes();
+		ImGui::Text("Unreachable nodes: %zu", unreachable_nodes.size());
+		ImGui::SameLine();
+		HelpMarker("Nodes the conversation can never get to from its first node. Their title bar is red on the canvas, pick one below to go to it.");
+		if (!unreachable_nodes.empty() && ImGui::BeginCombo("##UnreachableNodes", "Go to unreachable node...")) {
+			ImGuiListClipper clipper;
+			clipper.Begin(static_cast<int>(unreachable_nodes.size()));
+			while (clipper.Step()) {
+				for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+					const int node_id = unreachable_nodes[i];
+					if (ImGui::Selectable(std::format("Node {}", node_id).c_str())) {
+						ede::FocusNode(node_id);
+					}
+				}
+			}
+			ImGui::EndCombo();
+		}
 
-		ImGui::Text("Total number of nodes: %d", nodes.size());
-		ImGui::Text("Number of Speech nodes: %d", ede::GetNumNodesOfType(NodeType::Speech));
-		ImGui::Text("Number of Response nodes: %d", ede::GetNumNodesOfType(NodeType::Response));
+		const PathAnalysis& paths = ede::GetPathAnalysis();
+		if (paths.path_count_saturated) {
+			ImGui::Text("Playthroughs: at least %llu", static_cast<unsigned long long>(paths.path_count));
+		}
+		else {
+			ImGui::Text("Playthroughs: %llu", static_cast<unsigned long long>(paths.path_count));
+		}
+		ImGui::SameLine();
+		HelpMarker("Distinct paths from the first node to one that leads nowhere. A loop is counted as walked through once.");
+		ImGui::Text("Loops: %zu (%zu nodes)%s", paths.loops.size(), paths.nodes_in_loops,
+			paths.root_reaches_loop ? ", a playthrough can go on forever" : "");
+		ImGui::Text("Max depth: %zu, longest playthrough: %zu nodes", paths.max_depth, paths.longest_path);
+		ImGui::SameLine();
+		HelpMarker("Depth is how many connections it takes to get to the node farthest from the first one. The longest playthrough goes through every node of the loops it enters.");
+		if (!paths.loops.empty() && ImGui::BeginCombo("##Loops", "Go to loop...")) {
+			ImGuiListClipper clipper;
+			clipper.Begin(static_cast<int>(paths.loops.size()));
+			while (clipper.Step()) {
+				for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+					const std::vector<int>& loop = paths.loops[i];
+					std::string label = loop.size() == 1 ? std::format("Node {} leads to itself##{}", loop.front(), i)
+						: std::format("{} nodes, from node {}##{}", loop.size(), loop.front(), i);
+					if (ImGui::Selectable(label.c_str())) {
+						ede::FocusNode(loop.front());
+					}
+				}
+			}
+			ImGui::EndCombo();
+		}
+
+		std::shared_ptr<const ValidationReport> validation = ede::GetValidationReport();
+		if (validation) {
+			ImGui::Text("Issues: %zu errors, %zu warnings", validation->error_count, validation->warning_count);
+			ImGui::SameLine();
+			if (ImGui::SmallButton("List")) {
+				ede::ToggleIssuesWindow();
+			}
+		}
 
 		ImGui::Dummy(ImVec2(0.0f, 5.0f));
 
@@ -207,7 +555,7 @@ namespace ede {
 		ImGui::Dummy(ImVec2(0.0f, 5.0f));
 		std::string raw_info;
 
-		for (const std::shared_ptr<Node>& node : nodes) {
+		for (const auto& [id, node] : ede::GetNodesMap()) {
 			if (node) {
 				std::set<std::string>& current_callbacks = node->selected_callbacks;
 				std::ostringstream stream;
@@ -225,7 +573,7 @@ namespace ede {
 					raw_info += std::format(R"([{{ "id": "{}" ; "type": "Speech" ; "next_node_id": "{}" ; "expected_responses": "{}" }} ; "callbacks": "{}")",
 						node->id, node->nextNodeId, ss.str(), result_str);
 					
-					ImGui::Text(std::format("Node {}: {{\n  \"id\": \"{}\",\n  \"type\": \"Speech\",\n \"text\": \"{}\",\n  \"next_node_id\": \"{}\",\n  \"expected_responses\": \"{}\",\n \"callbacks\": \"{{ {}}}\"\n}}", node->id, node->id, node->text, node->nextNodeId, ss.str(), result_str).c_str());
+					ImGui::Text(std::format("Node {}: {{\n  \"id\": \"{}\",\n  \"type\": \"Speech\",\n \"text\": \"{}\",\n  \"next_node_id\": \"{}\",\n  \"expected_responses\": \"{}\",\n \"callbacks\": \"{{ {}}}\"\n}}", node->id, node->id, node->TextView(), node->nextNodeId, ss.str(), result_str).c_str());
 
 				}
 				if (node->nodeType == NodeType::Response) {
@@ -262,14 +610,36 @@ namespace ede {
 			ImGui::EndTooltip();
 		}
 		std::set<std::string>& current_callbacks = ede::GetCallbacksMutable();
+
+		// the checked tags filter the canvas
+		bool any_filtered = false;
+		for (const std::string& callback : current_callbacks) {
+			any_filtered = any_filtered || ede::IsCallbackFiltered(callback);
+		}
+		ImGui::Checkbox("Fade other nodes", &ede::CallbackFilterFadesOthers());
+		ImGui::SameLine();
+		HelpMarker("Check tags below to find the nodes carrying any of them on the canvas. Their title bar turns yellow, or with this option every other node fades out.");
+		if (any_filtered) {
+			ImGui::SameLine();
+			if (ImGui::SmallButton("Clear filter")) {
+				ede::ClearCallbackFilter();
+			}
+		}
 		ImGui::Indent();
 
-		// display current callback tags and delete buttons
+		// display current callback tags, how many nodes use them, and delete buttons
 		for (auto it = current_callbacks.begin(); it != current_callbacks.end();) {
 
 			const auto& callback = *it;
+			bool filtered = ede::IsCallbackFiltered(callback);
+			if (ImGui::Checkbox(("##Filter" + callback).c_str(), &filtered)) {
+				ede::ToggleCallbackFilter(callback);
+			}
+			ImGui::SameLine();
 			TEXT_BULLET(">", callback.c_str());
 			ImGui::SameLine();
+			ImGui::TextDisabled("(%zu)", ede::GetCallbackUseCount(callback));
+			ImGui::SameLine();
 			std::string button_label = "X##" + callback;
 			if (ImGui::Button(button_label.c_str())) {
 				ede::NotifyCallbackDeletion(callback);
@@ -296,7 +666,9 @@ namespace ede {
 				// exported JSON is separated using spaces
 				std::replace(callback_str.begin(), callback_str.end(), ' ', '_');
 
-				current_callbacks.insert(callback_str);
+				if (current_callbacks.insert(callback_str).second) {
+					ede::NotifyCallbackAdded(callback_str);
+				}
 				strcpy(new_callback, "");
 				ImGui::SetKeyboardFocusHere(-1);
 			}			
@@ -4,5 +4,8 @@ namespace ede {
 	void ShowMenuBar();
 	void ShowGraphInfoWindow();
 	void ShowSelectedNodeInfoWindow();
+	void ShowProjectWindow(bool* p_open);
+	void ShowIssuesWindow(bool* p_open);
+	void ShowSearchWindow(bool* p_open, bool focus_input);
 	void LoadFonts(float fontSize_ = 12.0f);
 }
\ No newline at end of file
@@ -0,0 +1,410 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "state_binary.h"
+#include "file_sink.h"
+#include "state_hash.h"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+static_assert(std::endian::native == std::endian::little, "the binary save format is read in place, so it needs a little-endian host");
+
+namespace ede
+{
+	using namespace binary;
+
+	namespace
+	{
+		uint64_t AlignUp(uint64_t offset) {
+			return (offset + 7) & ~uint64_t(7);
+		}
+
+		template<typename T>
+		void WriteRaw(FileSink& sink, const T& value) {
+			sink.Write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		// pads with zeroes up to the next section
+		void WritePadding(FileSink& sink, uint64_t& written) {
+			uint64_t aligned = AlignUp(written);
+			for (; written < aligned; written++) {
+				sink.Write('\0');
+			}
+		}
+
+		void WriteString(FileSink& sink, std::string_view s) {
+			sink.Write(s.data(), s.size());
+			sink.Write('\0');
+		}
+
+		// whether [offset, offset + count * element_size) fits in a file of file_size bytes, at a section's alignment
+		bool RangeFits(uint64_t offset, uint64_t count, uint64_t element_size, uint64_t file_size) {
+			if (offset > file_size || offset != AlignUp(offset)) {
+				return false;
+			}
+			return count <= (file_size - offset) / element_size;
+		}
+
+		bool Fail(std::string* error, const char* message) {
+			if (error != nullptr) {
+				*error = message;
+			}
+			return false;
+		}
+	}
+
+	bool IsBinaryStatePath(const std::string& path)
+	{
+		size_t length = std::strlen(Extension);
+		if (path.size() < length) {
+			return false;
+		}
+		return std::equal(path.end() - length, path.end(), Extension, Extension + length,
+			[](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+	}
+
+	/******************************************************************************
+	 *                                  Writing
+	 ******************************************************************************/
+
+	bool WriteStateBinary(const State& state, const std::string& path)
+	{
+		std::FILE* file = std::fopen(path.c_str(), "wb");
+		if (file == nullptr) {
+			return false;
+		}
+		bool success = WriteStateBinary(state, file);
+		success = std::fclose(file) == 0 && success;
+		return success;
+	}
+
+	bool WriteStateBinary(const State& state, std::FILE* file, const std::function<void(float)>& on_progress)
+	{
+		// id order, the same state always gives the same file
+		std::vector<const Node*> nodes = NodesInIdOrder(state);
+		std::vector<const Link*> links = LinksInIdOrder(state);
+
+		// first pass, sizes of every section. strings go in the blob in the order:
+		// state callbacks, then for each node its text followed by its selected callbacks
+		uint64_t int_count = 0;
+		uint64_t string_count = state.callbacks.size();
+		uint64_t blob_size = 0;
+		for (const std::string& callback : state.callbacks) {
+			blob_size += callback.size() + 1;
+		}
+		for (const Node* node : nodes) {
+			int_count += node->prevNodeIds.size() + node->responses.size();
+			string_count += node->selected_callbacks.size();
+			blob_size += node->TextView().size() + 1;
+			for (const std::string& callback : node->selected_callbacks) {
+				blob_size += callback.size() + 1;
+			}
+		}
+		if (blob_size > std::numeric_limits<uint32_t>::max() || int_count > std::numeric_limits<uint32_t>::max() ||
+			string_count > std::numeric_limits<uint32_t>::max()) {
+			return false;
+		}
+
+		FileHeader header{};
+		std::memcpy(header.magic, Magic, sizeof(Magic));
+		header.version = Version;
+		header.header_size = sizeof(FileHeader);
+		header.next_node_id = state.next_node_id;
+		header.next_link_id = state.next_link_id;
+		header.node_count = static_cast<uint32_t>(nodes.size());
+		header.link_count = static_cast<uint32_t>(links.size());
+		header.string_count = static_cast<uint32_t>(string_count);
+		header.callback_count = static_cast<uint32_t>(state.callbacks.size());
+		header.int_count = static_cast<uint32_t>(int_count);
+		header.node_table_offset = AlignUp(sizeof(FileHeader));
+		header.link_table_offset = AlignUp(header.node_table_offset + nodes.size() * sizeof(NodeRecord));
+		header.string_table_offset = AlignUp(header.link_table_offset + links.size() * sizeof(LinkRecord));
+		header.int_pool_offset = AlignUp(header.string_table_offset + string_count * sizeof(StringRecord));
+		header.string_blob_offset = AlignUp(header.int_pool_offset + int_count * sizeof(int32_t));
+		header.string_blob_size = blob_size;
+
+		// second pass, every section in file order
+		{
+			FileSink sink(file);
+			auto report = [&](float fraction) {
+				if (on_progress) {
+					on_progress(fraction);
+				}
+			};
+			uint64_t written = 0;
+
+			WriteRaw(sink, header);
+			written += sizeof(FileHeader);
+			WritePadding(sink, written);
+
+			uint32_t blob_offset = 0;
+			for (const std::string& callback : state.callbacks) {
+				blob_offset += static_cast<uint32_t>(callback.size() + 1);
+			}
+			uint32_t int_index = 0;
+			uint32_t string_index = header.callback_count;
+			for (const Node* node : nodes) {
+				NodeRecord record{};
+				record.id = node->id;
+				record.node_type = static_cast<int32_t>(node->nodeType);
+				record.next_node_id = node->nextNodeId;
+				record.flags = node->expectesResponse ? NodeFlags_ExpectsResponse : NodeFlags_None;
+				record.x = node->position.x;
+				record.y = node->position.y;
+				record.text_offset = blob_offset;
+				record.text_length = static_cast<uint32_t>(node->TextView().size());
+				record.prev_first = int_index;
+				record.prev_count = static_cast<uint32_t>(node->prevNodeIds.size());
+				record.responses_first = record.prev_first + record.prev_count;
+				record.responses_count = static_cast<uint32_t>(node->responses.size());
+				record.callbacks_first = string_index;
+				record.callbacks_count = static_cast<uint32_t>(node->selected_callbacks.size());
+				WriteRaw(sink, record);
+
+				blob_offset += record.text_length + 1;
+				for (const std::string& callback : node->selected_callbacks) {
+					blob_offset += static_cast<uint32_t>(callback.size() + 1);
+				}
+				int_index += record.prev_count + record.responses_count;
+				string_index += record.callbacks_count;
+			}
+			written += nodes.size() * sizeof(NodeRecord);
+			WritePadding(sink, written);
+			report(0.4f);
+
+			for (const Link* link : links) {
+				WriteRaw(sink, LinkRecord{ link->id, link->start_attr, link->end_attr });
+			}
+			written += links.size() * sizeof(LinkRecord);
+			WritePadding(sink, written);
+
+			blob_offset = 0;
+			auto write_string_record = [&](const std::string& s) {
+				WriteRaw(sink, StringRecord{ blob_offset, static_cast<uint32_t>(s.size()) });
+				blob_offset += static_cast<uint32_t>(s.size() + 1);
+			};
+			for (const std::string& callback : state.callbacks) {
+				write_string_record(callback);
+			}
+			for (const Node* node : nodes) {
+				blob_offset += static_cast<uint32_t>(node->TextView().size() + 1);
+				for (const std::string& callback : node->selected_callbacks) {
+					write_string_record(callback);
+				}
+			}
+			written += string_count * sizeof(StringRecord);
+			WritePadding(sink, written);
+
+			for (const Node* node : nodes) {
+				for (int id : node->prevNodeIds) {
+					WriteRaw(sink, static_cast<int32_t>(id));
+				}
+				for (int id : node->responses) {
+					WriteRaw(sink, static_cast<int32_t>(id));
+				}
+			}
+			written += int_count * sizeof(int32_t);
+			WritePadding(sink, written);
+			report(0.6f);
+
+			for (const std::string& callback : state.callbacks) {
+				WriteString(sink, callback);
+			}
+			for (const Node* node : nodes) {
+				WriteString(sink, node->TextView());
+				for (const std::string& callback : node->selected_callbacks) {
+					WriteString(sink, callback);
+				}
+			}
+
+			return sink.Flush();
+		}
+	}
+
+	/******************************************************************************
+	 *                                  Reading
+	 ******************************************************************************/
+
+	bool BinaryStateView::Open(const std::string& path, std::string* error)
+	{
+		Close();
+
+		if (!file.Open(path)) {
+			return Fail(error, "could not open the file");
+		}
+
+		const uint8_t* data = file.Data();
+		const uint64_t size = file.Size();
+
+		if (size < sizeof(FileHeader)) {
+			Close();
+			return Fail(error, "file is too small to be a binary state");
+		}
+		const FileHeader* h = reinterpret_cast<const FileHeader*>(data);
+		if (std::memcmp(h->magic, Magic, sizeof(Magic)) != 0) {
+			Close();
+			return Fail(error, "not a binary state file");
+		}
+		if (h->version != Version || h->header_size < sizeof(FileHeader)) {
+			Close();
+			return Fail(error, "unsupported binary state version");
+		}
+		if (!RangeFits(h->node_table_offset, h->node_count, sizeof(NodeRecord), size) ||
+			!RangeFits(h->link_table_offset, h->link_count, sizeof(LinkRecord), size) ||
+			!RangeFits(h->string_table_offset, h->string_count, sizeof(StringRecord), size) ||
+			!RangeFits(h->int_pool_offset, h->int_count, sizeof(int32_t), size) ||
+			!RangeFits(h->string_blob_offset, h->string_blob_size, 1, size) ||
+			h->callback_count > h->string_count) {
+			Close();
+			return Fail(error, "binary state tables are out of bounds");
+		}
+
+		header = h;
+		nodes = { reinterpret_cast<const NodeRecord*>(data + h->node_table_offset), h->node_count };
+		links = { reinterpret_cast<const LinkRecord*>(data + h->link_table_offset), h->link_count };
+		strings = { reinterpret_cast<const StringRecord*>(data + h->string_table_offset), h->string_count };
+		ints = { reinterpret_cast<const int32_t*>(data + h->int_pool_offset), h->int_count };
+		blob = reinterpret_cast<const char*>(data + h->string_blob_offset);
+
+		if (!Validate(error)) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	// every offset and range in the tables has to stay inside its section, so the accessors never need to check
+	bool BinaryStateView::Validate(std::string* error) const
+	{
+		const uint64_t blob_size = header->string_blob_size;
+		auto string_fits = [&](uint64_t offset, uint64_t length) {
+			return offset + length < blob_size && blob[offset + length] == '\0';
+		};
+
+		for (const StringRecord& record : strings) {
+			if (!string_fits(record.offset, record.length)) {
+				return Fail(error, "binary state has a broken string");
+			}
+		}
+		for (const NodeRecord& node : nodes) {
+			if (!string_fits(node.text_offset, node.text_length) ||
+				uint64_t(node.prev_first) + node.prev_count > ints.size() ||
+				uint64_t(node.responses_first) + node.responses_count > ints.size() ||
+				uint64_t(node.callbacks_first) + node.callbacks_count > strings.size()) {
+				return Fail(error, "binary state has a broken node");
+			}
+			if (node.node_type != NodeType::Speech && node.node_type != NodeType::Response) {
+				return Fail(error, "binary state has a node of unknown type");
+			}
+		}
+		return true;
+	}
+
+	void BinaryStateView::Close()
+	{
+		file.Close();
+		header = nullptr;
+		nodes = {};
+		links = {};
+		strings = {};
+		ints = {};
+		blob = nullptr;
+	}
+
+	std::string_view BinaryStateView::String(const StringRecord& record) const
+	{
+		return { blob + record.offset, record.length };
+	}
+
+	std::string_view BinaryStateView::Text(const NodeRecord& node) const
+	{
+		return { blob + node.text_offset, node.text_length };
+	}
+
+	std::span<const int32_t> BinaryStateView::PrevNodeIds(const NodeRecord& node) const
+	{
+		return ints.subspan(node.prev_first, node.prev_count);
+	}
+
+	std::span<const int32_t> BinaryStateView::Responses(const NodeRecord& node) const
+	{
+		return ints.subspan(node.responses_first, node.responses_count);
+	}
+
+	std::span<const StringRecord> BinaryStateView::SelectedCallbacks(const NodeRecord& node) const
+	{
+		return strings.subspan(node.callbacks_first, node.callbacks_count);
+	}
+
+	std::shared_ptr<Node> BinaryStateView::MakeNode(const NodeRecord& record, TextLoading text_loading) const
+	{
+		const bool lazy = text_loading == TextLoading::Lazy && record.text_length > 0;
+		auto node = std::make_shared<Node>(record.id, static_cast<NodeType>(record.node_type),
+			lazy ? std::string() : std::string(Text(record)), ImVec2(record.x, record.y));
+		if (lazy) {
+			node->lazy_text = Text(record);
+		}
+		node->nextNodeId = record.next_node_id;
+		node->expectesResponse = (record.flags & NodeFlags_ExpectsResponse) != 0;
+		std::span<const int32_t> prev = PrevNodeIds(record);
+		node->prevNodeIds.assign(prev.begin(), prev.end());
+		std::span<const int32_t> responses = Responses(record);
+		node->responses.assign(responses.begin(), responses.end());
+		for (const StringRecord& callback : SelectedCallbacks(record)) {
+			node->selected_callbacks.emplace(String(callback));
+		}
+		return node;
+	}
+
+	State BinaryStateView::ToState(TextLoading text_loading) const
+	{
+		State state;
+		state.next_node_id = header->next_node_id;
+		state.next_link_id = header->next_link_id;
+
+		for (const StringRecord& callback : Callbacks()) {
+			state.callbacks.emplace(String(callback));
+		}
+
+		state.nodes.reserve(nodes.size());
+		for (const NodeRecord& record : nodes) {
+			state.nodes[record.id] = MakeNode(record, text_loading);
+		}
+
+		state.links.reserve(links.size());
+		for (const LinkRecord& record : links) {
+			state.links[record.id] = std::make_shared<Link>(record.id, record.start_attr, record.end_attr);
+		}
+		return state;
+	}
+
+	bool ReadStateBinary(const std::string& path, State& out_state, std::string* error, TextLoading text_loading)
+	{
+		if (text_loading == TextLoading::Lazy) {
+			auto view = std::make_shared<BinaryStateView>();
+			if (!view->Open(path, error)) {
+				return false;
+			}
+			out_state = view->ToState(TextLoading::Lazy);
+			out_state.text_storage = std::move(view);
+			out_state.text_storage_path = path;
+			return true;
+		}
+
+		BinaryStateView view;
+		if (!view.Open(path, error)) {
+			return false;
+		}
+		out_state = view.ToState();
+		return true;
+	}
+}
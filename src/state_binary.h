@@ -0,0 +1,158 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+/******************************************************************************
+ *      Binary save format, laid out to be memory mapped and read in place
+ *
+ *   [FileHeader][NodeRecord * node_count][LinkRecord * link_count]
+ *   [StringRecord * string_count][int32 * int_count][string blob]
+ *
+ *   Everything is little-endian and every section starts 8-byte aligned.
+ *   The first callback_count string records are the state's callbacks,
+ *   the rest are the nodes' selected callbacks. Strings in the blob are
+ *   NUL-terminated, so they can be handed to ImGui as they are.
+ ******************************************************************************/
+
+namespace ede
+{
+	namespace binary
+	{
+		constexpr char     Magic[4] = { 'E', 'D', 'E', 'B' };
+		constexpr uint32_t Version = 1;
+		constexpr const char* Extension = ".edeb";
+
+		enum NodeFlags : uint32_t
+		{
+			NodeFlags_None = 0,
+			NodeFlags_ExpectsResponse = 1 << 0,
+		};
+
+		struct FileHeader
+		{
+			char     magic[4];
+			uint32_t version;
+			uint32_t header_size; // sizeof(FileHeader) of the writer, newer versions may append fields
+			uint32_t flags;       // reserved, always 0 for now
+			int32_t  next_node_id;
+			int32_t  next_link_id;
+			uint32_t node_count;
+			uint32_t link_count;
+			uint32_t string_count;
+			uint32_t callback_count;
+			uint32_t int_count;
+			uint32_t reserved;
+			uint64_t node_table_offset;
+			uint64_t link_table_offset;
+			uint64_t string_table_offset;
+			uint64_t int_pool_offset;
+			uint64_t string_blob_offset;
+			uint64_t string_blob_size;
+		};
+
+		struct NodeRecord
+		{
+			int32_t  id;
+			int32_t  node_type;
+			int32_t  next_node_id;
+			uint32_t flags; // NodeFlags
+			float    x, y;
+			uint32_t text_offset; // into the string blob
+			uint32_t text_length; // without the NUL terminator
+			uint32_t prev_first, prev_count; // into the int pool
+			uint32_t responses_first, responses_count; // into the int pool
+			uint32_t callbacks_first, callbacks_count; // into the string table
+		};
+
+		struct LinkRecord
+		{
+			int32_t id;
+			int32_t start_attr;
+			int32_t end_attr;
+		};
+
+		struct StringRecord
+		{
+			uint32_t offset; // into the string blob
+			uint32_t length; // without the NUL terminator
+		};
+
+		static_assert(sizeof(FileHeader) == 96);
+		static_assert(sizeof(NodeRecord) == 56);
+		static_assert(sizeof(LinkRecord) == 12);
+		static_assert(sizeof(StringRecord) == 8);
+	}
+
+	// how node texts get from a binary file into a State
+	enum class TextLoading
+	{
+		Copy, // every text is copied into its node
+		Lazy, // nodes point into the mapped file (Node::lazy_text) until MaterializeText()
+	};
+
+	// true for paths ending in binary::Extension, case insensitive
+	bool IsBinaryStatePath(const std::string& path);
+
+	// Writes the state in the binary format. Node positions are taken from Node::position.
+	bool WriteStateBinary(const State& state, const std::string& path);
+	bool WriteStateBinary(const State& state, std::FILE* file, const std::function<void(float)>& on_progress = {});
+
+	// Read-only view over a mapped binary save file. Open() only validates the header and tables,
+	// nothing is parsed or copied; every accessor reads straight out of the mapping.
+	class BinaryStateView
+	{
+	public:
+		bool Open(const std::string& path, std::string* error = nullptr);
+		void Close();
+		bool IsOpen() const { return header != nullptr; }
+
+		const binary::FileHeader& Header() const { return *header; }
+
+		std::span<const binary::NodeRecord>   Nodes() const { return nodes; }
+		std::span<const binary::LinkRecord>   Links() const { return links; }
+		std::span<const binary::StringRecord> Callbacks() const { return strings.first(header->callback_count); }
+
+		std::string_view                      String(const binary::StringRecord& record) const;
+		std::string_view                      Text(const binary::NodeRecord& node) const;
+		std::span<const int32_t>              PrevNodeIds(const binary::NodeRecord& node) const;
+		std::span<const int32_t>              Responses(const binary::NodeRecord& node) const;
+		std::span<const binary::StringRecord> SelectedCallbacks(const binary::NodeRecord& node) const;
+
+		// Copies everything into an editable state. With TextLoading::Lazy, texts aren't copied
+		// and the view must outlive the state's lazy texts.
+		State ToState(TextLoading text_loading = TextLoading::Copy) const;
+
+		// one node of ToState(), for callers building the state piece by piece
+		std::shared_ptr<Node> MakeNode(const binary::NodeRecord& record, TextLoading text_loading = TextLoading::Copy) const;
+
+	private:
+		bool Validate(std::string* error) const;
+
+		MappedFile                            file;
+		const binary::FileHeader*             header = nullptr;
+		std::span<const binary::NodeRecord>   nodes;
+		std::span<const binary::LinkRecord>   links;
+		std::span<const binary::StringRecord> strings;
+		std::span<const int32_t>              ints;
+		const char*                           blob = nullptr;
+	};
+
+	// Maps the file and copies it into out_state, which is only touched on success.
+	// With TextLoading::Lazy the mapping stays open, owned by out_state.text_storage, for as long as a copy of the state uses it.
+	bool ReadStateBinary(const std::string& path, State& out_state, std::string* error = nullptr,
+		TextLoading text_loading = TextLoading::Copy);
+}
@@ -0,0 +1,263 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "state_hash.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace ede
+{
+	namespace
+	{
+		// FNV-1a over the fields, finished with a strong mix so that sums of hashes stay well spread
+		class Hasher
+		{
+		public:
+			explicit Hasher(uint8_t kind) { Byte(kind); }
+
+			void Byte(uint8_t b) {
+				value = (value ^ b) * 0x100000001B3ull;
+			}
+
+			void U32(uint32_t v) {
+				for (int i = 0; i < 4; i++) {
+					Byte(static_cast<uint8_t>(v >> (i * 8)));
+				}
+			}
+
+			void I32(int32_t v) { U32(static_cast<uint32_t>(v)); }
+
+			void U64(uint64_t v) {
+				U32(static_cast<uint32_t>(v));
+				U32(static_cast<uint32_t>(v >> 32));
+			}
+
+			void F32(float v) {
+				uint32_t bits;
+				std::memcpy(&bits, &v, sizeof(bits));
+				U32(bits);
+			}
+
+			// length first, so neighbouring strings can't trade characters
+			void Str(std::string_view s) {
+				U32(static_cast<uint32_t>(s.size()));
+				for (char c : s) {
+					Byte(static_cast<uint8_t>(c));
+				}
+			}
+
+			uint64_t Finish() const { return Mix(value); }
+
+			// splitmix64's finalizer
+			static uint64_t Mix(uint64_t x) {
+				x ^= x >> 30;
+				x *= 0xBF58476D1CE4E5B9ull;
+				x ^= x >> 27;
+				x *= 0x94D049BB133111EBull;
+				x ^= x >> 31;
+				return x;
+			}
+
+		private:
+			uint64_t value = 0xCBF29CE484222325ull;
+		};
+
+		// keeps a node, a link and a callback with the same bytes from hashing alike
+		enum Kind : uint8_t
+		{
+			Kind_Node = 1,
+			Kind_Link = 2,
+			Kind_Callback = 3,
+		};
+
+		uint64_t HashCallback(const std::string& callback)
+		{
+			Hasher h(Kind_Callback);
+			h.Str(callback);
+			return h.Finish();
+		}
+
+		uint64_t CombineSums(uint64_t nodes_sum, uint64_t links_sum, uint64_t callbacks_sum)
+		{
+			uint64_t hash = Hasher::Mix(nodes_sum);
+			hash = Hasher::Mix(hash ^ links_sum);
+			return Hasher::Mix(hash ^ callbacks_sum);
+		}
+	}
+
+	std::vector<const Node*> NodesInIdOrder(const State& state)
+	{
+		std::vector<const Node*> nodes;
+		nodes.reserve(state.nodes.size());
+		for (const auto& pair : state.nodes) {
+			if (pair.second) {
+				nodes.push_back(pair.second.get());
+			}
+		}
+		std::sort(nodes.begin(), nodes.end(), [](const Node* a, const Node* b) { return a->id < b->id; });
+		return nodes;
+	}
+
+	std::vector<const Link*> LinksInIdOrder(const State& state)
+	{
+		std::vector<const Link*> links;
+		links.reserve(state.links.size());
+		for (const auto& pair : state.links) {
+			if (pair.second) {
+				links.push_back(pair.second.get());
+			}
+		}
+		std::sort(links.begin(), links.end(), [](const Link* a, const Link* b) { return a->id < b->id; });
+		return links;
+	}
+
+	uint64_t HashNode(const Node& node)
+	{
+		Hasher h(Kind_Node);
+		h.I32(node.id);
+		h.I32(static_cast<int32_t>(node.nodeType));
+		h.I32(node.nextNodeId);
+		h.Byte(node.expectesResponse ? 1 : 0);
+		h.F32(node.position.x);
+		h.F32(node.position.y);
+		// A text from a file is hashed by where it lies in the mapping, reading it would page the file in. Drawing a node
+		// copies its text out, the copy hashes the same until it's edited and is hashed by its contents from then on
+		const std::string_view origin = node.TextOrigin();
+		h.Byte(origin.data() != nullptr ? 1 : 0);
+		if (origin.data() != nullptr) {
+			h.U64(reinterpret_cast<uintptr_t>(origin.data()));
+			h.U32(static_cast<uint32_t>(origin.size()));
+		}
+		else {
+			h.Str(node.text);
+		}
+		h.U32(static_cast<uint32_t>(node.prevNodeIds.size()));
+		for (int id : node.prevNodeIds) {
+			h.I32(id);
+		}
+		h.U32(static_cast<uint32_t>(node.responses.size()));
+		for (int id : node.responses) {
+			h.I32(id);
+		}
+		h.U32(static_cast<uint32_t>(node.selected_callbacks.size()));
+		for (const std::string& callback : node.selected_callbacks) {
+			h.Str(callback);
+		}
+		return h.Finish();
+	}
+
+	uint64_t HashLink(const Link& link)
+	{
+		Hasher h(Kind_Link);
+		h.I32(link.id);
+		h.I32(link.start_attr);
+		h.I32(link.end_attr);
+		return h.Finish();
+	}
+
+	uint64_t HashState(const State& state)
+	{
+		uint64_t nodes_sum = 0, links_sum = 0, callbacks_sum = 0;
+		for (const auto& pair : state.nodes) {
+			if (pair.second) {
+				nodes_sum += HashNode(*pair.second);
+			}
+		}
+		for (const auto& pair : state.links) {
+			if (pair.second) {
+				links_sum += HashLink(*pair.second);
+			}
+		}
+		for (const std::string& callback : state.callbacks) {
+			callbacks_sum += HashCallback(callback);
+		}
+		return CombineSums(nodes_sum, links_sum, callbacks_sum);
+	}
+
+	/******************************************************************************
+	 *                              ContentHasher
+	 ******************************************************************************/
+
+	uint64_t ContentHasher::Hash() const
+	{
+		return CombineSums(nodes_sum, links_sum, callbacks_sum);
+	}
+
+	void ContentHasher::OnStateReset(const State& state)
+	{
+		node_hashes.clear();
+		link_hashes.clear();
+		nodes_sum = links_sum = callbacks_sum = 0;
+		node_hashes.reserve(state.nodes.size());
+		link_hashes.reserve(state.links.size());
+		for (const auto& pair : state.nodes) {
+			if (pair.second) {
+				OnNodeAdded(*pair.second);
+			}
+		}
+		for (const auto& pair : state.links) {
+			if (pair.second) {
+				OnLinkAdded(*pair.second);
+			}
+		}
+		for (const std::string& callback : state.callbacks) {
+			callbacks_sum += HashCallback(callback);
+		}
+	}
+
+	void ContentHasher::OnNodeAdded(const Node& node)
+	{
+		uint64_t& hash = node_hashes[node.id];
+		nodes_sum -= hash;
+		hash = HashNode(node);
+		nodes_sum += hash;
+	}
+
+	void ContentHasher::OnNodeRemoved(int node_id)
+	{
+		auto it = node_hashes.find(node_id);
+		if (it != node_hashes.end()) {
+			nodes_sum -= it->second;
+			node_hashes.erase(it);
+		}
+	}
+
+	void ContentHasher::OnNodeChanged(const Node& node, NodeChange)
+	{
+		OnNodeAdded(node);
+	}
+
+	void ContentHasher::OnLinkAdded(const Link& link)
+	{
+		uint64_t& hash = link_hashes[link.id];
+		links_sum -= hash;
+		hash = HashLink(link);
+		links_sum += hash;
+	}
+
+	void ContentHasher::OnLinkRemoved(int link_id)
+	{
+		auto it = link_hashes.find(link_id);
+		if (it != link_hashes.end()) {
+			links_sum -= it->second;
+			link_hashes.erase(it);
+		}
+	}
+
+	// the editor only reports callbacks that were really added or removed
+	void ContentHasher::OnCallbackAdded(const std::string& callback)
+	{
+		callbacks_sum += HashCallback(callback);
+	}
+
+	void ContentHasher::OnCallbackRemoved(const std::string& callback)
+	{
+		callbacks_sum -= HashCallback(callback);
+	}
+}
@@ -0,0 +1,64 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "state_listener.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/******************************************************************************
+ *            Canonical order and content hashes of a state
+ *
+ *   Writers go through the nodes and links in id order, so saving the
+ *   same graph twice gives the same bytes. The content hash covers
+ *   everything a save writes except the id counters: every node and
+ *   link is hashed on its own and the state's hash is built from the
+ *   sums of those, so one edit updates it without touching the rest.
+ *   Texts a lazy load left in their file count by where they are, so
+ *   hashing a freshly loaded state reads none of them.
+ ******************************************************************************/
+
+namespace ede
+{
+	// non-null nodes and links sorted by id, the order every writer uses
+	std::vector<const Node*> NodesInIdOrder(const State& state);
+	std::vector<const Link*> LinksInIdOrder(const State& state);
+
+	uint64_t HashNode(const Node& node);
+	uint64_t HashLink(const Link& link);
+
+	// Hash of the whole state computed from scratch, equal to what a ContentHasher
+	// that saw the state reset and every edit since then holds
+	uint64_t HashState(const State& state);
+
+	// Keeps the content hash of the state it listens to up to date, each edit costs what hashing the edited node costs
+	class ContentHasher : public StateListener
+	{
+	public:
+		uint64_t Hash() const;
+
+		void OnStateReset(const State& state) override;
+		void OnNodeAdded(const Node& node) override;
+		void OnNodeRemoved(int node_id) override;
+		void OnNodeChanged(const Node& node, NodeChange change) override;
+		void OnLinkAdded(const Link& link) override;
+		void OnLinkRemoved(int link_id) override;
+		void OnCallbackAdded(const std::string& callback) override;
+		void OnCallbackRemoved(const std::string& callback) override;
+
+	private:
+		std::unordered_map<int, uint64_t> node_hashes;
+		std::unordered_map<int, uint64_t> link_hashes;
+		uint64_t nodes_sum = 0;
+		uint64_t links_sum = 0;
+		uint64_t callbacks_sum = 0;
+	};
+}
@@ -0,0 +1,755 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "state_io.h"
+#include "file_sink.h"
+#include "state_hash.h"
+#include "state_operations.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ede
+{
+	namespace
+	{
+		/******************************************************************************
+		 *                              Json writer
+		 ******************************************************************************/
+
+		// Writes json token by token with the exact layout of json::dump(4):
+		// one member or element per line, 4 spaces per level and "[]"/"{}" for empty containers.
+		// Keys are written in the order they are given, so callers pass them sorted like json's std::map would.
+		class JsonWriter
+		{
+		public:
+			explicit JsonWriter(FileSink& _sink) : sink(_sink) {}
+
+			void BeginObject() { BeginContainer('{'); }
+			void EndObject() { EndContainer('}'); }
+			void BeginArray() { BeginContainer('['); }
+			void EndArray() { EndContainer(']'); }
+
+			void Key(const char* key) {
+				BeginValue();
+				sink.Write('"');
+				WriteEscaped(key);
+				sink.Write("\": ", 3);
+				after_key = true;
+			}
+
+			void Null() {
+				BeginValue();
+				sink.Write("null", 4);
+			}
+
+			void Bool(bool value) {
+				BeginValue();
+				value ? sink.Write("true", 4) : sink.Write("false", 5);
+			}
+
+			void Int(int value) {
+				BeginValue();
+				std::array<char, 16> chars;
+				auto result = std::to_chars(chars.data(), chars.data() + chars.size(), value);
+				sink.Write(chars.data(), result.ptr - chars.data());
+			}
+
+			// shortest round-trip formatting, with the ".0" json adds to whole numbers so they read back as doubles
+			void Double(double value) {
+				BeginValue();
+				if (!std::isfinite(value)) {
+					sink.Write("null", 4);
+					return;
+				}
+				std::array<char, 64> chars;
+				auto result = std::to_chars(chars.data(), chars.data() + chars.size() - 2, value);
+				char* end = result.ptr;
+				if (std::find_if(chars.data(), end, [](char c) { return c == '.' || c == 'e'; }) == end) {
+					*end++ = '.';
+					*end++ = '0';
+				}
+				sink.Write(chars.data(), end - chars.data());
+			}
+
+			void String(std::string_view value) {
+				BeginValue();
+				sink.Write('"');
+				WriteEscaped(value);
+				sink.Write('"');
+			}
+
+		private:
+			struct Scope {
+				bool has_values = false;
+			};
+
+			// separates a new member/element from the previous one and indents it
+			void BeginValue() {
+				if (after_key) {
+					after_key = false;
+					return;
+				}
+				if (scopes.empty()) {
+					return;
+				}
+				Scope& scope = scopes.back();
+				scope.has_values ? sink.Write(",\n", 2) : sink.Write('\n');
+				scope.has_values = true;
+				Indent(scopes.size());
+			}
+
+			void BeginContainer(char open) {
+				BeginValue();
+				sink.Write(open);
+				scopes.push_back({});
+			}
+
+			void EndContainer(char close) {
+				bool has_values = scopes.back().has_values;
+				scopes.pop_back();
+				if (has_values) {
+					sink.Write('\n');
+					Indent(scopes.size());
+				}
+				sink.Write(close);
+			}
+
+			void Indent(size_t depth) {
+				static const char spaces[] = "                                ";
+				size_t count = depth * 4;
+				while (count > 0) {
+					size_t chunk = count < sizeof(spaces) - 1 ? count : sizeof(spaces) - 1;
+					sink.Write(spaces, chunk);
+					count -= chunk;
+				}
+			}
+
+			// escapes like json does with ensure_ascii off; text coming from ImGui is valid UTF-8,
+			// so multi-byte sequences are copied through untouched
+			void WriteEscaped(std::string_view value) {
+				size_t run_start = 0;
+				for (size_t i = 0; i < value.size(); ++i) {
+					unsigned char c = static_cast<unsigned char>(value[i]);
+					if (c >= 0x20 && c != '"' && c != '\\') {
+						continue;
+					}
+					sink.Write(value.data() + run_start, i - run_start);
+					run_start = i + 1;
+
+					switch (c) {
+					case '\b': sink.Write("\\b", 2); break;
+					case '\t': sink.Write("\\t", 2); break;
+					case '\n': sink.Write("\\n", 2); break;
+					case '\f': sink.Write("\\f", 2); break;
+					case '\r': sink.Write("\\r", 2); break;
+					case '"':  sink.Write("\\\"", 2); break;
+					case '\\': sink.Write("\\\\", 2); break;
+					default: {
+						static const char hex[] = "0123456789abcdef";
+						const char escaped[] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+						sink.Write(escaped, sizeof(escaped));
+						break;
+					}
+					}
+				}
+				sink.Write(value.data() + run_start, value.size() - run_start);
+			}
+
+			FileSink&          sink;
+			std::vector<Scope> scopes;
+			bool               after_key = false;
+		};
+
+		template<typename Container>
+		void WriteStrings(JsonWriter& writer, const Container& strings) {
+			writer.BeginArray();
+			for (const std::string& s : strings) {
+				writer.String(s);
+			}
+			writer.EndArray();
+		}
+
+		// Keys in alphabetical order, like json's object_t sorts them.
+		// nextNodeId, responses and prevNodeIds aren't written, the links say the same thing and the reader rebuilds them
+		void WriteNode(JsonWriter& writer, const Node& node) {
+			writer.BeginObject();
+			writer.Key("expectsResponse");    writer.Bool(node.expectesResponse);
+			writer.Key("nodeId");             writer.Int(node.id);
+			writer.Key("nodeType");           writer.Int(static_cast<int>(node.nodeType));
+			writer.Key("position");
+			writer.BeginObject();
+			writer.Key("x");                  writer.Double(node.position.x);
+			writer.Key("y");                  writer.Double(node.position.y);
+			writer.EndObject();
+			writer.Key("selected_callbacks"); WriteStrings(writer, node.selected_callbacks);
+			writer.Key("text");               writer.String(node.TextView());
+			writer.EndObject();
+		}
+
+		// by node ids, the pins are derived from them on load
+		void WriteLink(JsonWriter& writer, const Connection& connection) {
+			writer.BeginObject();
+			writer.Key("from"); writer.Int(connection.from);
+			writer.Key("id");   writer.Int(connection.link_id);
+			writer.Key("to");   writer.Int(connection.to);
+			writer.EndObject();
+		}
+
+		// counts written nodes and links, reporting every few thousands of them
+		struct ProgressCounter
+		{
+			const std::function<void(float)>& on_progress;
+			size_t total;
+			size_t done = 0;
+
+			void Step() {
+				if (on_progress && (++done % 4096) == 0) {
+					on_progress(static_cast<float>(done) / total);
+				}
+			}
+		};
+
+	}
+
+	bool WriteStateJson(const State& state, std::FILE* file, const std::function<void(float)>& on_progress)
+	{
+		FileSink sink(file);
+		JsonWriter writer(sink);
+		ProgressCounter progress{ on_progress, state.nodes.size() + state.links.size() };
+
+		writer.BeginObject();
+		writer.Key("callbacks");    WriteStrings(writer, state.callbacks);
+		writer.Key("links");
+		writer.BeginArray();
+		for (const Connection& connection : ResolveConnections(state)) {
+			WriteLink(writer, connection);
+			progress.Step();
+		}
+		writer.EndArray();
+		writer.Key("next_link_id"); writer.Int(state.next_link_id);
+		writer.Key("next_node_id"); writer.Int(state.next_node_id);
+		writer.Key("nodes");
+		writer.BeginArray();
+		for (const Node* node : NodesInIdOrder(state)) {
+			WriteNode(writer, *node);
+			progress.Step();
+		}
+		writer.EndArray();
+		/* TODO: place 'conditionals' here, once its implemented */
+		writer.Key("version");      writer.Int(StateFormatVersion);
+		writer.EndObject();
+
+		return sink.Flush();
+	}
+
+	bool WriteStateJson(const State& state, const std::string& path)
+	{
+		// text mode, same as the std::ofstream this replaced
+		std::FILE* file = std::fopen(path.c_str(), "w");
+		if (file == nullptr) {
+			return false;
+		}
+		bool success = WriteStateJson(state, file);
+		success = std::fclose(file) == 0 && success;
+		return success;
+	}
+
+	namespace
+	{
+		/******************************************************************************
+		 *                              Json reader
+		 ******************************************************************************/
+
+		using json = nlohmann::json;
+
+		// where in the document the parser currently is
+		enum class Context
+		{
+			None,
+			Root,
+			Nodes,
+			Node,
+			Position,
+			PrevNodeIds,
+			Responses,
+			SelectedCallbacks,
+			Links,
+			Link,
+			Callbacks,
+		};
+
+		// the member whose value comes next. Members we don't know about are skipped,
+		// so files written by newer versions still load
+		enum class Field
+		{
+			None,
+			Unknown,
+			// root
+			Nodes,
+			Links,
+			NextNodeId,
+			NextLinkId,
+			Callbacks,
+			Version,
+			// node
+			NodeId,
+			NodeType,
+			Text,
+			Position,
+			NextNodeIdOfNode,
+			PrevNodeIds,
+			Responses,
+			ExpectsResponse,
+			SelectedCallbacks,
+			// position
+			X,
+			Y,
+			// link
+			LinkId,
+			StartAttr,
+			EndAttr,
+			From,
+			To,
+		};
+
+		constexpr uint32_t Bit(Field f) { return 1u << static_cast<uint32_t>(f); }
+
+		constexpr uint32_t TopRequired = Bit(Field::Nodes) | Bit(Field::Links) | Bit(Field::NextNodeId) |
+			Bit(Field::NextLinkId) | Bit(Field::Callbacks);
+		constexpr uint32_t NodeRequired = Bit(Field::NodeId) | Bit(Field::NodeType) | Bit(Field::Text) |
+			Bit(Field::Position) | Bit(Field::ExpectsResponse) | Bit(Field::SelectedCallbacks);
+		// only in version 1 files, later ones rebuild them from the links
+		constexpr uint32_t NodeConnections = Bit(Field::NextNodeIdOfNode) | Bit(Field::PrevNodeIds) | Bit(Field::Responses);
+		constexpr uint32_t LinkPins = Bit(Field::StartAttr) | Bit(Field::EndAttr);
+		constexpr uint32_t LinkEnds = Bit(Field::From) | Bit(Field::To);
+
+		// Receives the parser's events one by one and builds the state out of them.
+		// Nodes and links are allocated as soon as their object starts and filled in place,
+		// strings are moved out of the parser instead of copied.
+		class StateSaxHandler : public nlohmann::json_sax<json>
+		{
+		public:
+			explicit StateSaxHandler(State& _state) : state(_state) {}
+
+			std::string error;
+
+			// Every member the file has to provide, checked once parsing is done, since "version" comes last.
+			// The nodes' connections and the links' pins are rebuilt out of the links here. Version 1 files
+			// also store them in the nodes, those only serve to resolve each link's start node
+			bool Finish() {
+				if ((top_seen & TopRequired) != TopRequired) {
+					return Fail("missing one of nodes, links, next_node_id, next_link_id or callbacks");
+				}
+				if (version > StateFormatVersion) {
+					return Fail("saved by a newer version of the editor (format " + std::to_string(version) + ")");
+				}
+				if (version >= 2) {
+					if (link_without_ends != -1) {
+						return Fail("link " + std::to_string(link_without_ends) + " is missing from or to");
+					}
+					RebuildConnections(state, connections);
+					return true;
+				}
+				if (node_without_connections != -1) {
+					return Fail("node " + std::to_string(node_without_connections) + " is missing some of its fields");
+				}
+				if (link_without_pins != -1) {
+					return Fail("link " + std::to_string(link_without_pins) + " is missing some of its fields");
+				}
+				RebuildConnections(state, ResolveConnections(state));
+				return true;
+			}
+
+			bool null() override {
+				if (SkipValue()) return true;
+				// what the DOM serializer writes for an empty node/link array
+				if (Top() == Context::Root && (field == Field::Nodes || field == Field::Links)) {
+					MarkSeen();
+					return true;
+				}
+				return Fail("unexpected null");
+			}
+
+			bool boolean(bool val) override {
+				if (SkipValue()) return true;
+				if (Top() == Context::Node && field == Field::ExpectsResponse) {
+					node->expectesResponse = val;
+					MarkSeen();
+					return true;
+				}
+				return Fail("unexpected boolean");
+			}
+
+			bool number_integer(number_integer_t val) override { return Number(val); }
+			bool number_unsigned(number_unsigned_t val) override { return Number(val); }
+			bool number_float(number_float_t val, const string_t&) override { return Number(val); }
+
+			bool string(string_t& val) override {
+				if (SkipValue()) return true;
+				switch (Top()) {
+				case Context::Callbacks:
+					state.callbacks.insert(std::move(val));
+					return true;
+				case Context::SelectedCallbacks:
+					node->selected_callbacks.insert(std::move(val));
+					return true;
+				case Context::Node:
+					if (field == Field::Text) {
+						node->text = std::move(val);
+						MarkSeen();
+						return true;
+					}
+					break;
+				default:
+					break;
+				}
+				return Fail("unexpected string");
+			}
+
+			bool binary(binary_t&) override {
+				return Fail("unexpected binary value");
+			}
+
+			bool start_object(std::size_t) override {
+				if (SkipContainer()) return true;
+				switch (Top()) {
+				case Context::None:
+					stack.push_back(Context::Root);
+					return true;
+				case Context::Nodes:
+					node = std::make_shared<Node>(0, NodeType::Speech, std::string(), ImVec2());
+					node_seen = 0;
+					stack.push_back(Context::Node);
+					return true;
+				case Context::Links:
+					link = std::make_shared<Link>(0, 0, 0);
+					link_seen = 0;
+					link_from = link_to = -1;
+					stack.push_back(Context::Link);
+					return true;
+				case Context::Node:
+					if (field == Field::Position) {
+						MarkSeen();
+						position_seen = 0;
+						stack.push_back(Context::Position);
+						return true;
+					}
+					break;
+				default:
+					break;
+				}
+				return Fail("unexpected object");
+			}
+
+			bool end_object() override {
+				if (skip_depth > 0) {
+					skip_depth--;
+					return true;
+				}
+				switch (Top()) {
+				case Context::Node:
+					if ((node_seen & NodeRequired) != NodeRequired) {
+						return Fail("node " + std::to_string(node->id) + " is missing some of its fields");
+					}
+					if ((node_seen & NodeConnections) != NodeConnections && node_without_connections == -1) {
+						node_without_connections = node->id;
+					}
+					state.nodes[node->id] = std::move(node);
+					break;
+				case Context::Link:
+					if (!(link_seen & Bit(Field::LinkId))) {
+						return Fail("a link is missing its id");
+					}
+					if ((link_seen & LinkEnds) == LinkEnds) {
+						connections.push_back({ link->id, link_from, link_to });
+					}
+					else if (link_without_ends == -1) {
+						link_without_ends = link->id;
+					}
+					if ((link_seen & LinkPins) != LinkPins && link_without_pins == -1) {
+						link_without_pins = link->id;
+					}
+					state.links[link->id] = std::move(link);
+					break;
+				case Context::Position:
+					if (position_seen != 0b11) {
+						return Fail("node position needs both x and y");
+					}
+					break;
+				default:
+					break;
+				}
+				stack.pop_back();
+				field = Field::None;
+				return true;
+			}
+
+			bool start_array(std::size_t) override {
+				if (SkipContainer()) return true;
+				Context context = Context::None;
+				if (Top() == Context::Root) {
+					switch (field) {
+					case Field::Nodes:     context = Context::Nodes; break;
+					case Field::Links:     context = Context::Links; break;
+					case Field::Callbacks: context = Context::Callbacks; break;
+					default: break;
+					}
+				}
+				else if (Top() == Context::Node) {
+					switch (field) {
+					case Field::PrevNodeIds:       context = Context::PrevNodeIds; break;
+					case Field::Responses:         context = Context::Responses; break;
+					case Field::SelectedCallbacks: context = Context::SelectedCallbacks; break;
+					default: break;
+					}
+				}
+				if (context == Context::None) {
+					return Fail("unexpected array");
+				}
+				MarkSeen();
+				stack.push_back(context);
+				return true;
+			}
+
+			bool end_array() override {
+				if (skip_depth > 0) {
+					skip_depth--;
+					return true;
+				}
+				stack.pop_back();
+				field = Field::None;
+				return true;
+			}
+
+			bool key(string_t& val) override {
+				if (skip_depth > 0) return true;
+				field = Field::Unknown;
+				switch (Top()) {
+				case Context::Root:
+					if (val == "nodes") field = Field::Nodes;
+					else if (val == "links") field = Field::Links;
+					else if (val == "next_node_id") field = Field::NextNodeId;
+					else if (val == "next_link_id") field = Field::NextLinkId;
+					else if (val == "callbacks") field = Field::Callbacks;
+					else if (val == "version") field = Field::Version;
+					break;
+				case Context::Node:
+					if (val == "nodeId") field = Field::NodeId;
+					else if (val == "nodeType") field = Field::NodeType;
+					else if (val == "text") field = Field::Text;
+					else if (val == "position") field = Field::Position;
+					else if (val == "nextNodeId") field = Field::NextNodeIdOfNode;
+					else if (val == "prevNodeIds") field = Field::PrevNodeIds;
+					else if (val == "responses") field = Field::Responses;
+					else if (val == "expectsResponse") field = Field::ExpectsResponse;
+					else if (val == "selected_callbacks") field = Field::SelectedCallbacks;
+					break;
+				case Context::Position:
+					if (val == "x") field = Field::X;
+					else if (val == "y") field = Field::Y;
+					break;
+				case Context::Link:
+					if (val == "id") field = Field::LinkId;
+					else if (val == "start_attr") field = Field::StartAttr;
+					else if (val == "end_attr") field = Field::EndAttr;
+					else if (val == "from") field = Field::From;
+					else if (val == "to") field = Field::To;
+					break;
+				default:
+					break;
+				}
+				return true;
+			}
+
+			bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+				return Fail(ex.what());
+			}
+
+		private:
+			Context Top() const {
+				return stack.empty() ? Context::None : stack.back();
+			}
+
+			void MarkSeen() {
+				switch (Top()) {
+				case Context::Root:     top_seen |= Bit(field); break;
+				case Context::Node:     node_seen |= Bit(field); break;
+				case Context::Link:     link_seen |= Bit(field); break;
+				case Context::Position: position_seen |= field == Field::X ? 0b01 : 0b10; break;
+				default: break;
+				}
+			}
+
+			// scalars inside skipped containers, or the value of an unknown member
+			bool SkipValue() {
+				if (skip_depth > 0) return true;
+				if (field == Field::Unknown && IsObjectContext()) {
+					field = Field::None;
+					return true;
+				}
+				return false;
+			}
+
+			bool SkipContainer() {
+				if (skip_depth > 0 || (field == Field::Unknown && IsObjectContext())) {
+					skip_depth++;
+					field = Field::None;
+					return true;
+				}
+				return false;
+			}
+
+			bool IsObjectContext() const {
+				Context top = Top();
+				return top == Context::Root || top == Context::Node || top == Context::Position || top == Context::Link;
+			}
+
+			// whole numbers in int range, ids and types. Doubles only go to positions
+			template<typename T>
+			static bool ToInt(T val, int& out) {
+				if constexpr (std::is_floating_point_v<T>) {
+					if (!(val >= std::numeric_limits<int>::min() && val <= std::numeric_limits<int>::max())) return false;
+				}
+				else if (!std::in_range<int>(val)) {
+					return false;
+				}
+				out = static_cast<int>(val);
+				return true;
+			}
+
+			template<typename T>
+			bool Number(T val) {
+				if (SkipValue()) return true;
+				if (Top() == Context::Position) {
+					if (!(std::abs(static_cast<double>(val)) <= std::numeric_limits<float>::max())) {
+						return Fail("position out of range");
+					}
+					if (field == Field::X) node->position.x = static_cast<float>(val);
+					else if (field == Field::Y) node->position.y = static_cast<float>(val);
+					else return Fail("unexpected number");
+					MarkSeen();
+					return true;
+				}
+
+				int as_int = 0;
+				if (!ToInt(val, as_int)) {
+					return Fail("number out of range");
+				}
+				switch (Top()) {
+				case Context::PrevNodeIds:
+					node->prevNodeIds.push_back(as_int);
+					return true;
+				case Context::Responses:
+					node->responses.push_back(as_int);
+					return true;
+				case Context::Root:
+					if (field == Field::NextNodeId) state.next_node_id = as_int;
+					else if (field == Field::NextLinkId) state.next_link_id = as_int;
+					else if (field == Field::Version) version = as_int;
+					else break;
+					MarkSeen();
+					return true;
+				case Context::Node:
+					if (field == Field::NodeId) node->id = as_int;
+					else if (field == Field::NodeType) {
+						if (as_int != NodeType::Speech && as_int != NodeType::Response) {
+							return Fail("unknown node type " + std::to_string(as_int));
+						}
+						node->nodeType = static_cast<NodeType>(as_int);
+					}
+					else if (field == Field::NextNodeIdOfNode) node->nextNodeId = as_int;
+					else break;
+					MarkSeen();
+					return true;
+				case Context::Link:
+					if (field == Field::LinkId) link->id = as_int;
+					else if (field == Field::StartAttr) link->start_attr = as_int;
+					else if (field == Field::EndAttr) link->end_attr = as_int;
+					else if (field == Field::From) link_from = as_int;
+					else if (field == Field::To) link_to = as_int;
+					else break;
+					MarkSeen();
+					return true;
+				default:
+					break;
+				}
+				return Fail("unexpected number");
+			}
+
+			bool Fail(const std::string& message) {
+				if (error.empty()) {
+					error = message;
+				}
+				return false;
+			}
+
+			State&                state;
+			std::vector<Context>  stack;
+			Field                 field = Field::None;
+			int                   skip_depth = 0;
+
+			std::shared_ptr<Node> node;
+			std::shared_ptr<Link> link;
+			uint32_t              top_seen = 0;
+			uint32_t              node_seen = 0;
+			uint32_t              link_seen = 0;
+			uint32_t              position_seen = 0;
+
+			int                     version = 1; // files from before the field was written are version 1
+			int                     link_from = -1;
+			int                     link_to = -1;
+			std::vector<Connection> connections;
+			// first offenders, only errors for the version they belong to
+			int                     node_without_connections = -1;
+			int                     link_without_pins = -1;
+			int                     link_without_ends = -1;
+		};
+	}
+
+	bool ReadStateJson(std::istream& stream, State& out_state, std::string* error)
+	{
+		State new_state;
+		StateSaxHandler handler(new_state);
+
+		bool success = json::sax_parse(stream, &handler) && handler.Finish();
+		if (!success) {
+			if (error != nullptr) {
+				*error = handler.error;
+			}
+			return false;
+		}
+		out_state = std::move(new_state);
+		return true;
+	}
+
+	bool ReadStateJson(const std::string& path, State& out_state, std::string* error)
+	{
+		// the parser pulls one character at a time, give the stream a generous buffer to pull from
+		std::vector<char> buffer(64 * 1024);
+		std::ifstream file;
+		file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+		file.open(path, std::ios::binary);
+		if (!file.is_open()) {
+			if (error != nullptr) {
+				*error = "could not open " + path;
+			}
+			return false;
+		}
+		return ReadStateJson(file, out_state, error);
+	}
+}
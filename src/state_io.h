@@ -0,0 +1,47 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include <cstdio>
+#include <functional>
+#include <istream>
+#include <string>
+
+/******************************************************************************
+ *              Reading and writing the editor's save files
+ *
+ *   Version 2 files keep each connection once, as a link from one node
+ *   to another. The nodes' nextNodeId, responses and prevNodeIds and
+ *   the links' pins are derived from the links when the file is read.
+ *   Version 1 files, which store all of those, are still read as they are.
+ ******************************************************************************/
+
+namespace ede
+{
+	// format WriteStateJson writes, saved in the file's "version" member
+	constexpr int StateFormatVersion = 2;
+
+	// on_progress, when given, is called every now and then by the writers with the fraction written so far.
+
+	// Streams the state into a save file without building a json DOM or the whole text in memory.
+	// The output is laid out like json::dump(4), with nodes and links in id order so the same state always
+	// gives the same bytes (see state_hash.h). Links whose nodes can't be found aren't written.
+	// Node positions are taken from Node::position, so sync them with the canvas before saving.
+	bool WriteStateJson(const State& state, const std::string& path);
+	bool WriteStateJson(const State& state, std::FILE* file, const std::function<void(float)>& on_progress = {});
+
+	// Parses a save file in a single pass, building the nodes and links straight into out_state
+	// as the parser reaches them, with no json DOM in between. out_state is only touched on success.
+	// Empty "nodes"/"links" arrays written as null by older versions are accepted.
+	// Connections are rebuilt from the links with RebuildConnections (state_operations.h), in version 1 files
+	// too, whose nodes' own copies could disagree with the links.
+	// On failure, error (if given) describes what was wrong with the file.
+	bool ReadStateJson(const std::string& path, State& out_state, std::string* error = nullptr);
+	bool ReadStateJson(std::istream& stream, State& out_state, std::string* error = nullptr);
+}
@@ -0,0 +1,74 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+ *              Change notifications for the dialogue model
+ ******************************************************************************/
+
+// which part of a node OnNodeChanged is about
+enum class NodeChange
+{
+	Text,
+	Position,
+	Connections,     // nextNodeId, prevNodeIds or responses
+	ExpectsResponse,
+	Callbacks,       // selected_callbacks
+};
+
+// Told about every change made to the editor's state, right after it happened.
+// Anything that keeps data derived from the state (journal, indices, stats...) can stay
+// up to date with these instead of walking the whole graph again.
+class StateListener
+{
+public:
+	virtual ~StateListener() = default;
+
+	// the whole state was replaced, by loading a file or starting a new one
+	virtual void OnStateReset(const State&) {}
+
+	virtual void OnNodeAdded(const Node&) {}
+	virtual void OnNodeRemoved(int) {}
+	virtual void OnNodeChanged(const Node&, NodeChange) {}
+	virtual void OnLinkAdded(const Link&) {}
+	virtual void OnLinkRemoved(int) {}
+
+	// removing a callback also takes it out of every node's selected_callbacks, without OnNodeChanged calls
+	virtual void OnCallbackAdded(const std::string&) {}
+	virtual void OnCallbackRemoved(const std::string&) {}
+};
+
+// Forwards every notification to each registered listener, in registration order
+class StateListenerList : public StateListener
+{
+public:
+	void Add(StateListener* listener) {
+		listeners.push_back(listener);
+	}
+
+	void Remove(StateListener* listener) {
+		listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+	}
+
+	void OnStateReset(const State& state) override { for (StateListener* l : listeners) l->OnStateReset(state); }
+	void OnNodeAdded(const Node& node) override { for (StateListener* l : listeners) l->OnNodeAdded(node); }
+	void OnNodeRemoved(int node_id) override { for (StateListener* l : listeners) l->OnNodeRemoved(node_id); }
+	void OnNodeChanged(const Node& node, NodeChange change) override { for (StateListener* l : listeners) l->OnNodeChanged(node, change); }
+	void OnLinkAdded(const Link& link) override { for (StateListener* l : listeners) l->OnLinkAdded(link); }
+	void OnLinkRemoved(int link_id) override { for (StateListener* l : listeners) l->OnLinkRemoved(link_id); }
+	void OnCallbackAdded(const std::string& callback) override { for (StateListener* l : listeners) l->OnCallbackAdded(callback); }
+	void OnCallbackRemoved(const std::string& callback) override { for (StateListener* l : listeners) l->OnCallbackRemoved(callback); }
+
+private:
+	std::vector<StateListener*> listeners;
+};
@@ -0,0 +1,208 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "state_operations.h"
+#include "state_hash.h"
+#include <unordered_set>
+#include <algorithm>
+#include <cstdint>
+
+namespace ede
+{
+	namespace
+	{
+		// pins are encoded the way the editor does it, overflow included, so they match the links' attributes
+		int InputPin(int node_id) { return static_cast<int>(static_cast<uint32_t>(node_id) << NodePartShift::InputPin); }
+		int OutputPin(int node_id) { return static_cast<int>(static_cast<uint32_t>(node_id) << NodePartShift::EndPin); }
+
+		// A link's start node, found among the prevNodeIds of its end node, since output pins of ids
+		// over 127 overflow and can't be decoded. -1 if neither that nor decoding finds it
+		int LinkStartNode(const State& state, const Link& link, const Node* end_node)
+		{
+			if (end_node != nullptr) {
+				for (int prev : end_node->prevNodeIds) {
+					if (OutputPin(prev) == link.start_attr) {
+						return prev;
+					}
+				}
+			}
+			const int decoded = static_cast<int>(static_cast<uint32_t>(link.start_attr) >> NodePartShift::EndPin);
+			return state.nodes.contains(decoded) ? decoded : -1;
+		}
+
+		// packs a (start node, end node) pair into a single key
+		uint64_t EdgeKey(int start_node_id, int end_node_id)
+		{
+			return (static_cast<uint64_t>(static_cast<uint32_t>(start_node_id)) << 32) | static_cast<uint32_t>(end_node_id);
+		}
+	}
+
+	void RemoveNodesAndLinks(State& state, const std::vector<int>& node_ids, const std::vector<int>& link_ids, StateListener* listener)
+	{
+		std::unordered_set<int> removed_nodes;
+		removed_nodes.reserve(node_ids.size());
+		for (int node_id : node_ids) {
+			// user shouldn't remove the root node
+			if (node_id != 0 && state.nodes.contains(node_id)) {
+				removed_nodes.insert(node_id);
+			}
+		}
+
+		// links are matched to the removed nodes by pin, like the editor encodes them
+		std::unordered_set<int> removed_output_pins, removed_input_pins;
+		removed_output_pins.reserve(removed_nodes.size());
+		removed_input_pins.reserve(removed_nodes.size());
+		for (int node_id : removed_nodes) {
+			removed_output_pins.insert(OutputPin(node_id));
+			removed_input_pins.insert(InputPin(node_id));
+		}
+
+		std::unordered_set<int> removed_links(link_ids.begin(), link_ids.end());
+		std::unordered_set<uint64_t> removed_edges;
+		std::unordered_set<int> touched_nodes;
+
+		auto touch = [&](int node_id) {
+			if (node_id != -1 && !removed_nodes.contains(node_id)) {
+				touched_nodes.insert(node_id);
+			}
+		};
+
+		// single pass over the links: drop the selected ones and every link attached to a removed node
+		for (auto it = state.links.begin(); it != state.links.end();) {
+			const std::shared_ptr<Link>& link = it->second;
+			if (!link) {
+				it = state.links.erase(it);
+				continue;
+			}
+			if (removed_links.contains(link->id) || removed_output_pins.contains(link->start_attr) || removed_input_pins.contains(link->end_attr)) {
+				// adjacency isn't patched before the loop is done, the end node still lists the start node
+				const int end_node_id = link->end_attr >> NodePartShift::InputPin;
+				const std::shared_ptr<Node> end_node = state.FindNode(end_node_id);
+				const int start_node_id = LinkStartNode(state, *link, end_node.get());
+				removed_edges.insert(EdgeKey(start_node_id, end_node_id));
+				touch(start_node_id);
+				touch(end_node_id);
+				if (listener) {
+					listener->OnLinkRemoved(link->id);
+				}
+				it = state.links.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+
+		// neighbours known only through the adjacency of removed nodes need patching as well
+		for (int node_id : removed_nodes) {
+			const std::shared_ptr<Node>& node = state.nodes.at(node_id);
+			if (!node) {
+				continue;
+			}
+			for (int prev_id : node->prevNodeIds) {
+				touch(prev_id);
+			}
+			for (int response_id : node->responses) {
+				touch(response_id);
+			}
+			touch(node->nextNodeId);
+		}
+
+		auto is_removed_edge = [&](int start_node_id, int end_node_id) {
+			return removed_nodes.contains(start_node_id) || removed_nodes.contains(end_node_id)
+				|| removed_edges.contains(EdgeKey(start_node_id, end_node_id));
+		};
+
+		for (int node_id : touched_nodes) {
+			std::shared_ptr<Node> node = state.FindNode(node_id);
+			if (!node) {
+				continue;
+			}
+
+			std::vector<int>& prev_ids = node->prevNodeIds;
+			prev_ids.erase(std::remove_if(prev_ids.begin(), prev_ids.end(),
+				[&](int prev_id) { return is_removed_edge(prev_id, node_id); }), prev_ids.end());
+
+			std::vector<int>& responses = node->responses;
+			responses.erase(std::remove_if(responses.begin(), responses.end(),
+				[&](int response_id) { return is_removed_edge(node_id, response_id); }), responses.end());
+
+			if (node->nextNodeId != -1 && is_removed_edge(node_id, node->nextNodeId)) {
+				node->nextNodeId = -1;
+			}
+			if (listener) {
+				listener->OnNodeChanged(*node, NodeChange::Connections);
+			}
+		}
+
+		for (int node_id : removed_nodes) {
+			state.nodes.erase(node_id);
+			if (listener) {
+				listener->OnNodeRemoved(node_id);
+			}
+		}
+	}
+
+	void MaterializeAllText(State& state)
+	{
+		for (auto& pair : state.nodes) {
+			if (pair.second) {
+				pair.second->MaterializeText();
+			}
+		}
+		state.text_storage.reset();
+		state.text_storage_path.clear();
+	}
+
+	std::vector<Connection> ResolveConnections(const State& state)
+	{
+		std::vector<Connection> connections;
+		connections.reserve(state.links.size());
+		for (const Link* link : LinksInIdOrder(state)) {
+			const int to = link->end_attr >> NodePartShift::InputPin;
+			std::shared_ptr<Node> end_node = state.FindNode(to);
+			if (!end_node) {
+				continue;
+			}
+			const int from = LinkStartNode(state, *link, end_node.get());
+			if (from == -1) {
+				continue;
+			}
+			connections.push_back({ link->id, from, to });
+		}
+		return connections;
+	}
+
+	void RebuildConnections(State& state, const std::vector<Connection>& connections)
+	{
+		for (auto& pair : state.nodes) {
+			if (pair.second) {
+				pair.second->nextNodeId = -1;
+				pair.second->responses.clear();
+				pair.second->prevNodeIds.clear();
+			}
+		}
+
+		state.links.clear();
+		state.links.reserve(connections.size());
+		for (const Connection& connection : connections) {
+			std::shared_ptr<Node> from = state.FindNode(connection.from);
+			std::shared_ptr<Node> to = state.FindNode(connection.to);
+			if (!from || !to) {
+				continue;
+			}
+			if (from->nodeType == NodeType::Speech && to->nodeType == NodeType::Response) {
+				from->responses.push_back(to->id);
+			}
+			else {
+				from->nextNodeId = to->id;
+			}
+			to->prevNodeIds.push_back(from->id);
+			state.links[connection.link_id] = std::make_shared<Link>(connection.link_id, OutputPin(from->id), InputPin(to->id));
+		}
+	}
+}
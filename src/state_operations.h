@@ -0,0 +1,49 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "state_listener.h"
+#include <vector>
+
+/******************************************************************************
+ *          Operations on the dialogue model that don't depend on the UI
+ ******************************************************************************/
+
+namespace ede
+{
+	// Removes a whole selection of nodes and links in one transaction.
+	// Every link touching a removed node goes with it, and the nextNodeId/responses/prevNodeIds
+	// of the surviving neighbours are patched once each, no matter how many of their links were removed.
+	// Unknown ids are ignored and the root node (id 0) is never removed.
+	// listener, if given, is told about every removed link and node and every patched neighbour.
+	void RemoveNodesAndLinks(State& state, const std::vector<int>& node_ids, const std::vector<int>& link_ids,
+		StateListener* listener = nullptr);
+
+	// Copies every lazily loaded text into its node and lets go of the file they pointed into.
+	// The text itself doesn't change, so no listener is told about it.
+	void MaterializeAllText(State& state);
+
+	// a link told by the nodes it joins, how compact save files store links
+	struct Connection
+	{
+		int link_id;
+		int from; // node the link leaves from its output pin
+		int to;   // node the link enters through its input pin
+	};
+
+	// The connections of the state's links, in link id order. A link's start node is looked up among the
+	// prevNodeIds of its end node, output pins of ids over 127 overflow and can't be decoded.
+	// Links whose nodes can't be found are left out.
+	std::vector<Connection> ResolveConnections(const State& state);
+
+	// Rebuilds the state's links and every node's nextNodeId, responses and prevNodeIds from the connections,
+	// in one pass and in their order. A link from a speech to a response is one of the speech's responses,
+	// any other link is its start node's next node. Connections to unknown nodes are dropped.
+	void RebuildConnections(State& state, const std::vector<Connection>& connections);
+}
@@ -0,0 +1,211 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "state_validation.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace ede
+{
+	namespace
+	{
+		// pins are encoded the way the editor does it, overflow included, so they match the links' attributes
+		int InputPin(int node_id) { return static_cast<int>(static_cast<uint32_t>(node_id) << NodePartShift::InputPin); }
+		int OutputPin(int node_id) { return static_cast<int>(static_cast<uint32_t>(node_id) << NodePartShift::EndPin); }
+
+		uint64_t PinsKey(int start_attr, int end_attr)
+		{
+			return (static_cast<uint64_t>(static_cast<uint32_t>(start_attr)) << 32) | static_cast<uint32_t>(end_attr);
+		}
+
+		bool LeadsTo(const Node& node, int target_id)
+		{
+			return node.nextNodeId == target_id || std::find(node.responses.begin(), node.responses.end(), target_id) != node.responses.end();
+		}
+
+		// Output pins of ids 256 apart are the same attribute, the end node's previous nodes tell which one the link starts at.
+		// start_id is what the start pin decodes to
+		bool MatchesConnection(const State& state, const Link& link, int start_id, const Node& end)
+		{
+			auto starts_here = [&](int node_id) {
+				std::shared_ptr<Node> node = state.FindNode(node_id);
+				return node && OutputPin(node_id) == link.start_attr && LeadsTo(*node, end.id);
+			};
+			return starts_here(start_id) || std::any_of(end.prevNodeIds.begin(), end.prevNodeIds.end(), starts_here);
+		}
+	}
+
+	const char* IssueSeverityName(IssueSeverity severity)
+	{
+		return severity == IssueSeverity::Error ? "error" : "warning";
+	}
+
+	void LinkIndex::Add(const Link& link)
+	{
+		counts[PinsKey(link.start_attr, link.end_attr)]++;
+	}
+
+	void LinkIndex::Remove(const Link& link)
+	{
+		auto it = counts.find(PinsKey(link.start_attr, link.end_attr));
+		if (it != counts.end() && --it->second <= 0) {
+			counts.erase(it);
+		}
+	}
+
+	bool LinkIndex::HasLink(int from_node_id, int to_node_id) const
+	{
+		return counts.contains(PinsKey(OutputPin(from_node_id), InputPin(to_node_id)));
+	}
+
+	std::vector<ValidationIssue> ValidateState(const State& state)
+	{
+		LinkIndex link_index;
+		for (const auto& [id, link] : state.links) {
+			if (link) {
+				link_index.Add(*link);
+			}
+		}
+
+		std::vector<ValidationIssue> issues;
+		int max_node_id = -1;
+		for (const auto& [id, node] : state.nodes) {
+			ValidateNode(state, link_index, id, node.get(), issues);
+			if (node) {
+				max_node_id = std::max(max_node_id, id);
+			}
+		}
+
+		int max_link_id = -1;
+		for (const auto& [id, link] : state.links) {
+			ValidateLink(state, id, link.get(), issues);
+			if (link) {
+				max_link_id = std::max(max_link_id, id);
+			}
+		}
+
+		ValidateIdCounters(state, max_node_id, max_link_id, issues);
+		SortIssues(issues);
+		return issues;
+	}
+
+	void ValidateNode(const State& state, const LinkIndex& links, int id, const Node* node, std::vector<ValidationIssue>& issues)
+	{
+		auto report = [&issues, id](IssueSeverity severity, std::string message) {
+			issues.push_back({ severity, id, -1, std::move(message) });
+		};
+
+		if (!node) {
+			report(IssueSeverity::Error, "empty node entry");
+			return;
+		}
+		if (node->id != id) {
+			report(IssueSeverity::Error, "stored under id " + std::to_string(id) + " but its id is " + std::to_string(node->id));
+		}
+
+		// every connection needs its node, its link and to be listed among that node's previous nodes
+		auto check_connection = [&](int target_id, const char* what) {
+			if (!links.HasLink(id, target_id)) {
+				report(IssueSeverity::Error, std::string(what) + " " + std::to_string(target_id) + " has no link");
+			}
+			std::shared_ptr<Node> target = state.FindNode(target_id);
+			if (!target) {
+				report(IssueSeverity::Error, std::string(what) + " " + std::to_string(target_id) + " doesn't exist");
+				return target;
+			}
+			if (std::find(target->prevNodeIds.begin(), target->prevNodeIds.end(), id) == target->prevNodeIds.end()) {
+				report(IssueSeverity::Error, std::string(what) + " " + std::to_string(target_id) + " doesn't list it as a previous node");
+			}
+			return target;
+		};
+
+		if (node->nextNodeId != -1) {
+			std::shared_ptr<Node> next = check_connection(node->nextNodeId, "next node");
+			if (next && node->nodeType == NodeType::Response && next->nodeType == NodeType::Response) {
+				report(IssueSeverity::Error, "response leads to response " + std::to_string(node->nextNodeId));
+			}
+		}
+		for (int response_id : node->responses) {
+			std::shared_ptr<Node> response = check_connection(response_id, "response");
+			if (response && response->nodeType != NodeType::Response) {
+				report(IssueSeverity::Error, "response " + std::to_string(response_id) + " is not a response node");
+			}
+		}
+		for (int prev_id : node->prevNodeIds) {
+			std::shared_ptr<Node> prev = state.FindNode(prev_id);
+			if (!prev) {
+				report(IssueSeverity::Warning, "previous node " + std::to_string(prev_id) + " doesn't exist");
+			}
+			else if (!LeadsTo(*prev, id)) {
+				report(IssueSeverity::Warning, "previous node " + std::to_string(prev_id) + " doesn't lead to it");
+			}
+		}
+
+		if (node->nodeType == NodeType::Speech && node->expectesResponse && node->responses.empty()) {
+			report(IssueSeverity::Warning, "expects a response but has none");
+		}
+		if (node->nodeType == NodeType::Response && node->prevNodeIds.empty()) {
+			report(IssueSeverity::Warning, "response that no speech leads to");
+		}
+		for (const std::string& callback : node->selected_callbacks) {
+			if (!state.callbacks.contains(callback)) {
+				report(IssueSeverity::Warning, "callback \"" + callback + "\" isn't declared");
+			}
+		}
+	}
+
+	void ValidateLink(const State& state, int id, const Link* link, std::vector<ValidationIssue>& issues)
+	{
+		auto report = [&issues, id](IssueSeverity severity, std::string message) {
+			issues.push_back({ severity, -1, id, std::move(message) });
+		};
+
+		if (!link) {
+			report(IssueSeverity::Error, "empty link entry");
+			return;
+		}
+		if (link->id != id) {
+			report(IssueSeverity::Error, "stored under id " + std::to_string(id) + " but its id is " + std::to_string(link->id));
+		}
+
+		// links go from an output pin (id << EndPin) to an input pin (id << InputPin).
+		// decoded unsigned, output pins of ids past 127 use the sign bit
+		const int start_id = static_cast<int>(static_cast<uint32_t>(link->start_attr) >> NodePartShift::EndPin);
+		const int end_id = static_cast<int>(static_cast<uint32_t>(link->end_attr) >> NodePartShift::InputPin);
+		const bool start_valid = link->start_attr == OutputPin(start_id) && state.FindNode(start_id);
+		std::shared_ptr<Node> end = link->end_attr == InputPin(end_id) ? state.FindNode(end_id) : nullptr;
+		if (!start_valid) {
+			report(IssueSeverity::Error, "starts at attribute " + std::to_string(link->start_attr) + ", not an existing node's output");
+		}
+		if (!end) {
+			report(IssueSeverity::Error, "ends at attribute " + std::to_string(link->end_attr) + ", not an existing node's input");
+		}
+		if (start_valid && end && !MatchesConnection(state, *link, start_id, *end)) {
+			report(IssueSeverity::Error, "joins nodes that aren't connected, node " + std::to_string(end_id) + " isn't the next node or a response of the node it starts at");
+		}
+	}
+
+	void ValidateIdCounters(const State& state, int max_node_id, int max_link_id, std::vector<ValidationIssue>& issues)
+	{
+		// ids are handed out by incrementing the counters, a counter behind an id would reuse it
+		if (state.next_node_id < max_node_id) {
+			issues.push_back({ IssueSeverity::Error, -1, -1, "next node id " + std::to_string(state.next_node_id) + " is behind node " + std::to_string(max_node_id) });
+		}
+		if (state.next_link_id < max_link_id) {
+			issues.push_back({ IssueSeverity::Error, -1, -1, "next link id " + std::to_string(state.next_link_id) + " is behind link " + std::to_string(max_link_id) });
+		}
+	}
+
+	void SortIssues(std::vector<ValidationIssue>& issues)
+	{
+		std::stable_sort(issues.begin(), issues.end(), [](const ValidationIssue& a, const ValidationIssue& b) {
+			return a.node_id != b.node_id ? a.node_id < b.node_id : a.link_id < b.link_id;
+		});
+	}
+}
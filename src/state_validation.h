@@ -0,0 +1,70 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/******************************************************************************
+ *              Structural checks on a loaded state
+ *
+ *   Every check is about one node, one link or the id counters, so a
+ *   validator that knows what an edit touched can check only that again
+ *   (see background_validation.h). A node's issues depend on the nodes it
+ *   leads to, the nodes it lists as previous and its outgoing links. A
+ *   link's depend on the nodes at its pins and on its end node's previous
+ *   nodes.
+ ******************************************************************************/
+
+namespace ede
+{
+	enum class IssueSeverity
+	{
+		Warning, // the dialogue works, but probably not as intended
+		Error,   // the state is inconsistent, the game or the editor would misbehave
+	};
+
+	struct ValidationIssue
+	{
+		IssueSeverity severity = IssueSeverity::Error;
+		int           node_id = -1; // -1 when the issue isn't about a node
+		int           link_id = -1; // -1 when the issue isn't about a link
+		std::string   message;
+	};
+
+	// Links counted by the pins they join, so a node can tell whether each of its connections has a link
+	class LinkIndex
+	{
+	public:
+		void Add(const Link& link);
+		void Remove(const Link& link);
+		// pins encoded the way the editor does it, see NodePartShift
+		bool HasLink(int from_node_id, int to_node_id) const;
+
+	private:
+		std::unordered_map<uint64_t, int> counts;
+	};
+
+	// Checks that ids, links and connections agree with each other. Issues come out sorted by node, then link id.
+	std::vector<ValidationIssue> ValidateState(const State& state);
+
+	// What ValidateState reports about one entry of state.nodes, links indexes state.links
+	void ValidateNode(const State& state, const LinkIndex& links, int id, const Node* node, std::vector<ValidationIssue>& issues);
+	// What ValidateState reports about one entry of state.links
+	void ValidateLink(const State& state, int id, const Link* link, std::vector<ValidationIssue>& issues);
+	// ids are handed out by incrementing the counters, reports a counter that's behind the highest id in use
+	void ValidateIdCounters(const State& state, int max_node_id, int max_link_id, std::vector<ValidationIssue>& issues);
+
+	// the order ValidateState reports issues in
+	void SortIssues(std::vector<ValidationIssue>& issues);
+
+	const char* IssueSeverityName(IssueSeverity severity);
+}
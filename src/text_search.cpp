@@ -0,0 +1,234 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#include "text_search.h"
+#include "state_hash.h"
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+namespace ede
+{
+	namespace
+	{
+		char Lower(char c)
+		{
+			return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+		}
+
+		std::string Lowered(std::string_view text)
+		{
+			std::string lowered(text);
+			std::transform(lowered.begin(), lowered.end(), lowered.begin(), Lower);
+			return lowered;
+		}
+
+		// distinct and sorted
+		std::vector<uint32_t> TrigramsOf(std::string_view text)
+		{
+			std::vector<uint32_t> trigrams;
+			if (text.size() < 3) {
+				return trigrams;
+			}
+			trigrams.reserve(text.size() - 2);
+			uint32_t window = (static_cast<uint8_t>(Lower(text[0])) << 8) | static_cast<uint8_t>(Lower(text[1]));
+			for (size_t i = 2; i < text.size(); i++) {
+				window = ((window << 8) | static_cast<uint8_t>(Lower(text[i]))) & 0xFFFFFF;
+				trigrams.push_back(window);
+			}
+			std::sort(trigrams.begin(), trigrams.end());
+			trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+			return trigrams;
+		}
+
+		void InsertSorted(std::vector<int>& ids, int id)
+		{
+			auto it = std::lower_bound(ids.begin(), ids.end(), id);
+			if (it == ids.end() || *it != id) {
+				ids.insert(it, id);
+			}
+		}
+
+		// takes the node out of the trigram's list, and the list out of the index once it's empty
+		void EraseFromPostings(std::unordered_map<uint32_t, std::vector<int>>& postings, uint32_t trigram, int node_id)
+		{
+			auto list = postings.find(trigram);
+			if (list == postings.end()) {
+				return;
+			}
+			auto it = std::lower_bound(list->second.begin(), list->second.end(), node_id);
+			if (it != list->second.end() && *it == node_id) {
+				list->second.erase(it);
+			}
+			if (list->second.empty()) {
+				postings.erase(list);
+			}
+		}
+	}
+
+	size_t FindIgnoringCase(std::string_view text, std::string_view query)
+	{
+		auto it = std::search(text.begin(), text.end(), query.begin(), query.end(),
+			[](char a, char b) { return Lower(a) == Lower(b); });
+		return it == text.end() && !query.empty() ? std::string_view::npos : static_cast<size_t>(it - text.begin());
+	}
+
+	SearchResult TextSearchIndex::Search(const State& state, std::string_view query, size_t max_results) const
+	{
+		SearchResult result;
+		if (query.empty()) {
+			return result;
+		}
+		const std::string lowered_query = Lowered(query);
+
+		auto check = [&](int node_id) {
+			std::shared_ptr<Node> node = state.FindNode(node_id);
+			if (node && FindIgnoringCase(node->TextView(), lowered_query) != std::string_view::npos) {
+				if (result.node_ids.size() < max_results) {
+					result.node_ids.push_back(node_id);
+				}
+				result.match_count++;
+			}
+		};
+
+		const std::vector<uint32_t> query_trigrams = TrigramsOf(lowered_query);
+		if (query_trigrams.empty()) {
+			for (const Node* node : NodesInIdOrder(state)) {
+				check(node->id);
+			}
+			return result;
+		}
+
+		// shortest list first, every other list can only take nodes out
+		std::vector<const std::vector<int>*> lists;
+		lists.reserve(query_trigrams.size());
+		for (uint32_t trigram : query_trigrams) {
+			auto it = postings.find(trigram);
+			if (it == postings.end()) {
+				lists.clear();
+				break;
+			}
+			lists.push_back(&it->second);
+		}
+		std::sort(lists.begin(), lists.end(), [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+
+		std::vector<int> candidates = lists.empty() ? std::vector<int>() : *lists.front();
+		for (size_t i = 1; i < lists.size() && !candidates.empty(); i++) {
+			const std::vector<int>& list = *lists[i];
+			candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+				[&list](int id) { return !std::binary_search(list.begin(), list.end(), id); }), candidates.end());
+		}
+
+		// texts the scan hasn't read yet aren't in the index, every one of them is a candidate
+		if (!scan.Pending().empty()) {
+			std::vector<int> unindexed(scan.Pending().begin(), scan.Pending().end());
+			std::sort(unindexed.begin(), unindexed.end());
+			std::vector<int> merged;
+			merged.reserve(candidates.size() + unindexed.size());
+			std::merge(candidates.begin(), candidates.end(), unindexed.begin(), unindexed.end(), std::back_inserter(merged));
+			candidates = std::move(merged);
+		}
+
+		// having every trigram doesn't mean having them in a row
+		for (int node_id : candidates) {
+			check(node_id);
+		}
+		return result;
+	}
+
+	void TextSearchIndex::Index(const Node& node)
+	{
+		std::vector<uint32_t> trigrams = TrigramsOf(node.TextView());
+		for (uint32_t trigram : trigrams) {
+			InsertSorted(postings[trigram], node.id);
+		}
+		node_trigrams[node.id] = std::move(trigrams);
+	}
+
+	void TextSearchIndex::Unindex(int node_id)
+	{
+		auto it = node_trigrams.find(node_id);
+		if (it == node_trigrams.end()) {
+			return;
+		}
+		for (uint32_t trigram : it->second) {
+			EraseFromPostings(postings, trigram, node_id);
+		}
+		node_trigrams.erase(it);
+	}
+
+	// in id order, every id lands at the end of its lists. Lazy texts are left to the scan
+	void TextSearchIndex::OnStateReset(const State& state)
+	{
+		version++;
+		postings.clear();
+		node_trigrams.clear();
+		node_trigrams.reserve(state.nodes.size());
+		scan.Start(state, TrigramsOf);
+		for (const Node* node : NodesInIdOrder(state)) {
+			if (!node->HasLazyText()) {
+				Index(*node);
+			}
+		}
+	}
+
+	// in id order too, the lists of a freshly loaded state only had ids go at their end
+	void TextSearchIndex::Update(bool wait)
+	{
+		std::vector<std::pair<int, std::vector<uint32_t>>> read;
+		if (!scan.Take(read, wait)) {
+			return;
+		}
+		std::sort(read.begin(), read.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		for (auto& [node_id, trigrams] : read) {
+			for (uint32_t trigram : trigrams) {
+				InsertSorted(postings[trigram], node_id);
+			}
+			node_trigrams[node_id] = std::move(trigrams);
+		}
+	}
+
+	void TextSearchIndex::OnNodeAdded(const Node& node)
+	{
+		version++;
+		scan.Forget(node.id);
+		Unindex(node.id);
+		Index(node);
+	}
+
+	void TextSearchIndex::OnNodeRemoved(int node_id)
+	{
+		version++;
+		scan.Forget(node_id);
+		Unindex(node_id);
+	}
+
+	// only the lists of the trigrams the edit added or took away are touched
+	void TextSearchIndex::OnNodeChanged(const Node& node, NodeChange change)
+	{
+		if (change != NodeChange::Text) {
+			return;
+		}
+		version++;
+		scan.Forget(node.id);
+		std::vector<uint32_t> trigrams = TrigramsOf(node.TextView());
+		std::vector<uint32_t>& old_trigrams = node_trigrams[node.id];
+
+		std::vector<uint32_t> removed, added;
+		std::set_difference(old_trigrams.begin(), old_trigrams.end(), trigrams.begin(), trigrams.end(), std::back_inserter(removed));
+		std::set_difference(trigrams.begin(), trigrams.end(), old_trigrams.begin(), old_trigrams.end(), std::back_inserter(added));
+
+		for (uint32_t trigram : removed) {
+			EraseFromPostings(postings, trigram, node.id);
+		}
+		for (uint32_t trigram : added) {
+			InsertSorted(postings[trigram], node.id);
+		}
+		old_trigrams = std::move(trigrams);
+	}
+}
@@ -0,0 +1,70 @@
+/******************************************************************************
+	Created by Guilherme Figueira, 2025
+
+	My contacts (feel free to reach out):
+	- Github: https://github.com/grfigueira
+	- LinkedIn: https://www.linkedin.com/in/grfigueira/
+ ******************************************************************************/
+
+#pragma once
+#include "Node.h"
+#include "lazy_text_scan.h"
+#include "state_listener.h"
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/******************************************************************************
+ *                   Searching the nodes' texts
+ *
+ *   Every three characters in a row of a node's text (lowercased) make a
+ *   trigram, and the index keeps, per trigram, the sorted ids of the nodes
+ *   having it. A query only reads the lists of its own trigrams, from the
+ *   shortest, and checks the few nodes left in every one of them against
+ *   the query itself. Editing a node's text only re-reads that text and
+ *   updates the lists of the trigrams that came or went. Texts a lazy
+ *   load left in their file are indexed in the background, see
+ *   lazy_text_scan.h, and searched one by one until then.
+ ******************************************************************************/
+
+namespace ede
+{
+	struct SearchResult
+	{
+		std::vector<int> node_ids;       // sorted, at most max_results of them
+		size_t           match_count = 0; // every matching node, even past max_results
+	};
+
+	// where query first shows up in text ignoring ASCII case, std::string_view::npos if it doesn't
+	size_t FindIgnoringCase(std::string_view text, std::string_view query);
+
+	class TextSearchIndex : public StateListener
+	{
+	public:
+		// changes with every edit that can change a search's result, to know when one is stale
+		uint64_t Version() const { return version; }
+
+		// Nodes of state whose text contains query, ignoring ASCII case. Queries shorter than
+		// a trigram can't use the index and go through every node
+		SearchResult Search(const State& state, std::string_view query, size_t max_results) const;
+
+		// Indexes the lazy texts once the background scan has read them all. Meant to be called once per frame from
+		// the UI thread, wait blocks until the scan is done, for when the texts' file is about to be replaced
+		void Update(bool wait = false);
+
+		void OnStateReset(const State& state) override;
+		void OnNodeAdded(const Node& node) override;
+		void OnNodeRemoved(int node_id) override;
+		void OnNodeChanged(const Node& node, NodeChange change) override;
+
+	private:
+		void Index(const Node& node);
+		void Unindex(int node_id);
+
+		std::unordered_map<uint32_t, std::vector<int>> postings;      // trigram -> sorted node ids
+		std::unordered_map<int, std::vector<uint32_t>> node_trigrams; // node id -> its distinct trigrams, sorted
+		uint64_t                                       version = 0;
+		LazyTextScan<std::vector<uint32_t>>            scan;          // trigrams of the texts left out of the reset
+	};
+}
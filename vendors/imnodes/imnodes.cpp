@@ -302,6 +302,13 @@ inline ImRect ScreenSpaceToMiniMapSpace(const ImNodesEditorContext& editor, cons
         ScreenSpaceToMiniMapSpace(editor, r.Min), ScreenSpaceToMiniMapSpace(editor, r.Max));
 }
 
+// The grid space origin the node is currently displayed at. While a selection is being dragged,
+// its nodes keep their origin from when the drag started and share the editor's drag offset.
+inline ImVec2 GetNodeOrigin(const ImNodesEditorContext& editor, const ImNodeData& node)
+{
+    return node.InDraggedSelection ? node.Origin + editor.SelectionDragOffset : node.Origin;
+}
+
 // [SECTION] draw list helper
 
 void ImDrawListGrowChannels(ImDrawList* draw_list, const int num_channels)
@@ -391,6 +398,7 @@ void DrawListSet(ImDrawList* window_draw_list)
     GImNodes->CanvasDrawList = window_draw_list;
     GImNodes->NodeIdxToSubmissionIdx.Clear();
     GImNodes->NodeIdxSubmissionOrder.clear();
+    GImNodes->SharedNodeChannelCount = 0;
 }
 
 // The draw list channels are structured as follows. First we have our base channel, the canvas grid
@@ -411,9 +419,34 @@ void DrawListSet(ImDrawList* window_draw_list)
 //            |   submission idx    |
 //            |                     |
 //            -----------------------
+//
+// With ImNodesStyleFlags_SharedNodeChannels, two shared channels (background and foreground) are
+// inserted right after the canvas grid. Nodes which didn't overlap any other node last frame are
+// rendered into them and never get a submission idx, since their relative draw order doesn't
+// matter. Only the remaining nodes append a channel pair and take part in the depth sort.
+//
+// +----------+----------+----------+----------+----------+----------+
+// |          |shared    |shared    |node      |node      |          |
+// |canvas    |node      |node      |background|foreground|...       |
+// |grid      |background|foreground|          |          |          |
+// +----------+----------+----------+----------+----------+----------+
+
+void DrawListEnableSharedNodeChannels()
+{
+    // NOTE: must be called before the first BeginNode() of the frame.
+    IM_ASSERT(GImNodes->NodeIdxSubmissionOrder.empty());
+    ImDrawListGrowChannels(GImNodes->CanvasDrawList, 2);
+    GImNodes->SharedNodeChannelCount = 2;
+}
 
 void DrawListAddNode(const int node_idx)
 {
+    const ImNodeData& node = EditorContextGet().Nodes.Pool[node_idx];
+    if (GImNodes->SharedNodeChannelCount > 0 && node.UseSharedChannels)
+    {
+        return;
+    }
+
     GImNodes->NodeIdxToSubmissionIdx.SetInt(
         static_cast<ImGuiID>(node_idx), GImNodes->NodeIdxSubmissionOrder.Size);
     GImNodes->NodeIdxSubmissionOrder.push_back(node_idx);
@@ -429,8 +462,9 @@ void DrawListAppendClickInteractionChannel()
 
 int DrawListSubmissionIdxToBackgroundChannelIdx(const int submission_idx)
 {
-    // NOTE: the first channel is the canvas background, i.e. the grid
-    return 1 + 2 * submission_idx;
+    // NOTE: the first channel is the canvas background, i.e. the grid, followed by the shared node
+    // channels if they are enabled
+    return 1 + GImNodes->SharedNodeChannelCount + 2 * submission_idx;
 }
 
 int DrawListSubmissionIdxToForegroundChannelIdx(const int submission_idx)
@@ -438,33 +472,42 @@ int DrawListSubmissionIdxToForegroundChannelIdx(const int submission_idx)
     return DrawListSubmissionIdxToBackgroundChannelIdx(submission_idx) + 1;
 }
 
+int DrawListNodeBackgroundChannelIdx(const int node_idx)
+{
+    const int submission_idx =
+        GImNodes->NodeIdxToSubmissionIdx.GetInt(static_cast<ImGuiID>(node_idx), -1);
+    if (submission_idx == -1 && GImNodes->SharedNodeChannelCount > 0)
+    {
+        // The node was rendered into the shared channels
+        return 1;
+    }
+    // There is a discrepancy in the submitted node count and the rendered node count! Did you call
+    // one of the following functions
+    // * EditorContextMoveToNode
+    // * SetNodeScreenSpacePos
+    // * SetNodeGridSpacePos
+    // * SetNodeDraggable
+    // after the BeginNode/EndNode function calls?
+    IM_ASSERT(submission_idx != -1);
+    return DrawListSubmissionIdxToBackgroundChannelIdx(submission_idx);
+}
+
 void DrawListActivateClickInteractionChannel()
 {
     GImNodes->CanvasDrawList->_Splitter.SetCurrentChannel(
         GImNodes->CanvasDrawList, GImNodes->CanvasDrawList->_Splitter._Count - 1);
 }
 
-void DrawListActivateCurrentNodeForeground()
+void DrawListActivateNodeForeground(const int node_idx)
 {
-    const int foreground_channel_idx =
-        DrawListSubmissionIdxToForegroundChannelIdx(GImNodes->NodeIdxSubmissionOrder.Size - 1);
+    const int foreground_channel_idx = DrawListNodeBackgroundChannelIdx(node_idx) + 1;
     GImNodes->CanvasDrawList->_Splitter.SetCurrentChannel(
         GImNodes->CanvasDrawList, foreground_channel_idx);
 }
 
 void DrawListActivateNodeBackground(const int node_idx)
 {
-    const int submission_idx =
-        GImNodes->NodeIdxToSubmissionIdx.GetInt(static_cast<ImGuiID>(node_idx), -1);
-    // There is a discrepancy in the submitted node count and the rendered node count! Did you call
-    // one of the following functions
-    // * EditorContextMoveToNode
-    // * SetNodeScreenSpacePos
-    // * SetNodeGridSpacePos
-    // * SetNodeDraggable
-    // after the BeginNode/EndNode function calls?
-    IM_ASSERT(submission_idx != -1);
-    const int background_channel_idx = DrawListSubmissionIdxToBackgroundChannelIdx(submission_idx);
+    const int background_channel_idx = DrawListNodeBackgroundChannelIdx(node_idx);
     GImNodes->CanvasDrawList->_Splitter.SetCurrentChannel(
         GImNodes->CanvasDrawList, background_channel_idx);
 }
@@ -540,6 +583,139 @@ void DrawListSortChannelsByDepth(const ImVector<int>& node_idx_depth_order)
     }
 }
 
+void DrawListSortDedicatedChannelsByDepth(const ImVector<int>& node_idx_depth_order)
+{
+    // Only the nodes with their own channel pair take part in the sort. Nodes in the shared
+    // channels don't overlap anything, so their position in the depth stack doesn't matter.
+    ImVector<int>& dedicated_depth_order = GImNodes->DedicatedNodeDepthOrder;
+    dedicated_depth_order.resize(0);
+    for (int i = 0; i < node_idx_depth_order.Size; ++i)
+    {
+        const int node_idx = node_idx_depth_order[i];
+        if (GImNodes->NodeIdxToSubmissionIdx.GetInt(static_cast<ImGuiID>(node_idx), -1) != -1)
+        {
+            dedicated_depth_order.push_back(node_idx);
+        }
+    }
+    DrawListSortChannelsByDepth(dedicated_depth_order);
+}
+
+static int IMGUI_CDECL CompareSharedChannelCellEntries(const void* lhs, const void* rhs)
+{
+    const ImNodesCellEntry& a = *static_cast<const ImNodesCellEntry*>(lhs);
+    const ImNodesCellEntry& b = *static_cast<const ImNodesCellEntry*>(rhs);
+    if (a.CellY != b.CellY)
+    {
+        return a.CellY < b.CellY ? -1 : 1;
+    }
+    if (a.CellX != b.CellX)
+    {
+        return a.CellX < b.CellX ? -1 : 1;
+    }
+    return a.NodeIdx - b.NodeIdx;
+}
+
+// Decides which nodes can be rendered into the shared channels next frame. A node qualifies if its
+// rectangle overlaps no other node and it is not part of a selection being dragged. Overlaps are
+// found by bucketing node rectangles into a uniform grid and only testing nodes sharing a cell,
+// which keeps this O(N log N) instead of testing every pair.
+void UpdateSharedChannelAssignment(ImNodesEditorContext& editor)
+{
+    ImObjectPool<ImNodeData>& nodes = editor.Nodes;
+
+    float total_extent = 0.f;
+    int   num_nodes = 0;
+    for (int node_idx = 0; node_idx < nodes.Pool.size(); ++node_idx)
+    {
+        if (nodes.InUse[node_idx])
+        {
+            const ImNodeData& node = nodes.Pool[node_idx];
+            total_extent += ImMax(node.Rect.GetWidth(), node.Rect.GetHeight());
+            ++num_nodes;
+        }
+    }
+
+    if (num_nodes == 0)
+    {
+        return;
+    }
+
+    // Cells roughly the size of an average node keep both the number of cells per node and the
+    // number of nodes per cell small.
+    const float cell_size = ImMax(total_extent / static_cast<float>(num_nodes), 16.f);
+    const float inv_cell_size = 1.f / cell_size;
+
+    ImVector<ImNodesCellEntry>& entries = GImNodes->SharedChannelCellEntries;
+    entries.resize(0);
+    for (int node_idx = 0; node_idx < nodes.Pool.size(); ++node_idx)
+    {
+        if (!nodes.InUse[node_idx])
+        {
+            continue;
+        }
+
+        ImNodeData& node = nodes.Pool[node_idx];
+        node.UseSharedChannels = true;
+
+        const int min_x = static_cast<int>(floorf(node.Rect.Min.x * inv_cell_size));
+        const int min_y = static_cast<int>(floorf(node.Rect.Min.y * inv_cell_size));
+        const int max_x = static_cast<int>(floorf(node.Rect.Max.x * inv_cell_size));
+        const int max_y = static_cast<int>(floorf(node.Rect.Max.y * inv_cell_size));
+        for (int y = min_y; y <= max_y; ++y)
+        {
+            for (int x = min_x; x <= max_x; ++x)
+            {
+                ImNodesCellEntry entry;
+                entry.CellX = x;
+                entry.CellY = y;
+                entry.NodeIdx = node_idx;
+                entries.push_back(entry);
+            }
+        }
+    }
+
+    ImQsort(
+        entries.Data,
+        static_cast<size_t>(entries.Size),
+        sizeof(ImNodesCellEntry),
+        CompareSharedChannelCellEntries);
+
+    for (int run_start = 0; run_start < entries.Size;)
+    {
+        int run_end = run_start + 1;
+        while (run_end < entries.Size && entries[run_end].CellX == entries[run_start].CellX &&
+               entries[run_end].CellY == entries[run_start].CellY)
+        {
+            ++run_end;
+        }
+
+        for (int i = run_start; i < run_end; ++i)
+        {
+            ImNodeData& lhs = nodes.Pool[entries[i].NodeIdx];
+            for (int j = i + 1; j < run_end; ++j)
+            {
+                ImNodeData& rhs = nodes.Pool[entries[j].NodeIdx];
+                if (lhs.Rect.Overlaps(rhs.Rect))
+                {
+                    lhs.UseSharedChannels = false;
+                    rhs.UseSharedChannels = false;
+                }
+            }
+        }
+
+        run_start = run_end;
+    }
+
+    // Nodes being dragged move over other nodes, so they need to keep their depth order.
+    if (editor.ClickInteraction.Type == ImNodesClickInteractionType_Node)
+    {
+        for (int i = 0; i < editor.SelectedNodeIndices.Size; ++i)
+        {
+            nodes.Pool[editor.SelectedNodeIndices[i]].UseSharedChannels = false;
+        }
+    }
+}
+
 // [SECTION] ui state logic
 
 ImVec2 GetScreenSpacePinCoordinates(
@@ -565,6 +741,30 @@ bool MouseInCanvas()
     return GImNodes->IsHovered;
 }
 
+// Writes the drag offset into the origin of every node moved by the current selection drag. This
+// is the only per-node work of a drag, and it happens once when the mouse is released.
+void CommitSelectionDrag(ImNodesEditorContext& editor)
+{
+    for (int i = 0; i < editor.DraggedNodeIndices.Size; ++i)
+    {
+        ImNodeData& node = editor.Nodes.Pool[editor.DraggedNodeIndices[i]];
+        if (node.InDraggedSelection)
+        {
+            node.Origin += editor.SelectionDragOffset;
+            node.InDraggedSelection = false;
+        }
+    }
+
+    if (editor.DraggedNodeIndices.Size > 0 &&
+        (editor.SelectionDragOffset.x != 0.f || editor.SelectionDragOffset.y != 0.f))
+    {
+        GImNodes->ImNodesUIState |= ImNodesUIState_SelectionDragCommitted;
+    }
+
+    editor.DraggedNodeIndices.resize(0);
+    editor.SelectionDragOffset = ImVec2(0.f, 0.f);
+}
+
 void BeginNodeSelection(ImNodesEditorContext& editor, const int node_idx)
 {
     // Don't start selecting a node if we are e.g. already creating and dragging
@@ -610,18 +810,29 @@ void BeginNodeSelection(ImNodesEditorContext& editor, const int node_idx)
         editor.ClickInteraction.Type = ImNodesClickInteractionType_None;
     }
 
-    // To support snapping of multiple nodes, we need to store the offset of
-    // each node in the selection to the origin of the dragged node.
+    // The selection is dragged as a group: only the origin of the dragged node is tracked, and
+    // every other draggable node in the selection follows it through the shared drag offset.
+    CommitSelectionDrag(editor);
+
+    if (editor.ClickInteraction.Type != ImNodesClickInteractionType_Node)
+    {
+        return;
+    }
+
     const ImVec2 ref_origin = editor.Nodes.Pool[node_idx].Origin;
     editor.PrimaryNodeOffset =
         ref_origin + GImNodes->CanvasOriginScreenSpace + editor.Panning - GImNodes->MousePos;
+    editor.SelectionDragStartOrigin = ref_origin;
 
-    editor.SelectedNodeOffsets.clear();
     for (int idx = 0; idx < editor.SelectedNodeIndices.Size; idx++)
     {
-        const int    node = editor.SelectedNodeIndices[idx];
-        const ImVec2 node_origin = editor.Nodes.Pool[node].Origin - ref_origin;
-        editor.SelectedNodeOffsets.push_back(node_origin);
+        const int   node_idx_in_selection = editor.SelectedNodeIndices[idx];
+        ImNodeData& node = editor.Nodes.Pool[node_idx_in_selection];
+        if (node.Draggable)
+        {
+            node.InDraggedSelection = true;
+            editor.DraggedNodeIndices.push_back(node_idx_in_selection);
+        }
     }
 }
 
@@ -825,18 +1036,16 @@ void TranslateSelectedNodes(ImNodesEditorContext& editor)
                                          ? ImGui::GetIO().MouseDragMaxDistanceSqr[0] > 5.0
                                          : true;
 
-        const ImVec2 origin = SnapOriginToGrid(
-            GImNodes->MousePos - GImNodes->CanvasOriginScreenSpace - editor.Panning +
-            editor.PrimaryNodeOffset);
-        for (int i = 0; i < editor.SelectedNodeIndices.size(); ++i)
+        if (shouldTranslate)
         {
-            const ImVec2 node_rel = editor.SelectedNodeOffsets[i];
-            const int    node_idx = editor.SelectedNodeIndices[i];
-            ImNodeData&  node = editor.Nodes.Pool[node_idx];
-            if (node.Draggable && shouldTranslate)
-            {
-                node.Origin = origin + node_rel + editor.AutoPanningDelta;
-            }
+            // Only the dragged node's origin is snapped; the rest of the selection keeps its
+            // relative placement by sharing the same offset, so the cost doesn't depend on the
+            // selection size.
+            const ImVec2 origin = SnapOriginToGrid(
+                GImNodes->MousePos - GImNodes->CanvasOriginScreenSpace - editor.Panning +
+                editor.PrimaryNodeOffset);
+            editor.SelectionDragOffset =
+                origin + editor.AutoPanningDelta - editor.SelectionDragStartOrigin;
         }
     }
 }
@@ -980,6 +1189,7 @@ void ClickInteractionUpdate(ImNodesEditorContext& editor)
 
         if (GImNodes->LeftMouseReleased)
         {
+            CommitSelectionDrag(editor);
             editor.ClickInteraction.Type = ImNodesClickInteractionType_None;
         }
     }
@@ -1295,16 +1505,16 @@ ImOptionalIndex ResolveHoveredLink(
 
 inline ImRect GetItemRect() { return ImRect(ImGui::GetItemRectMin(), ImGui::GetItemRectMax()); }
 
-inline ImVec2 GetNodeTitleBarOrigin(const ImNodeData& node)
+inline ImVec2 GetNodeTitleBarOrigin(const ImNodesEditorContext& editor, const ImNodeData& node)
 {
-    return node.Origin + node.LayoutStyle.Padding;
+    return GetNodeOrigin(editor, node) + node.LayoutStyle.Padding;
 }
 
-inline ImVec2 GetNodeContentOrigin(const ImNodeData& node)
+inline ImVec2 GetNodeContentOrigin(const ImNodesEditorContext& editor, const ImNodeData& node)
 {
     const ImVec2 title_bar_height =
         ImVec2(0.f, node.TitleBarContentRect.GetHeight() + 2.0f * node.LayoutStyle.Padding.y);
-    return node.Origin + title_bar_height + node.LayoutStyle.Padding;
+    return GetNodeOrigin(editor, node) + title_bar_height + node.LayoutStyle.Padding;
 }
 
 inline ImRect GetNodeTitleRect(const ImNodeData& node)
@@ -1528,7 +1738,7 @@ void DrawPin(ImNodesEditorContext& editor, const int pin_idx)
 void DrawNode(ImNodesEditorContext& editor, const int node_idx)
 {
     const ImNodeData& node = editor.Nodes.Pool[node_idx];
-    ImGui::SetCursorPos(node.Origin + editor.Panning);
+    ImGui::SetCursorPos(GetNodeOrigin(editor, node) + editor.Panning);
 
     const bool node_hovered =
         GImNodes->HoveredNodeIdx == node_idx &&
@@ -1615,8 +1825,14 @@ void DrawLink(ImNodesEditorContext& editor, const int link_idx)
     const ImPinData&  start_pin = editor.Pins.Pool[link.StartPinIdx];
     const ImPinData&  end_pin = editor.Pins.Pool[link.EndPinIdx];
 
+    // The canvas is rendered unscaled and only scaled by ZoomScale when its draw data is copied
+    // over, so scaling the segment density by the zoom tessellates the link according to the
+    // number of pixels it actually spans on the screen.
     const CubicBezier cubic_bezier = GetCubicBezier(
-        start_pin.Pos, end_pin.Pos, start_pin.Type, GImNodes->Style.LinkLineSegmentsPerLength);
+        start_pin.Pos,
+        end_pin.Pos,
+        start_pin.Type,
+        GImNodes->Style.LinkLineSegmentsPerLength * editor.ZoomScale);
 
     const bool link_hovered =
         GImNodes->HoveredLinkIdx == link_idx &&
@@ -1637,6 +1853,12 @@ void DrawLink(ImNodesEditorContext& editor, const int link_idx)
         return;
     }
 
+    // Skip links which lie entirely outside of the visible canvas
+    if (!GImNodes->CanvasRectScreenSpace.Overlaps(GetContainingRectForCubicBezier(cubic_bezier)))
+    {
+        return;
+    }
+
     ImU32 link_color = link.ColorStyle.Base;
     if (editor.SelectedLinkIndices.contains(link_idx))
     {
@@ -1870,7 +2092,7 @@ static void MiniMapDrawLink(ImNodesEditorContext& editor, const int link_idx)
         ScreenSpaceToMiniMapSpace(editor, start_pin.Pos),
         ScreenSpaceToMiniMapSpace(editor, end_pin.Pos),
         start_pin.Type,
-        GImNodes->Style.LinkLineSegmentsPerLength / editor.MiniMapScaling);
+        GImNodes->Style.LinkLineSegmentsPerLength * editor.ZoomScale);
 
     // It's possible for a link to be deleted in begin_link_interaction. A user
     // may detach a link, resulting in the link wire snapping to the mouse
@@ -1976,7 +2198,7 @@ static void MiniMapUpdate()
 
     bool center_on_click = mini_map_is_hovered && ImGui::IsMouseDown(ImGuiMouseButton_Left) &&
                            editor.ClickInteraction.Type == ImNodesClickInteractionType_None &&
-                           !GImNodes->NodeIdxSubmissionOrder.empty();
+                           !editor.NodeDepthOrder.empty();
     if (center_on_click)
     {
         ImVec2 target = MiniMapSpaceToGridSpace(editor, ImGui::GetMousePos());
@@ -2102,9 +2324,10 @@ void EditorContextMoveToNode(const int node_id)
 {
     ImNodesEditorContext& editor = EditorContextGet();
     ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
+    const ImVec2          origin = GetNodeOrigin(editor, node);
 
-    editor.Panning.x = -node.Origin.x;
-    editor.Panning.y = -node.Origin.y;
+    editor.Panning.x = -origin.x;
+    editor.Panning.y = -origin.y;
 }
 
 ImGuiContext* GetNodeEditorImGuiContext() { return GImNodes->NodeEditorImgCtx; }
@@ -2345,6 +2568,11 @@ void BeginNodeEditor()
         // rendered into the parent window draw list.
         DrawListSet(ImGui::GetWindowDrawList());
 
+        if (GImNodes->Style.Flags & ImNodesStyleFlags_SharedNodeChannels)
+        {
+            DrawListEnableSharedNodeChannels();
+        }
+
         {
             const ImVec2 window_size = ImGui::GetWindowSize();
             GImNodes->CanvasRectScreenSpace = ImRect(
@@ -2511,7 +2739,15 @@ void EndNodeEditor()
     ObjectPoolUpdate(editor.Nodes);
     ObjectPoolUpdate(editor.Pins);
 
-    DrawListSortChannelsByDepth(editor.NodeDepthOrder);
+    if (GImNodes->SharedNodeChannelCount > 0)
+    {
+        DrawListSortDedicatedChannelsByDepth(editor.NodeDepthOrder);
+        UpdateSharedChannelAssignment(editor);
+    }
+    else
+    {
+        DrawListSortChannelsByDepth(editor.NodeDepthOrder);
+    }
 
     // After the links have been rendered, the link pool can be updated as well.
     ObjectPoolUpdate(editor.Links);
@@ -2599,10 +2835,10 @@ void BeginNode(const int node_id)
     // ImGui::SetCursorPos sets the cursor position, local to the current widget
     // (in this case, the child object started in BeginNodeEditor). Use
     // ImGui::SetCursorScreenPos to set the screen space coordinates directly.
-    ImGui::SetCursorPos(GridSpaceToEditorSpace(editor, GetNodeTitleBarOrigin(node)));
+    ImGui::SetCursorPos(GridSpaceToEditorSpace(editor, GetNodeTitleBarOrigin(editor, node)));
 
     DrawListAddNode(node_idx);
-    DrawListActivateCurrentNodeForeground();
+    DrawListActivateNodeForeground(node_idx);
 
     ImGui::PushID(node.Id);
     ImGui::BeginGroup();
@@ -2623,8 +2859,9 @@ void EndNode()
     node.Rect = GetItemRect();
     node.Rect.Expand(node.LayoutStyle.Padding);
 
-    editor.GridContentBounds.Add(node.Origin);
-    editor.GridContentBounds.Add(node.Origin + node.Rect.GetSize());
+    const ImVec2 origin = GetNodeOrigin(editor, node);
+    editor.GridContentBounds.Add(origin);
+    editor.GridContentBounds.Add(origin + node.Rect.GetSize());
 
     if (node.Rect.Contains(GImNodes->MousePos))
     {
@@ -2658,7 +2895,7 @@ void EndNodeTitleBar()
 
     ImGui::ItemAdd(GetNodeTitleRect(node), ImGui::GetID("title_bar"));
 
-    ImGui::SetCursorPos(GridSpaceToEditorSpace(editor, GetNodeContentOrigin(node)));
+    ImGui::SetCursorPos(GridSpaceToEditorSpace(editor, GetNodeContentOrigin(editor, node)));
 }
 
 void BeginInputAttribute(const int id, const ImNodesPinShape shape)
@@ -2859,6 +3096,7 @@ void SetNodeScreenSpacePos(const int node_id, const ImVec2& screen_space_pos)
     ImNodesEditorContext& editor = EditorContextGet();
     ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
     node.Origin = ScreenSpaceToGridSpace(editor, screen_space_pos);
+    node.InDraggedSelection = false;
 }
 
 void SetNodeEditorSpacePos(const int node_id, const ImVec2& editor_space_pos)
@@ -2866,6 +3104,7 @@ void SetNodeEditorSpacePos(const int node_id, const ImVec2& editor_space_pos)
     ImNodesEditorContext& editor = EditorContextGet();
     ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
     node.Origin = EditorSpaceToGridSpace(editor, editor_space_pos);
+    node.InDraggedSelection = false;
 }
 
 void SetNodeGridSpacePos(const int node_id, const ImVec2& grid_pos)
@@ -2873,6 +3112,7 @@ void SetNodeGridSpacePos(const int node_id, const ImVec2& grid_pos)
     ImNodesEditorContext& editor = EditorContextGet();
     ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
     node.Origin = grid_pos;
+    node.InDraggedSelection = false;
 }
 
 void SetNodeDraggable(const int node_id, const bool draggable)
@@ -2888,7 +3128,7 @@ ImVec2 GetNodeScreenSpacePos(const int node_id)
     const int             node_idx = ObjectPoolFind(editor.Nodes, node_id);
     IM_ASSERT(node_idx != -1);
     ImNodeData& node = editor.Nodes.Pool[node_idx];
-    return GridSpaceToScreenSpace(editor, node.Origin);
+    return GridSpaceToScreenSpace(editor, GetNodeOrigin(editor, node));
 }
 
 ImVec2 GetNodeEditorSpacePos(const int node_id)
@@ -2897,7 +3137,7 @@ ImVec2 GetNodeEditorSpacePos(const int node_id)
     const int             node_idx = ObjectPoolFind(editor.Nodes, node_id);
     IM_ASSERT(node_idx != -1);
     ImNodeData& node = editor.Nodes.Pool[node_idx];
-    return GridSpaceToEditorSpace(editor, node.Origin);
+    return GridSpaceToEditorSpace(editor, GetNodeOrigin(editor, node));
 }
 
 ImVec2 GetNodeGridSpacePos(const int node_id)
@@ -2906,14 +3146,15 @@ ImVec2 GetNodeGridSpacePos(const int node_id)
     const int             node_idx = ObjectPoolFind(editor.Nodes, node_id);
     IM_ASSERT(node_idx != -1);
     ImNodeData& node = editor.Nodes.Pool[node_idx];
-    return node.Origin;
+    return GetNodeOrigin(editor, node);
 }
 
 void SnapNodeToGrid(int node_id)
 {
     ImNodesEditorContext& editor = EditorContextGet();
     ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
-    node.Origin = SnapOriginToGrid(node.Origin);
+    node.Origin = SnapOriginToGrid(GetNodeOrigin(editor, node));
+    node.InDraggedSelection = false;
 }
 
 float EditorContextGetZoom() { return EditorContextGet().ZoomScale; }
@@ -3221,6 +3462,12 @@ bool IsLinkCreated(
     return is_created;
 }
 
+bool IsSelectionDragCommitted()
+{
+    IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_None);
+    return (GImNodes->ImNodesUIState & ImNodesUIState_SelectionDragCommitted) != 0;
+}
+
 bool IsLinkDestroyed(int* const link_id)
 {
     IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_None);
@@ -3287,7 +3534,8 @@ const char* SaveEditorStateToIniString(
         {
             const ImNodeData& node = editor.Nodes.Pool[i];
             GImNodes->TextBuffer.appendf("\n[node.%d]\n", node.Id);
-            GImNodes->TextBuffer.appendf("origin=%i,%i\n", (int)node.Origin.x, (int)node.Origin.y);
+            const ImVec2      origin = GetNodeOrigin(editor, node);
+            GImNodes->TextBuffer.appendf("origin=%i,%i\n", (int)origin.x, (int)origin.y);
         }
     }
 
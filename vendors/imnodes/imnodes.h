@@ -78,7 +78,11 @@ enum ImNodesStyleFlags_
     ImNodesStyleFlags_NodeOutline = 1 << 0,
     ImNodesStyleFlags_GridLines = 1 << 2,
     ImNodesStyleFlags_GridLinesPrimary = 1 << 3,
-    ImNodesStyleFlags_GridSnapping = 1 << 4
+    ImNodesStyleFlags_GridSnapping = 1 << 4,
+    // Render nodes which don't overlap any other node into two draw channels shared by all of them,
+    // instead of giving every node its own pair of channels. Only overlapping nodes and nodes being
+    // dragged still get dedicated channels for depth sorting. Recommended for large graphs.
+    ImNodesStyleFlags_SharedNodeChannels = 1 << 5
 };
 
 enum ImNodesPinShape_
@@ -427,6 +431,11 @@ bool IsLinkCreated(
 // output argument link_id.
 bool IsLinkDestroyed(int* link_id);
 
+// Did the user release a dragged selection of nodes this frame? While dragging, the selection is
+// moved as a group and the node positions are only updated once the drag is committed, so this is
+// the point at which GetNode*Pos of the moved nodes change.
+bool IsSelectionDragCommitted();
+
 // Use the following functions to write the editor context's state to a string, or directly to a
 // file. The editor context is serialized in the INI file format.
 
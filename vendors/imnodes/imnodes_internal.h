@@ -47,7 +47,8 @@ enum ImNodesUIState_
     ImNodesUIState_None = 0,
     ImNodesUIState_LinkStarted = 1 << 0,
     ImNodesUIState_LinkDropped = 1 << 1,
-    ImNodesUIState_LinkCreated = 1 << 2
+    ImNodesUIState_LinkCreated = 1 << 2,
+    ImNodesUIState_SelectionDragCommitted = 1 << 3
 };
 
 enum ImNodesClickInteractionType_
@@ -150,11 +151,17 @@ struct ImNodeData
 
     ImVector<int> PinIndices;
     bool          Draggable;
+    // Set at the end of each frame when ImNodesStyleFlags_SharedNodeChannels is enabled: the node
+    // overlaps no other node, so next frame it is rendered into the shared draw channels.
+    bool          UseSharedChannels;
+    // The node is part of the selection currently being dragged, see
+    // ImNodesEditorContext::SelectionDragOffset.
+    bool          InDraggedSelection;
 
     ImNodeData(const int node_id)
         : Id(node_id), Origin(0.0f, 0.0f), TitleBarContentRect(),
           Rect(ImVec2(0.0f, 0.0f), ImVec2(0.0f, 0.0f)), ColorStyle(), LayoutStyle(), PinIndices(),
-          Draggable(true)
+          Draggable(true), UseSharedChannels(false), InDraggedSelection(false)
     {
     }
 
@@ -197,6 +204,13 @@ struct ImLinkData
     ImLinkData(const int link_id) : Id(link_id), StartPinIdx(), EndPinIdx(), ColorStyle() {}
 };
 
+// Bucket entry used to find overlapping nodes when assigning shared draw channels
+struct ImNodesCellEntry
+{
+    int CellX, CellY;
+    int NodeIdx;
+};
+
 struct ImClickInteractionState
 {
     ImNodesClickInteractionType Type;
@@ -262,10 +276,14 @@ struct ImNodesEditorContext
     ImVector<int> SelectedNodeIndices;
     ImVector<int> SelectedLinkIndices;
 
-    // Relative origins of selected nodes for snapping of dragged nodes
-    ImVector<ImVec2> SelectedNodeOffsets;
+    // Nodes moved by the current selection drag. They keep their origin from when the drag
+    // started and are displayed translated by SelectionDragOffset until the drag is committed.
+    ImVector<int> DraggedNodeIndices;
+    ImVec2        SelectionDragOffset;
+    // Origin of the dragged node when the drag started.
+    ImVec2        SelectionDragStartOrigin;
     // Offset of the primary node origin relative to the mouse cursor.
-    ImVec2           PrimaryNodeOffset;
+    ImVec2        PrimaryNodeOffset;
 
     ImClickInteractionState ClickInteraction;
 
@@ -285,7 +303,8 @@ struct ImNodesEditorContext
 
     ImNodesEditorContext()
         : Nodes(), Pins(), Links(), ZoomScale(1.f), Panning(0.f, 0.f), SelectedNodeIndices(),
-           SelectedLinkIndices(), SelectedNodeOffsets(), PrimaryNodeOffset(0.f, 0.f), ClickInteraction(),
+           SelectedLinkIndices(), DraggedNodeIndices(), SelectionDragOffset(0.f, 0.f),
+          SelectionDragStartOrigin(0.f, 0.f), PrimaryNodeOffset(0.f, 0.f), ClickInteraction(),
           MiniMapEnabled(false), MiniMapSizeFraction(0.0f), MiniMapNodeHoveringCallback(NULL),
           MiniMapNodeHoveringCallbackUserData(NULL), MiniMapScaling(0.0f)
     {
@@ -303,6 +322,10 @@ struct ImNodesContext
     ImDrawList*   CanvasDrawList;
     ImGuiStorage  NodeIdxToSubmissionIdx;
     ImVector<int> NodeIdxSubmissionOrder;
+    // Number of draw channels shared by non-overlapping nodes (0 or 2) during the current frame
+    int                        SharedNodeChannelCount;
+    ImVector<int>              DedicatedNodeDepthOrder;
+    ImVector<ImNodesCellEntry> SharedChannelCellEntries;
     ImVector<int> NodeIndicesOverlappingWithMouse;
     ImVector<int> OccludedPinIndices;
 
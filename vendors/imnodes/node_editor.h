@@ -8,6 +8,13 @@
 
 #pragma once
 #include "Node.h"
+#include "state_listener.h"
+#include "project.h"
+#include "path_analysis.h"
+#include "background_validation.h"
+#include "text_search.h"
+#include "graph_stats.h"
+#include <memory>
 #include <set>
 
 
@@ -15,18 +22,78 @@ namespace ede
 {
 	void NodeEditorInitialize();
 	void NodeEditorShow();
-	void NodeEditorShutdown();
+	bool NodeEditorShutdown(); // false if an edited conversation couldn't be saved, the editor should stay open
 	void InitializeConversation();
 	std::vector<std::shared_ptr<Node>> GetNodesVec();
+	const std::unordered_map<int, std::shared_ptr<Node>>& GetNodesMap();
 	std::set<std::string>& GetCallbacksMutable();
 	const State& GetCurrentState();
 	int GetNumNodesOfType(NodeType type);
+	// sorted ids of the nodes the root doesn't lead to, see reachability.h
+	const std::vector<int>& GetUnreachableNodes();
+	// loops and playthrough count of the shown conversation, see path_analysis.h
+	const PathAnalysis& GetPathAnalysis();
+	// node, connection, word and callback counts kept up to date with every edit, see graph_stats.h
+	const GraphStats& GetGraphStats();
+	// the statistics and the path analysis as JSON, what File > Export Statistics writes
+	std::string GetGraphStatsJson();
 	void ToggleDemoWindow();
 	void ToggleAboutWindow();
 	void ToggleHowToWindow();
 	std::vector<Node> GetNodesData();
 	void NotifyCallbackDeletion(const std::string& deleted_callback);
+	void NotifyCallbackAdded(const std::string& added_callback);
+	// how many nodes carry the tag, see callback_index.h
+	size_t GetCallbackUseCount(const std::string& callback);
+	// nodes carrying a filtered tag are highlighted on the canvas, or the others are faded out
+	bool IsCallbackFiltered(const std::string& callback);
+	void ToggleCallbackFilter(const std::string& callback);
+	void ClearCallbackFilter();
+	bool& CallbackFilterFadesOthers();
 	void ShowNewFilePopup();
 	void SetState(const State& new_state);
+	void SetState(State&& new_state);
 	void RequestNotification(const char* title, const char* description);
+	// false while the previous save is still being written, or while a load is running
+	bool SaveStateInBackground(const std::string& path);
+	// replaces the conversation with the file's, nodes nearest the root first; failures are reported by the editor
+	void LoadStateInBackground(const std::string& path);
+	bool IsLoading();
+	// whether the shown conversation differs from its file, by content hash (state_hash.h), so undoing an edit clears it
+	bool HasUnsavedChanges();
+	const std::string& GetDocumentPath(); // empty for a conversation that was never saved
+	// the file the conversation belongs to from now on, its journal is kept next to it
+	void SetDocumentPath(const std::string& path);
+	// listeners must outlive their registration
+	void AddStateListener(StateListener* listener);
+	void RemoveStateListener(StateListener* listener);
+	// centers the canvas on the node and selects it
+	void FocusNode(int node_id);
+	// selects the link and pans the canvas to the node it ends at
+	void FocusLink(int link_id);
+	// last validation of the shown conversation, see background_validation.h. Null until there's one
+	std::shared_ptr<const ValidationReport> GetValidationReport();
+	bool IsValidationPending(); // the report may not include the latest edits yet
+	void ToggleIssuesWindow();
+	// nodes whose text contains query, ignoring case, see text_search.h. Valid until the next call
+	const SearchResult& SearchNodes(const std::string& query);
+	void OpenSearchWindow();
+	// arranges the nodes in layers from node 0, see graph_layout.h
+	void AutoLayout();
+	// Starts or stops spreading the nodes out with forces, see force_layout.h. Pinned and selected nodes stay where they are
+	void ToggleForceLayout();
+	bool IsForceLayoutRunning();
+	void TogglePinSelectedNodes();
+	void UnpinAllNodes();
+	bool HasPinnedNodes();
+
+	// projects, see project.h. Project conversations open next to the standalone one, each in its own tab
+	bool CreateProject(const std::string& path);
+	bool OpenProject(const std::string& path);
+	bool CloseProject(); // edited conversations are saved first, the project stays open if one can't be
+	const Project& GetProject();
+	bool AddConversationToProject(const std::string& path);
+	bool OpenConversation(const std::string& path);
+	bool IsConversationOpen(const std::string& path);
+	void ToggleProjectWindow();
 } // namespace storyteller
\ No newline at end of file